@@ -0,0 +1,37 @@
+/**
+ * @file 	BlockProcessing.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Block processing API of the node (time_stamper_master.c) and the hooks a sample I/O backend supplies
+ *
+ * The node itself has no CSL/BSL dependency. A backend moves codec frames in and out and calls process() on them:
+ *  - SampleIODsk.c			McBSP per sample interrupt or EDMA ping-pong blocks on the DSK6713
+ *  - host/SampleIOHost.c	raw files or memory buffers on a Linux host
+ * The backend also runs nodeBackgroundTask() whenever it is idle, in place of the old main loop.
+ */
+
+#ifndef BLOCKPROCESSING_H_
+#define BLOCKPROCESSING_H_
+
+#include <stddef.h>
+
+//TI C6000 keyword, empty on other compilers so the node builds on a host
+#ifndef _TMS320C6X
+#define far
+#endif
+
+//one codec frame is a sample of each channel, in the order of the 32 bit McBSP word
+#define FRAME_CHANNELS 2
+
+//Node functions
+void nodeInit();
+void nodeBackgroundTask();
+void process(const short* in, short* out, size_t frames);
+
+//Backend hooks, state indicators (LEDs and debug GPIO pins on the DSK)
+void indicatorLedOn(short led);
+void indicatorLedOff(short led);
+void ToggleDebugGPIO(short IONum);
+
+
+#endif /* BLOCKPROCESSING_H_ */
@@ -0,0 +1,77 @@
+/**
+ * @file 	CarrierNco.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Numerically controlled oscillator for the downmix and the searching correlation at any carrier
+ *
+ * The fs/4 paths get by without multiplies because the carrier only takes the values 1, 0, -1, 0. At any other
+ * carrier the received samples are mixed down with the table oscillator, one table read and two multiplies per
+ * sample. The carrier phase of the matched filter peak then gives the pulse centre modulo one carrier period
+ * instead of modulo four samples.
+ */
+
+#include <math.h>
+
+#include "CarrierNco.h"
+
+#define NCO_PI 3.14159265358979323846
+
+float ncoCosTable[NCO_TABLE_LEN];
+static short ncoTableReady = 0;
+
+/**
+ * Sets the carrier and starts the phase at 0, fills the shared table on the first call
+ * @param carrierFreq	carrier frequency in cycles per sample (e.g. 0.25 CBW), below 0.5
+ */
+void ncoInit(CarrierNco* nco, double carrierFreq){
+	int idx;
+
+	if(!ncoTableReady){
+		for(idx = 0; idx < NCO_TABLE_LEN; idx++)
+			ncoCosTable[idx] = (float) cos(2*NCO_PI*idx/NCO_TABLE_LEN);
+		ncoTableReady = 1;
+	}
+	nco->phase = 0;
+	nco->step = (unsigned int)(carrierFreq*4294967296.0 + 0.5);
+}
+
+/**
+ * Mixes a buffer down to baseband, the first sample is carrier phase 0 whatever the phase of the oscillator.
+ * dmCos[k] + j*dmSin[k] = receiveBuf[k]*exp(j*2*pi*f*k), the same signs as the fs/4 downmix.
+ * @param receiveBuf	The receive buffer which contains the received modulated signal (e.g. recbuf)
+ * @param dmCos			In-phase baseband buffer to receive into
+ * @param dmSin			Quadrature baseband buffer
+ * @param len			Size of the buffers (typically 2N+2M)
+ */
+void ncoDownmix(const CarrierNco* nco, const float* receiveBuf, float* dmCos, float* dmSin, short len){
+	unsigned int phase = 0;
+	short idx;
+
+	for(idx = 0; idx < len; idx++){
+		dmCos[idx] = receiveBuf[idx]*NCO_COS(phase);
+		dmSin[idx] = receiveBuf[idx]*NCO_SIN(phase);
+		phase += nco->step;
+	}
+}
+
+/**
+ * Carrier period in samples (4 at fs/4)
+ */
+float ncoCarrierPeriod(const CarrierNco* nco){
+	return (float)(4294967296.0/nco->step);
+}
+
+/**
+ * Pulse centre from its carrier phase. The phase only knows the centre modulo a carrier period, the magnitude peak
+ * picks the period, so it has to be within half a period of the centre.
+ * @param phaseCentre	centre from the carrier phase, known modulo period (phase in cycles times period)
+ * @param coarseCentre	centre from the correlation magnitude peak
+ * @param period		carrier period in samples
+ * @return the centre within half a period of coarseCentre
+ */
+float ncoNearestCentre(float phaseCentre, float coarseCentre, float period){
+	float offset = phaseCentre - coarseCentre;
+
+	offset -= period*(float) floor(offset/period + 0.5f);
+	return coarseCentre + offset;
+}
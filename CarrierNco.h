@@ -0,0 +1,48 @@
+/**
+ * @file 	CarrierNco.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the numerically controlled oscillator in CarrierNco.c
+ *
+ * The carrier phase is a 32 bit accumulator, a full cycle is 2^32 and it wraps by itself. The top NCO_TABLE_LOG2 bits
+ * (rounded) index a cosine table, the sine is the same table a quarter cycle back. Any carrier below fs/2 can be set,
+ * the step is rounded to 2^-32 cycles per sample.
+ */
+
+#ifndef CARRIERNCO_H_
+#define CARRIERNCO_H_
+
+#define NCO_TABLE_LOG2		10
+#define NCO_TABLE_LEN		(1<<NCO_TABLE_LOG2)				// 1024, 0.35 degree steps
+#define NCO_PHASE_SHIFT		(32-NCO_TABLE_LOG2)
+#define NCO_PHASE_ROUND		(1u<<(NCO_PHASE_SHIFT-1))		// nearest table entry instead of the one below
+#define NCO_QUARTER_CYCLE	(1u<<30)
+
+//A searching correlation over an M sample window only triggers on its own carrier if the metric is at least this
+//share of M times the energy in the window: about 0.5 for a pulse on the carrier, 1/M for noise, and under 0.04 for
+//the onset and the sidelobes of a pulse on a carrier 0.06 or more away. A pulse on the carrier gets there some 12
+//samples after its onset, well inside the capture lead.
+#define NCO_COHERENCE		0.1f
+
+#define NCO_COS(phase)		ncoCosTable[((unsigned int)((phase) + NCO_PHASE_ROUND)) >> NCO_PHASE_SHIFT]
+#define NCO_SIN(phase)		NCO_COS((phase) - NCO_QUARTER_CYCLE)	// sin(x) = cos(x - pi/2)
+
+typedef struct {
+	unsigned int phase;		// carrier phase of the next sample, 2^32 per cycle
+	unsigned int step;		// phase advance per sample, carrier frequency (cycles/sample) times 2^32
+} CarrierNco;
+
+extern float ncoCosTable[NCO_TABLE_LEN];
+
+//Setup Functions
+void ncoInit(CarrierNco* nco, double carrierFreq);
+
+//Mixing functions
+void ncoDownmix(const CarrierNco* nco, const float* receiveBuf, float* dmCos, float* dmSin, short len);
+
+//Phase helpers
+float ncoCarrierPeriod(const CarrierNco* nco);
+float ncoNearestCentre(float phaseCentre, float coarseCentre, float period);
+
+
+#endif /* CARRIERNCO_H_ */
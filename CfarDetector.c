@@ -0,0 +1,102 @@
+/**
+ * @file 	CfarDetector.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Constant false alarm rate threshold for the searching correlation
+ *
+ * The fixed T1 is only right for one noise level: in a louder room the noise metric alone crosses it and every false
+ * trigger costs a 2N+2M capture and a matched filter pass, in a quiet one it wastes sensitivity. Here the threshold
+ * follows the noise floor of the metric instead. The floor is a running mean over the samples under the threshold,
+ * so pulses stay out of it, even several at once on all channels of the correlator bank. The samples right after the
+ * search window was cleared are left out too, the metric only builds up again over them.
+ *
+ * Each trigger is checked once the capture is in: the main loop runs the matched filter and cfarValidate() counts the
+ * capture as a pulse or as a false trigger, by its SNR. A floor that is too high comes down by itself, one that is too
+ * low (the noise stepped up) only shows as false triggers, so a run of them raises it.
+ */
+
+#include <math.h>
+
+#include "CfarDetector.h"
+
+/**
+ * Starts without a floor, nothing triggers until the detector has seen a full window of samples
+ * @param falseAlarm	probability that the noise metric of one sample crosses the threshold (e.g. CFAR_FALSE_ALARM)
+ * @param window		search window in samples (M)
+ */
+void cfarInit(CfarDetector* cfar, float falseAlarm, short window){
+	cfar->floor = 0;
+	cfar->threshold = CFAR_NO_THRESHOLD;
+	cfar->scale = (float) -log(falseAlarm);
+	cfar->count = 0;
+	cfar->window = window;
+	cfar->warmup = window;		// the search window starts out empty
+	cfar->triggers = 0;
+	cfar->validated = 0;
+	cfar->rejected = 0;
+	cfar->rejectRun = 0;
+	cfar->raisePending = 0;
+}
+
+/**
+ * Compares the metric of one searched sample to the threshold, then takes it into the floor
+ * @return 1 if the metric is over the threshold
+ */
+short cfarTest(CfarDetector* cfar, float metric){
+	short hit = (metric > cfar->threshold);
+
+	cfarUpdate(cfar, metric);
+	return hit;
+}
+
+/**
+ * Takes the metric of one searched sample into the floor and sets the threshold from it
+ */
+void cfarUpdate(CfarDetector* cfar, float metric){
+	if(cfar->raisePending){
+		cfar->floor *= CFAR_RAISE;
+		cfar->raisePending = 0;
+	}
+	else if(cfar->warmup > 0){
+		cfar->warmup--;
+		return;
+	}
+	else if(metric <= cfar->threshold){
+		// plain mean over the first samples, so the floor is there after a window and not after CFAR_FLOOR_SAMPLES
+		if(cfar->count < CFAR_FLOOR_SAMPLES)
+			cfar->count++;
+		cfar->floor += (metric - cfar->floor)/cfar->count;
+	}
+	if(cfar->count >= cfar->window){
+		cfar->threshold = cfar->floor*cfar->scale;
+		if(cfar->threshold < CFAR_MIN_THRESHOLD)
+			cfar->threshold = CFAR_MIN_THRESHOLD;
+	}
+}
+
+/**
+ * The search window was cleared (a recording started), the floor waits until it is full again. The threshold stays.
+ */
+void cfarRestart(CfarDetector* cfar){
+	cfar->warmup = cfar->window;
+}
+
+/**
+ * Counts an analysed capture as a pulse or a false trigger, CFAR_REJECT_RUN false triggers in a row raise the floor
+ * @param snr	SNR of the capture, estimateCaptureSnr()
+ * @return 1 if it holds a pulse
+ */
+short cfarValidate(CfarDetector* cfar, float snr){
+	if(snr >= CFAR_VALID_SNR){
+		cfar->validated++;
+		cfar->rejectRun = 0;
+		return 1;
+	}
+	cfar->rejected++;
+	cfar->rejectRun++;
+	if(cfar->rejectRun >= CFAR_REJECT_RUN){
+		cfar->raisePending = 1;
+		cfar->rejectRun = 0;
+	}
+	return 0;
+}
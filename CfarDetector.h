@@ -0,0 +1,56 @@
+/**
+ * @file 	CfarDetector.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the constant false alarm rate search threshold in CfarDetector.c
+ *
+ * With noise alone the in-phase and quadrature search sums are Gaussian, so the incoherent metric is exponential
+ * with its mean as the only parameter: P(metric > T) = exp(-T/mean). The detector keeps a running mean of the
+ * metric (the noise floor) and sets the threshold to floor*ln(1/falseAlarm). Samples over the threshold stay out of
+ * the mean, a run of rejected captures raises it instead.
+ */
+
+#ifndef CFARDETECTOR_H_
+#define CFARDETECTOR_H_
+
+#ifndef CFAR_FALSE_ALARM
+#define CFAR_FALSE_ALARM	1e-6f		// per searched sample. The metric is correlated over the window, so there are
+										// fewer false triggers than that times the sample rate.
+#endif
+#define CFAR_FLOOR_SAMPLES	1024		// length of the running mean, 0.13 s at 8 kHz
+#define CFAR_MIN_THRESHOLD	1000.0f		// never below this, a codec putting out digital silence has no noise floor
+#define CFAR_NO_THRESHOLD	1e30f		// before the floor has seen a window of samples
+#define CFAR_REJECT_RUN		3			// rejected captures in a row that raise the floor
+#define CFAR_RAISE			2.0f		// by this factor
+#ifndef CFAR_VALID_SNR
+#define CFAR_VALID_SNR		100.0f		// capture SNR (estimateCaptureSnr()) a real pulse has. The best of the 2M
+										// lags of a noise capture is around 10.
+#endif
+
+typedef struct {
+	float floor;				// running mean of the metric without pulses
+	float threshold;			// floor*scale, at least CFAR_MIN_THRESHOLD
+	float scale;				// ln(1/falseAlarm)
+	unsigned short count;		// samples in the floor, counts up to CFAR_FLOOR_SAMPLES
+	short window;				// search window in samples (M)
+	short warmup;				// samples until the search window is full again after it was cleared
+	unsigned long triggers;		// recordings started, counted by the frame code
+	unsigned long validated;	// captures the matched filter found a pulse in, counted by the main loop
+	unsigned long rejected;		// captures without one
+	short rejectRun;			// rejected captures since the last validated one, main loop only
+	volatile short raisePending;	// set by the main loop, the frame code raises the floor and clears it
+} CfarDetector;
+
+//Setup Functions
+void cfarInit(CfarDetector* cfar, float falseAlarm, short window);
+
+//Searching, frame code
+short cfarTest(CfarDetector* cfar, float metric);
+void cfarUpdate(CfarDetector* cfar, float metric);
+void cfarRestart(CfarDetector* cfar);
+
+//Validation, main loop
+short cfarValidate(CfarDetector* cfar, float snr);
+
+
+#endif /* CFARDETECTOR_H_ */
@@ -0,0 +1,136 @@
+/**
+ * @file 	ClockTracker.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Two state Kalman filter for the slave clock offset and skew
+ *
+ * Replaces taking the newest fine delay estimate at face value. The offset is predicted across the gap since the last
+ * exchange from the skew the clock has not been compensated for, each measurement is weighted by its variance
+ * (TRACKER_R_SNR1/SNR + TRACKER_R_FLOOR) and measurements outside the innovation gate are dropped. With the skew
+ * taken out of the clock between exchanges, the exchanges can be far apart without the offset walking away.
+ */
+
+#include <math.h>
+
+#include "ClockTracker.h"
+
+/**
+ * Forgets all measurements, the next update starts the tracker again
+ */
+void clockTrackerInit(ClockTracker* t){
+	t->offset = 0;
+	t->skew = 0;
+	t->skewApplied = 0;
+	t->p00 = 0;
+	t->p01 = 0;
+	t->p11 = 0;
+	t->trackLength = 0;
+	t->accepted = 0;
+	t->rejected = 0;
+	t->consecutiveRejects = 0;
+	t->lastInnovation = 0;
+	t->lastVariance = 0;
+}
+
+/**
+ * Starts from a single measurement, the skew is unknown until the next one
+ */
+static void clockTrackerStart(ClockTracker* t, float measuredOffset, float variance){
+	t->offset = measuredOffset;
+	t->skew = t->skewApplied;
+	t->p00 = variance;
+	t->p01 = 0;
+	t->p11 = TRACKER_SKEW_START*TRACKER_SKEW_START;
+	t->trackLength = 1;
+	t->consecutiveRejects = 0;
+	t->lastInnovation = 0;
+}
+
+/**
+ * Adds one exchange
+ * @param measuredOffset	master tick minus slave tick seen by this exchange, samples
+ * @param ticks				time since the previous exchange, virtual clock ticks
+ * @param snr				pulse energy over noise of the capture
+ * @return 1 if the measurement was used, 0 if it was rejected as an outlier
+ */
+short clockTrackerUpdate(ClockTracker* t, float measuredOffset, float ticks, float snr){
+	float variance, predicted, p00, p01, p11, innovation, gain0, gain1, s;
+
+	if(snr < 1.0f)
+		snr = 1.0f;
+	variance = TRACKER_R_SNR1/snr + TRACKER_R_FLOOR;
+	t->lastVariance = variance;
+
+	if(t->trackLength == 0){
+		clockTrackerStart(t, measuredOffset, variance);
+		t->accepted++;
+		return 1;
+	}
+
+	// predict: F = [1 ticks; 0 1], the compensated part of the skew no longer moves the offset
+	predicted = clockTrackerPredict(t, ticks);
+	p00 = t->p00 + ticks*(2*t->p01 + ticks*t->p11) + TRACKER_Q_OFFSET*ticks + TRACKER_Q_SKEW*ticks*ticks*ticks/3;
+	p01 = t->p01 + ticks*t->p11 + TRACKER_Q_SKEW*ticks*ticks/2;
+	p11 = t->p11 + TRACKER_Q_SKEW*ticks;
+
+	innovation = measuredOffset - predicted;
+	s = p00 + variance;
+	t->lastInnovation = innovation;
+
+	if(innovation*innovation > TRACKER_GATE*TRACKER_GATE*s){
+		t->rejected++;
+		t->consecutiveRejects++;
+		if(t->trackLength < TRACKER_MIN_TRACK || t->consecutiveRejects >= TRACKER_MAX_REJECTS)
+			clockTrackerStart(t, measuredOffset, variance);	// the track was wrong, or the clock really moved
+		else{
+			t->offset = predicted;	// keep coasting
+			t->p00 = p00;
+			t->p01 = p01;
+			t->p11 = p11;
+		}
+		return 0;
+	}
+
+	gain0 = p00/s;
+	gain1 = p01/s;
+	t->offset = predicted + gain0*innovation;
+	t->skew += gain1*innovation;
+	t->p00 = p00 - gain0*p00;
+	t->p01 = p01 - gain0*p01;
+	t->p11 = p11 - gain1*p01;
+	t->accepted++;
+	t->trackLength++;
+	t->consecutiveRejects = 0;
+	return 1;
+}
+
+/**
+ * The clock was stepped by correction samples (a longer tick for a positive correction), which takes it off the offset
+ */
+void clockTrackerCorrect(ClockTracker* t, float correction){
+	t->offset -= correction;
+}
+
+/**
+ * The clock now takes skew samples per tick out by itself, call after handing the skew to the clock
+ */
+void clockTrackerApplySkew(ClockTracker* t, float skew){
+	t->skewApplied = skew;
+}
+
+/**
+ * Offset expected after another ticks ticks without an exchange
+ */
+float clockTrackerPredict(const ClockTracker* t, float ticks){
+	return t->offset + (t->skew - t->skewApplied)*ticks;
+}
+
+/**
+ * Ticks the prediction holds up for: until the offset variance has grown by TRACKER_HORIZON_VAR through the skew
+ * uncertainty. 0 until the track has a skew.
+ */
+float clockTrackerHorizon(const ClockTracker* t){
+	if(t->trackLength < 2 || t->p11 <= 0)
+		return 0;
+	return (float) sqrt(TRACKER_HORIZON_VAR/t->p11);
+}
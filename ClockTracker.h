@@ -0,0 +1,51 @@
+/**
+ * @file 	ClockTracker.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the slave clock offset and skew Kalman filter in ClockTracker.c
+ *
+ * The state is the slave clock error against the master (offset, samples) and how fast it grows (skew, samples per
+ * virtual clock tick). Time is counted in ticks so both state variables stay well scaled in single precision.
+ * Each exchange is one offset measurement, weighted by the SNR of its correlation peak. The caller takes skew out of
+ * the clock between exchanges and applies whole sample corrections, and tells the tracker about both.
+ */
+
+#ifndef CLOCKTRACKER_H_
+#define CLOCKTRACKER_H_
+
+//Tuning, variances in samples^2
+#define TRACKER_R_SNR1			40.0f		// measurement variance at an SNR of 1, scales with 1/SNR
+#define TRACKER_R_FLOOR			0.15f		// measurement variance no SNR gets under (whole sample clock steps, pulse shape)
+#define TRACKER_Q_OFFSET		1e-4f		// offset random walk, per tick
+#define TRACKER_Q_SKEW			1e-7f		// skew random walk, (samples/tick)^2 per tick
+#define TRACKER_SKEW_START		0.4f		// skew standard deviation before the second exchange (100 ppm of 4096)
+#define TRACKER_GATE			4.0f		// innovations past this many standard deviations are outliers
+#define TRACKER_MAX_REJECTS		3			// consecutive outliers after which the tracker restarts from the last one
+#define TRACKER_MIN_TRACK		3			// a track shorter than this restarts at an outlier instead of coasting past it
+#define TRACKER_HORIZON_VAR		0.05f		// offset variance the prediction may grow to before the next exchange
+
+typedef struct {
+	float offset;			// master tick minus slave tick, samples
+	float skew;				// offset change per tick, samples
+	float skewApplied;		// skew the caller takes out of the clock, the prediction only sees the rest
+	float p00, p01, p11;	// covariance of (offset, skew)
+	short trackLength;		// measurements since the tracker (re)started
+	unsigned short accepted;
+	unsigned short rejected;
+	unsigned short consecutiveRejects;
+	float lastInnovation;
+	float lastVariance;		// measurement variance of the last update
+} ClockTracker;
+
+//Setup Functions
+void clockTrackerInit(ClockTracker* t);
+
+//Tracking functions
+short clockTrackerUpdate(ClockTracker* t, float measuredOffset, float ticks, float snr);
+void clockTrackerCorrect(ClockTracker* t, float correction);
+void clockTrackerApplySkew(ClockTracker* t, float skew);
+float clockTrackerPredict(const ClockTracker* t, float ticks);
+float clockTrackerHorizon(const ClockTracker* t);
+
+
+#endif /* CLOCKTRACKER_H_ */
@@ -0,0 +1,232 @@
+/**
+ * @file 	CorrelatorBank.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Frequency division search bank: the sliding searching correlation on FDM_CHANNELS carriers at once
+ *
+ * Every sample is mixed down on each channel's carrier and kept in the channel's sliding sums, as in the
+ * USE_NCO_DOWNMIX detector. The channels share the sample, so one pass over the channel arrays does it, with no table
+ * reads and no branches.
+ *
+ * A pulse on one carrier crosses T1 on every channel: the abrupt onset of the truncated sinc is broadband for as long
+ * as it is in the window, and after that its neighbours still see a little of it. So a channel only counts as hit
+ * while its metric is not far below the strongest channel's, and only once it has held that for longer than a
+ * window. The onset then has no say, and a pulse on the channel itself is detected a confirm time after its onset.
+ */
+
+#include <math.h>
+
+#include "CarrierNco.h"
+#include "CorrelatorBank.h"
+
+#define FDM_PI 3.14159265358979323846
+
+/**
+ * Carrier of a channel, the channels are centred on centre
+ * @param centre	centre of the band in cycles per sample (e.g. 0.25 CBW)
+ * @param channel	0 to FDM_CHANNELS-1
+ */
+double fdmChannelCarrier(double centre, short channel){
+	return centre + (channel - (FDM_CHANNELS-1)/2.0)*FDM_CHANNEL_SPACING;
+}
+
+/**
+ * Sets up the channels and clears the sums
+ * @param centre	centre of the band, see fdmChannelCarrier()
+ * @param mixedCos	window*FDM_CHANNELS floats for the in-phase mixed samples
+ * @param mixedSin	same for the quadrature ones
+ * @param window	searching window in samples (M)
+ * @param confirm	samples a channel has to hold its hit, more than window
+ */
+void fdmSearchInit(FdmSearchBank* bank, double centre, float* mixedCos, float* mixedSin, short window, short confirm){
+	CarrierNco nco;
+	double carrier;
+	short k;
+
+	bank->mixedCos = mixedCos;
+	bank->mixedSin = mixedSin;
+	bank->window = window;
+	bank->confirm = confirm;
+	bank->pos = 0;
+	for(k = 0; k < FDM_CHANNELS; k++){
+		carrier = fdmChannelCarrier(centre, k);
+		ncoInit(&nco, carrier);		// also fills the table the phasors are resynced from
+		bank->phase[k] = 0;
+		bank->step[k] = nco.step;
+		bank->carrierCos[k] = 1;
+		bank->carrierSin[k] = 0;
+		bank->rotateCos[k] = (float) cos(2*FDM_PI*carrier);
+		bank->rotateSin[k] = (float) sin(2*FDM_PI*carrier);
+		fdmSearchClearChannel(bank, k);
+	}
+}
+
+/**
+ * Forgets all channel statistics
+ */
+void fdmChannelInit(FdmChannel channels[FDM_CHANNELS]){
+	short k, h;
+
+	for(k = 0; k < FDM_CHANNELS; k++){
+		channels[k].state = 0;
+		channels[k].index = 0;
+		channels[k].startClock = 0;
+		channels[k].waitCount = 0;
+		channels[k].reply = FDM_REPLY_PENDING;
+		channels[k].pulses = 0;
+		channels[k].replies = 0;
+		channels[k].silent = 0;
+		channels[k].late = 0;
+		for(h = 0; h < FDM_HISTORY; h++){
+			channels[k].arrival[h] = 0;
+			channels[k].snr[h] = 0;
+		}
+		channels[k].historyIndex = FDM_HISTORY-1;
+		channels[k].historyCount = 0;
+	}
+}
+
+/**
+ * Runs the searching correlation of every channel on one sample
+ * @param threshold		detection threshold on sumCos^2 + sumSin^2 (T1)
+ * @return bit k set if channel k has held a hit for the confirm time
+ */
+unsigned int fdmSearchSample(FdmSearchBank* bank, float sample, float threshold){
+	float* ringCos = bank->mixedCos + bank->pos*FDM_CHANNELS;
+	float* ringSin = bank->mixedSin + bank->pos*FDM_CHANNELS;
+	float mixedCos[FDM_CHANNELS], mixedSin[FDM_CHANNELS], c;
+	float strongest = 0;
+	unsigned int hits = 0;
+	short k;
+
+	// the ring can not alias the bank, but the compiler can not tell: mix through locals so the channel loops
+	// vectorize
+	for(k = 0; k < FDM_CHANNELS; k++){
+		mixedCos[k] = sample*bank->carrierCos[k];
+		mixedSin[k] = sample*bank->carrierSin[k];
+		c = bank->carrierCos[k];
+		bank->carrierCos[k] = c*bank->rotateCos[k] - bank->carrierSin[k]*bank->rotateSin[k];
+		bank->carrierSin[k] = bank->carrierSin[k]*bank->rotateCos[k] + c*bank->rotateSin[k];
+		bank->sumCos[k] += mixedCos[k];
+		bank->sumSin[k] += mixedSin[k];
+		bank->freshCos[k] += mixedCos[k];
+		bank->freshSin[k] += mixedSin[k];
+	}
+	for(k = 0; k < FDM_CHANNELS; k++){
+		bank->sumCos[k] -= ringCos[k];
+		bank->sumSin[k] -= ringSin[k];
+		ringCos[k] = mixedCos[k];
+		ringSin[k] = mixedSin[k];
+	}
+	for(k = 0; k < FDM_CHANNELS; k++)
+		bank->metric[k] = bank->sumCos[k]*bank->sumCos[k] + bank->sumSin[k]*bank->sumSin[k];
+
+	bank->pos++;
+	if(bank->pos >= bank->window){
+		bank->pos = 0;
+		// renormalize the sums like the sliding detector, and put the phasors back on the exact phase
+		for(k = 0; k < FDM_CHANNELS; k++){
+			bank->sumCos[k] = bank->freshCos[k];
+			bank->sumSin[k] = bank->freshSin[k];
+			bank->freshCos[k] = 0;
+			bank->freshSin[k] = 0;
+			bank->phase[k] += bank->step[k]*(unsigned int) bank->window;
+			bank->carrierCos[k] = NCO_COS(bank->phase[k]);
+			bank->carrierSin[k] = NCO_SIN(bank->phase[k]);
+		}
+	}
+
+	for(k = 0; k < FDM_CHANNELS; k++){
+		if(bank->metric[k] > strongest)
+			strongest = bank->metric[k];
+	}
+	for(k = 0; k < FDM_CHANNELS; k++){
+		if(bank->metric[k] > threshold && bank->metric[k] >= FDM_REJECT*strongest){
+			if(bank->held[k] < bank->confirm)
+				bank->held[k]++;
+			else
+				hits |= 1u<<k;
+		}
+		else
+			bank->held[k] = 0;
+	}
+	return hits;
+}
+
+/**
+ * Noise metric of one channel for an adaptive threshold (CfarDetector.c): FDM_CHANNELS times the smallest channel
+ * metric. With noise alone the channel metrics are independent exponentials with the same mean, their minimum has
+ * 1/FDM_CHANNELS of it. Unlike the mean over the channels it hardly moves while a pulse is on some of them.
+ */
+float fdmNoiseMetric(const FdmSearchBank* bank){
+	float weakest = bank->metric[0];
+	short k;
+
+	for(k = 1; k < FDM_CHANNELS; k++){
+		if(bank->metric[k] < weakest)
+			weakest = bank->metric[k];
+	}
+	return FDM_CHANNELS*weakest;
+}
+
+/**
+ * Clears one channel's window after it triggered, so it does not trigger again on the same pulse. The other
+ * channels keep searching.
+ */
+void fdmSearchClearChannel(FdmSearchBank* bank, short channel){
+	short pos;
+
+	for(pos = 0; pos < bank->window; pos++){
+		bank->mixedCos[pos*FDM_CHANNELS + channel] = 0;
+		bank->mixedSin[pos*FDM_CHANNELS + channel] = 0;
+	}
+	bank->sumCos[channel] = 0;
+	bank->sumSin[channel] = 0;
+	bank->freshCos[channel] = 0;
+	bank->freshSin[channel] = 0;
+	bank->metric[channel] = 0;
+	bank->held[channel] = 0;
+}
+
+/**
+ * Adds the arrival of one pulse to its channel
+ * @param arrival	pulse centre minus the nearest master tick, samples
+ */
+void fdmRecordArrival(FdmChannel* channel, float arrival, float snr){
+	channel->historyIndex++;
+	if(channel->historyIndex >= FDM_HISTORY)
+		channel->historyIndex = 0;
+	channel->arrival[channel->historyIndex] = arrival;
+	channel->snr[channel->historyIndex] = snr;
+	if(channel->historyCount < FDM_HISTORY)
+		channel->historyCount++;
+	channel->pulses++;
+}
+
+/**
+ * Standard deviation of the newest arrivals of a channel, like tdmaArrivalSpread()
+ * @param count		arrivals to use, at most FDM_HISTORY
+ * @return 0 with fewer than two arrivals
+ */
+float fdmArrivalSpread(const FdmChannel* channel, short count){
+	float mean = 0, var = 0, d;
+	short h, idx;
+
+	if(count > channel->historyCount)
+		count = channel->historyCount;
+	if(count < 2)
+		return 0;
+	idx = channel->historyIndex;
+	for(h = 0; h < count; h++){
+		mean += channel->arrival[idx];
+		idx = idx ? idx-1 : FDM_HISTORY-1;
+	}
+	mean /= count;
+	idx = channel->historyIndex;
+	for(h = 0; h < count; h++){
+		d = channel->arrival[idx] - mean;
+		var += d*d;
+		idx = idx ? idx-1 : FDM_HISTORY-1;
+	}
+	return (float) sqrt(var/(count - 1));
+}
@@ -0,0 +1,88 @@
+/**
+ * @file 	CorrelatorBank.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the frequency division search bank and the per channel reply history of CorrelatorBank.c
+ *
+ * FDM_CHANNELS carriers FDM_CHANNEL_SPACING apart, centred on CBW. Slave k sends on channel k. The master searches
+ * every channel on each sample and captures, estimates and replies for each channel on its own. The spacing is 3/M, so
+ * a neighbouring carrier sits on a null of the M sample search window, and it is well outside the 0.0125 wide pulse.
+ */
+
+#ifndef CORRELATORBANK_H_
+#define CORRELATORBANK_H_
+
+#ifndef FDM_CHANNELS
+#define FDM_CHANNELS		4		// carriers searched at once, at most 32
+#endif
+#define FDM_CHANNEL_SPACING	0.05	// cycles/sample, 3/M for M 60
+#define FDM_REJECT			0.05f	// a hit needs this fraction of the strongest channel's metric, a neighbour
+									// leaks in at 0.008 at most once the pulse onset has left the window
+#define FDM_HISTORY			16		// arrivals kept per channel
+
+//Reply of a channel's newest capture, set by the main loop once the capture is analysed
+#define FDM_REPLY_PENDING	0		// not analysed yet
+#define FDM_REPLY_READY		1		// the reply is in place
+#define FDM_REPLY_SILENT	2		// too weak to reply to
+
+/**
+ * The sliding search sums of all channels, struct of arrays so the per sample loop over the channels vectorizes.
+ * Each channel's carrier is a phasor rotated once per sample, the phase accumulators resync it once per pass over
+ * the window so its rounding never builds up.
+ */
+typedef struct {
+	float carrierCos[FDM_CHANNELS];		// carrier phasor of the next sample
+	float carrierSin[FDM_CHANNELS];
+	float rotateCos[FDM_CHANNELS];		// one sample rotation
+	float rotateSin[FDM_CHANNELS];
+	unsigned int phase[FDM_CHANNELS];	// exact phase at the start of the current pass, 2^32 per cycle
+	unsigned int step[FDM_CHANNELS];	// phase advance per sample
+	float sumCos[FDM_CHANNELS];			// correlation over the last window samples
+	float sumSin[FDM_CHANNELS];
+	float freshCos[FDM_CHANNELS];		// sums rebuilt over the current pass, like corrFreshCosine
+	float freshSin[FDM_CHANNELS];
+	float metric[FDM_CHANNELS];			// sumCos^2 + sumSin^2
+	short held[FDM_CHANNELS];			// samples the channel has been over the threshold and not rejected
+	float* mixedCos;					// window*FDM_CHANNELS mixed samples, sample major
+	float* mixedSin;
+	short window;
+	short confirm;						// samples a hit has to be held for
+	short pos;							// ring position of the next sample
+} FdmSearchBank;
+
+/**
+ * One channel at the master. The frame code runs its state, index and reply timing and counts the late replies, the
+ * main loop fills in the reply and the rest of the statistics.
+ */
+typedef struct {
+	short state;				// STATE_* of the channel's own capture and reply
+	short index;				// next capture sample, then next reply sample
+	short startClock;			// vclock_counter at the first capture sample, like recbuf_start_clock
+	short waitCount;			// reply timing, counted like wait_count
+	volatile short reply;		// FDM_REPLY_*, the frame code sets it back to pending for each new capture
+	unsigned short pulses;		// captures analysed
+	unsigned short replies;		// replies sent
+	unsigned short silent;		// captures too weak to reply to, mostly another channel's pulse
+	unsigned short late;		// the reply was not ready in time
+	float arrival[FDM_HISTORY];	// pulse centre minus the nearest tick, samples
+	float snr[FDM_HISTORY];		// SNR of the capture behind each arrival
+	short historyIndex;			// newest entry
+	short historyCount;
+} FdmChannel;
+
+//Setup Functions
+double fdmChannelCarrier(double centre, short channel);
+void fdmSearchInit(FdmSearchBank* bank, double centre, float* mixedCos, float* mixedSin, short window, short confirm);
+void fdmChannelInit(FdmChannel channels[FDM_CHANNELS]);
+
+//Searching
+unsigned int fdmSearchSample(FdmSearchBank* bank, float sample, float threshold);
+void fdmSearchClearChannel(FdmSearchBank* bank, short channel);
+float fdmNoiseMetric(const FdmSearchBank* bank);
+
+//Channel history
+void fdmRecordArrival(FdmChannel* channel, float arrival, float snr);
+float fdmArrivalSpread(const FdmChannel* channel, short count);
+
+
+#endif /* CORRELATORBANK_H_ */
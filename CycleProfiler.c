@@ -0,0 +1,119 @@
+/**
+ * @file 	CycleProfiler.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Per region min/max/mean and log2 histograms of execution time
+ *
+ * Replaces scope measurements through ToggleDebugGPIO() and the hand measured CALC_TIME. profileRecord() is cheap
+ * enough to run in the sample interrupt: a few compares for the histogram bin and no division. The mean and the
+ * conversion to microseconds are left to the read out.
+ */
+
+#include <stdio.h>
+
+#include "CycleProfiler.h"
+
+ProfileRegion profileTable[PROFILE_REGIONS];
+
+static const char* profileNames[PROFILE_REGIONS] = {
+	"searching",
+	"recording",
+	"calculation",
+	"transmit",
+	"sendsinc",
+	"clk sinc",
+	"background capture",
+	"frame",
+	"isr",
+	"timing analysis",
+	"pulse mix"
+};
+
+/**
+ * floor(log2(ticks)), 0 for 0 and 1
+ */
+static short profileBin(profile_tick_t ticks){
+	short bin = 0;
+
+	if(ticks >= (1u<<16)){ ticks >>= 16; bin += 16; }
+	if(ticks >= (1u<<8)){ ticks >>= 8; bin += 8; }
+	if(ticks >= (1u<<4)){ ticks >>= 4; bin += 4; }
+	if(ticks >= (1u<<2)){ ticks >>= 2; bin += 2; }
+	if(ticks >= (1u<<1)){ bin += 1; }
+	return bin;
+}
+
+/**
+ * Adds one timed run of a region
+ * @param region	PROFILE_ region number
+ * @param ticks		duration in timer ticks
+ */
+void profileRecord(short region, profile_tick_t ticks){
+	ProfileRegion* r;
+
+	if(region < 0 || region >= PROFILE_REGIONS)
+		return;
+	r = &profileTable[region];
+	if(r->count == 0 || ticks < r->min)
+		r->min = ticks;
+	if(ticks > r->max)
+		r->max = ticks;
+	r->sum += ticks;
+	r->count++;
+	r->hist[profileBin(ticks)]++;
+}
+
+void profilerReset(){
+	short region, bin;
+
+	for(region = 0; region < PROFILE_REGIONS; region++){
+		profileTable[region].count = 0;
+		profileTable[region].min = 0;
+		profileTable[region].max = 0;
+		profileTable[region].sum = 0;
+		for(bin = 0; bin < PROFILE_HIST_BINS; bin++)
+			profileTable[region].hist[bin] = 0;
+	}
+}
+
+const ProfileRegion* profilerRegion(short region){
+	if(region < 0 || region >= PROFILE_REGIONS)
+		return NULL;
+	return &profileTable[region];
+}
+
+const char* profilerRegionName(short region){
+	if(region < 0 || region >= PROFILE_REGIONS)
+		return "";
+	return profileNames[region];
+}
+
+/**
+ * Prints the table with the worst case against the sample budget, and the histogram of every region that ran.
+ * printf wrecks the real-time operation, so only call it once the sample I/O is stopped.
+ */
+void profilerReport(){
+	double usPerTick = 1e6 / profilerTimerHz();
+	const ProfileRegion* r;
+	short region, bin;
+
+	printf("region                  count     min us    mean us     max us  max %% of %d us\n", PROFILE_SAMPLE_US);
+	for(region = 0; region < PROFILE_REGIONS; region++){
+		r = &profileTable[region];
+		if(r->count == 0)
+			continue;
+		printf("%-18s %10lu %10.3f %10.3f %10.3f  %6.1f\n", profileNames[region], r->count, r->min*usPerTick,
+				(double) r->sum / r->count * usPerTick, r->max*usPerTick, 100.0*r->max*usPerTick/PROFILE_SAMPLE_US);
+	}
+	for(region = 0; region < PROFILE_REGIONS; region++){
+		r = &profileTable[region];
+		if(r->count == 0)
+			continue;
+		printf("%s histogram (ticks from: count):", profileNames[region]);
+		for(bin = 0; bin < PROFILE_HIST_BINS; bin++){
+			if(r->hist[bin])
+				printf(" %lu: %lu", bin ? (1ul<<bin) : 0ul, r->hist[bin]);
+		}
+		printf("\n");
+	}
+}
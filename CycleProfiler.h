@@ -0,0 +1,71 @@
+/**
+ * @file 	CycleProfiler.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the per region timing statistics in CycleProfiler.c
+ *
+ * A region is timed with PROFILE_START(start) and PROFILE_STOP(region, start), which compile to nothing when
+ * USE_CYCLE_PROFILER is 0. The timer comes from the sample I/O backend: profilerTimerRead() and profilerTimerHz().
+ */
+
+#ifndef CYCLEPROFILER_H_
+#define CYCLEPROFILER_H_
+
+//If time the interrupt, the frame code and each state handler, one switch for the node and the backends
+#ifndef USE_CYCLE_PROFILER
+#define USE_CYCLE_PROFILER 0
+#endif
+
+#define PROFILE_HIST_BINS		32		// bin k counts durations of 2^k to 2^(k+1)-1 timer ticks, bin 0 also 0
+#define PROFILE_SAMPLE_US		125		// one sample period at 8 kHz, the budget of the frame code
+
+//Profiled regions, the state handlers are numbered like the states
+#define PROFILE_SEARCHING			0
+#define PROFILE_RECORDING			1
+#define PROFILE_CALCULATION			2
+#define PROFILE_TRANSMIT			3
+#define PROFILE_SENDSINC			4
+#define PROFILE_CLK_SINC			5	// scheduling the clock sinc, the slave starts its fine delayed pulse
+#define PROFILE_BACKGROUND_CAPTURE	6	// spare slot capture while busy (USE_PIPELINED_CAPTURE)
+#define PROFILE_FRAME				7	// processFrame, all of the node's work for one sample
+#define PROFILE_ISR					8	// the backend's interrupt, codec I/O included (one block with EDMA)
+#define PROFILE_TIMING_ANALYSIS		9	// matched filter and delay estimate in the main loop (was CALC_TIME)
+#define PROFILE_PULSE_MIX			10	// pulseSchedulerMix, every sample of the scheduled pulses
+#define PROFILE_REGIONS				11
+
+typedef unsigned int profile_tick_t;	// free running, differences are taken modulo 2^32
+
+//Statistics of one region, the table is a fixed array that can be read out with the debugger
+typedef struct {
+	unsigned long count;
+	profile_tick_t min;
+	profile_tick_t max;
+	unsigned long long sum;
+	unsigned long hist[PROFILE_HIST_BINS];
+} ProfileRegion;
+
+extern ProfileRegion profileTable[PROFILE_REGIONS];
+
+#if (USE_CYCLE_PROFILER)
+#define PROFILE_START(start)		((start) = profilerTimerRead())
+#define PROFILE_STOP(region, start)	profileRecord((region), profilerTimerRead() - (start))
+#else
+#define PROFILE_START(start)
+#define PROFILE_STOP(region, start)
+#endif
+
+//Recording functions
+void profileRecord(short region, profile_tick_t ticks);
+void profilerReset();
+
+//Read out functions
+const ProfileRegion* profilerRegion(short region);
+const char* profilerRegionName(short region);
+void profilerReport();
+
+//Backend hooks, a free running timer
+profile_tick_t profilerTimerRead();
+unsigned long profilerTimerHz();
+
+
+#endif /* CYCLEPROFILER_H_ */
@@ -11,12 +11,10 @@ ASM_SRCS += \
 
 C_SRCS += \
 ../DebugTools.c \
-../MathCalculations.c \
 ../time_stamper_master.c 
 
 OBJS += \
 ./DebugTools.obj \
-./MathCalculations.obj \
 ./time_stamper_master.obj \
 ./vectors.obj 
 
@@ -25,17 +23,14 @@ ASM_DEPS += \
 
 C_DEPS += \
 ./DebugTools.pp \
-./MathCalculations.pp \
 ./time_stamper_master.pp 
 
 C_DEPS__QUOTED += \
 "DebugTools.pp" \
-"MathCalculations.pp" \
 "time_stamper_master.pp" 
 
 OBJS__QUOTED += \
 "DebugTools.obj" \
-"MathCalculations.obj" \
 "time_stamper_master.obj" \
 "vectors.obj" 
 
@@ -44,7 +39,6 @@ ASM_DEPS__QUOTED += \
 
 C_SRCS__QUOTED += \
 "../DebugTools.c" \
-"../MathCalculations.c" \
 "../time_stamper_master.c" 
 
 ASM_SRCS__QUOTED += \
@@ -0,0 +1,82 @@
+/**
+ * @file 	EventQueue.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Wait-free single producer/single consumer ring for the frame code to main loop events
+ *
+ * head and tail run freely over the 16 bit range and are masked on use, so a full ring (head - tail == LEN) and an
+ * empty one (head == tail) need no extra flag. EVENT_QUEUE_LEN divides 65536, so the masking survives the wrap.
+ */
+
+#include "EventQueue.h"
+
+#if defined(__GNUC__)
+#define EVENT_LOAD_ACQUIRE(p)		__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define EVENT_STORE_RELEASE(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#else
+#define EVENT_LOAD_ACQUIRE(p)		(*(p))
+#define EVENT_STORE_RELEASE(p, v)	(*(p) = (v))
+#endif
+
+#define EVENT_INDEX(n) ((n)&(EVENT_QUEUE_LEN-1))
+
+#if ((EVENT_QUEUE_LEN & (EVENT_QUEUE_LEN-1)) || EVENT_QUEUE_LEN > 32768)
+#error "EVENT_QUEUE_LEN must be a power of 2 no larger than 32768"
+#endif
+
+/**
+ * Empties the ring, call before the producer starts
+ */
+void eventQueueInit(EventQueue* q){
+	q->head = 0;
+	q->tail = 0;
+	q->dropped = 0;
+}
+
+/**
+ * Adds an event, never blocks
+ * @return 1 if posted, 0 if the ring was full and the event was dropped (counted in dropped)
+ */
+short eventQueuePost(EventQueue* q, short type, short clock, int value){
+	unsigned short head = q->head;		// only this side writes head
+	volatile NodeEvent* slot;
+
+	if((unsigned short)(head - EVENT_LOAD_ACQUIRE(&q->tail)) >= EVENT_QUEUE_LEN){
+		q->dropped++;
+		return 0;
+	}
+
+	slot = &q->slots[EVENT_INDEX(head)];
+	slot->type = type;
+	slot->clock = clock;
+	slot->value = value;
+	EVENT_STORE_RELEASE(&q->head, (unsigned short)(head + 1));
+	return 1;
+}
+
+/**
+ * Takes the oldest event, never blocks
+ * @param event	filled in when an event was waiting
+ * @return 1 if an event was taken, 0 if the ring was empty
+ */
+short eventQueueTake(EventQueue* q, NodeEvent* event){
+	unsigned short tail = q->tail;		// only this side writes tail
+	volatile NodeEvent* slot;
+
+	if(EVENT_LOAD_ACQUIRE(&q->head) == tail)
+		return 0;
+
+	slot = &q->slots[EVENT_INDEX(tail)];
+	event->type = slot->type;
+	event->clock = slot->clock;
+	event->value = slot->value;
+	EVENT_STORE_RELEASE(&q->tail, (unsigned short)(tail + 1));
+	return 1;
+}
+
+/**
+ * Number of events waiting, a snapshot for the consumer
+ */
+short eventQueuePending(EventQueue* q){
+	return (short)(unsigned short)(EVENT_LOAD_ACQUIRE(&q->head) - q->tail);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file 	EventQueue.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the single producer/single consumer event ring in EventQueue.c
+ *
+ * The frame code (sample interrupt) is the only producer and the main loop the only consumer. head is written by the
+ * producer only and tail by the consumer only, so neither side ever waits or locks.
+ *
+ * Ordering: the slot has to be written before head is published, and read before tail is released.
+ *  - GCC/Clang (host builds): head and tail are accessed with __atomic acquire/release, which also holds with the
+ *    producer and consumer on different threads.
+ *  - TI C6000: one core, the interrupt and the main loop only share memory. Slots, head and tail are volatile and
+ *    the compiler keeps volatile accesses in program order, which is all a single core needs.
+ */
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#define EVENT_QUEUE_LEN 16		// power of 2, at most 32768
+
+//Event types
+#define EVENT_NONE				0
+#define EVENT_CAPTURE_READY		1	// recbuf is full: clock = vclock_counter at completion, value = sinc_launch
+									// (slave: at the start of the recording, master with USE_TDMA: superframe
+									// tick of the pulse, master with USE_FDM_BANK: channel)
+#define EVENT_TICK_WRAPPED		2	// vclock wrapped to 0: value = sinc_launch (slave), wait_count (master)
+#define EVENT_TRANSMIT_DONE		3	// pulse (slave) or reply (master) sent: clock = vclock_counter, value = playback_scale
+									// (master) or channel (master with USE_FDM_BANK)
+
+typedef struct {
+	short type;
+	short clock;		// vclock_counter or a recording clock, see the event type
+	int value;
+} NodeEvent;
+
+typedef struct {
+	volatile unsigned short head;		// next slot to write, producer only
+	volatile unsigned short tail;		// next slot to read, consumer only
+	volatile unsigned short dropped;	// events lost to a full ring, producer only
+	volatile NodeEvent slots[EVENT_QUEUE_LEN];
+} EventQueue;
+
+//Setup Functions
+void eventQueueInit(EventQueue* q);
+
+//Producer (frame code)
+short eventQueuePost(EventQueue* q, short type, short clock, int value);
+
+//Consumer (main loop)
+short eventQueueTake(EventQueue* q, NodeEvent* event);
+short eventQueuePending(EventQueue* q);
+
+
+#endif /* EVENTQUEUE_H_ */
@@ -0,0 +1,319 @@
+/**
+ * @file 	FastCorrelation.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Matched filter kernels (FFT and fused fs/4 direct form) for the received sinc pulse
+ *
+ * The direct form correlates the (2N+1) tap baseband sinc against the in-phase and quadrature downmixed buffers
+ * at every one of the 2M lags. Here the two downmixed buffers are packed as one complex signal (I + jQ), so a single
+ * complex FFT, a multiply with the cached conjugate spectrum of the sinc, and one inverse FFT give corr_c (real part)
+ * and corr_s (imaginary part) for all lags at once. With 2N+2M = 1144 samples a single 2048 point overlap-save
+ * segment covers every lag without circular wrap-around, so only the first numLags outputs are kept.
+ *
+ * The quarter wave variants read the recording buffer directly. At the fs/4 carrier the downmix multiplies by
+ * (1,0,-1,0) for the in-phase branch and (0,1,0,-1) for the quadrature branch, so every received sample feeds
+ * exactly one branch and the downMixedCosine/downMixedSine buffers are not needed.
+ */
+
+#include "FastCorrelation.h"
+#include <math.h>
+
+#define FFT_PI 3.14159265358979323846
+
+static float fftTwiddle[FFT_CORR_LEN];				// cos/sin pairs for the first half circle
+static float refSpectrum[2*FFT_CORR_LEN];			// conj(FFT(reference))/FFT_CORR_LEN, interleaved re/im
+static float corrWork[2*FFT_CORR_LEN];				// interleaved re/im working buffer
+
+/**
+ * Fills the twiddle table for the forward transform
+ */
+static void setupFftTwiddles(){
+	int idx;
+	double angle;
+	for (idx=0;idx<(FFT_CORR_LEN>>1);idx++){
+		angle = -2*FFT_PI*idx/FFT_CORR_LEN;
+		fftTwiddle[2*idx] = (float) cos(angle);
+		fftTwiddle[2*idx+1] = (float) sin(angle);
+	}
+}
+
+/**
+ * Radix-2 decimation in time FFT of FFT_CORR_LEN complex points, in place.
+ * @param data		interleaved re/im buffer of 2*FFT_CORR_LEN floats
+ * @param inverse	non-zero for the (unscaled) inverse transform
+ */
+void fftComplexInPlace(float* data, short inverse){
+	int idx, rev, bit, span, step, start, pos, tw;
+	float tr, ti, wr, wi;
+
+	//bit reversal permutation
+	rev = 0;
+	for (idx=0;idx<FFT_CORR_LEN-1;idx++){
+		if (idx<rev){
+			tr = data[2*idx];	data[2*idx] = data[2*rev];		data[2*rev] = tr;
+			ti = data[2*idx+1];	data[2*idx+1] = data[2*rev+1];	data[2*rev+1] = ti;
+		}
+		bit = FFT_CORR_LEN>>1;
+		while (rev & bit){
+			rev ^= bit;
+			bit >>= 1;
+		}
+		rev |= bit;
+	}
+
+	//butterflies
+	for (span=1;span<FFT_CORR_LEN;span<<=1){
+		step = FFT_CORR_LEN/(span<<1);
+		for (start=0;start<FFT_CORR_LEN;start+=(span<<1)){
+			for (idx=0;idx<span;idx++){
+				tw = idx*step;
+				wr = fftTwiddle[2*tw];
+				wi = inverse ? -fftTwiddle[2*tw+1] : fftTwiddle[2*tw+1];
+				pos = start+idx;
+				tr = wr*data[2*(pos+span)] - wi*data[2*(pos+span)+1];
+				ti = wr*data[2*(pos+span)+1] + wi*data[2*(pos+span)];
+				data[2*(pos+span)] = data[2*pos] - tr;
+				data[2*(pos+span)+1] = data[2*pos+1] - ti;
+				data[2*pos] += tr;
+				data[2*pos+1] += ti;
+			}
+		}
+	}
+}
+
+/**
+ * Caches the transform of the matched filter reference. Run once at setup, after the reference buffer is filled.
+ * @param refBuf	the baseband sinc reference (e.g. basebandSincRef)
+ * @param refLen	number of taps in the reference (usually 2N+1)
+ */
+void SetupFastCorrelatorReference(const float* refBuf, short refLen){
+	int idx;
+
+	setupFftTwiddles();
+
+	for (idx=0;idx<FFT_CORR_LEN;idx++){
+		refSpectrum[2*idx] = (idx<refLen) ? refBuf[idx] : 0;
+		refSpectrum[2*idx+1] = 0;
+	}
+	fftComplexInPlace(refSpectrum, 0);
+
+	//store the conjugate (correlation, not convolution) and fold in the inverse transform scaling
+	for (idx=0;idx<FFT_CORR_LEN;idx++){
+		refSpectrum[2*idx] = refSpectrum[2*idx]/FFT_CORR_LEN;
+		refSpectrum[2*idx+1] = -refSpectrum[2*idx+1]/FFT_CORR_LEN;
+	}
+}
+
+/**
+ * Correlates the cached reference against both downmixed buffers for lags 0 to numLags-1.
+ * Same result as corrCos[i] = sum_j ref[j]*dmCos[j+i] (and likewise for dmSin) up to float rounding.
+ * Note, sigLen must not exceed FFT_CORR_LEN and refLen+numLags-1 must not exceed sigLen
+ * @param dmCos		In-phase baseband buffer
+ * @param dmSin		Quadrature baseband buffer
+ * @param sigLen	Size of the downmixed buffers (typically 2N+2M)
+ * @param corrCos	receives the in-phase correlation per lag (e.g. corr_c)
+ * @param corrSin	receives the quadrature correlation per lag (e.g. corr_s)
+ * @param numLags	number of lags to compute (typically 2M)
+ */
+void fastQuadratureCorrelation(const float* dmCos, const float* dmSin, short sigLen, float* corrCos, float* corrSin, short numLags){
+	int idx;
+	float xr, xi;
+
+	for (idx=0;idx<sigLen;idx++){
+		corrWork[2*idx] = dmCos[idx];
+		corrWork[2*idx+1] = dmSin[idx];
+	}
+	for (;idx<FFT_CORR_LEN;idx++){
+		corrWork[2*idx] = 0;
+		corrWork[2*idx+1] = 0;
+	}
+
+	fftComplexInPlace(corrWork, 0);
+	for (idx=0;idx<FFT_CORR_LEN;idx++){
+		xr = corrWork[2*idx];
+		xi = corrWork[2*idx+1];
+		corrWork[2*idx] = xr*refSpectrum[2*idx] - xi*refSpectrum[2*idx+1];
+		corrWork[2*idx+1] = xr*refSpectrum[2*idx+1] + xi*refSpectrum[2*idx];
+	}
+	fftComplexInPlace(corrWork, 1);
+
+	//real reference, so the real part only carries the in-phase branch and the imaginary part the quadrature one
+	for (idx=0;idx<numLags;idx++){
+		corrCos[idx] = corrWork[2*idx];
+		corrSin[idx] = corrWork[2*idx+1];
+	}
+}
+
+/**
+ * FFT matched filter fed straight from the recording buffer, with the fs/4 downmix done while packing the FFT input.
+ * Same result as runReceivedPulseBufferDownmixing() followed by fastQuadratureCorrelation().
+ * @param receiveBuf	The receive buffer which contains the received modulated signal (e.g. recbuf)
+ * @param sigLen		Size of the buffer (typically 2N+2M)
+ * @param corrCos		receives the in-phase correlation per lag (e.g. corr_c)
+ * @param corrSin		receives the quadrature correlation per lag (e.g. corr_s)
+ * @param numLags		number of lags to compute (typically 2M)
+ */
+void fastQuarterWaveCorrelation(const float* receiveBuf, short sigLen, float* corrCos, float* corrSin, short numLags){
+	int idx;
+	float xr, xi;
+
+	for (idx=0;idx<FFT_CORR_LEN;idx++){
+		corrWork[2*idx] = 0;
+		corrWork[2*idx+1] = 0;
+	}
+	for (idx=0;idx<sigLen;idx+=4)
+		corrWork[2*idx] = receiveBuf[idx];
+	for (idx=1;idx<sigLen;idx+=4)
+		corrWork[2*idx+1] = receiveBuf[idx];
+	for (idx=2;idx<sigLen;idx+=4)
+		corrWork[2*idx] = -receiveBuf[idx];
+	for (idx=3;idx<sigLen;idx+=4)
+		corrWork[2*idx+1] = -receiveBuf[idx];
+
+	fftComplexInPlace(corrWork, 0);
+	for (idx=0;idx<FFT_CORR_LEN;idx++){
+		xr = corrWork[2*idx];
+		xi = corrWork[2*idx+1];
+		corrWork[2*idx] = xr*refSpectrum[2*idx] - xi*refSpectrum[2*idx+1];
+		corrWork[2*idx+1] = xr*refSpectrum[2*idx+1] + xi*refSpectrum[2*idx];
+	}
+	fftComplexInPlace(corrWork, 1);
+
+	for (idx=0;idx<numLags;idx++){
+		corrCos[idx] = corrWork[2*idx];
+		corrSin[idx] = corrWork[2*idx+1];
+	}
+}
+
+/**
+ * Direct form matched filter fused with the fs/4 downmix, for a single lag. The taps are split into the four carrier
+ * phases of the received sample they multiply: phases 0 and 2 (even samples) feed the in-phase branch with signs
+ * +1/-1, phases 1 and 3 (odd samples) feed the quadrature branch. Each lag costs refLen MACs instead of 2*refLen over
+ * the zero filled downmix buffers. Same result as runReceivedPulseBufferDownmixing() followed by the direct form
+ * correlation at that lag.
+ * @param receiveBuf	The receive buffer which contains the received modulated signal (e.g. recbuf)
+ * @param refBuf		the baseband sinc reference (e.g. basebandSincRef)
+ * @param refLen		number of taps in the reference (usually 2N+1)
+ * @param lag			lag to evaluate, receiveBuf must hold refLen+lag samples
+ * @param corrCos		receives the in-phase correlation (e.g. &corr_c[lag])
+ * @param corrSin		receives the quadrature correlation (e.g. &corr_s[lag])
+ */
+void fusedQuarterWaveCorrelationLag(const float* receiveBuf, const float* refBuf, short refLen, short lag, float* corrCos, float* corrSin){
+	int tap;
+	float phase0 = 0, phase1 = 0, phase2 = 0, phase3 = 0;
+	const float* rx = receiveBuf + lag;
+
+	//carrier phase of tap j is (lag+j)&3, so rotate the accumulators by the lag instead of testing every tap
+	for (tap=0;tap+3<refLen;tap+=4){
+		phase0 += refBuf[tap]*rx[tap];
+		phase1 += refBuf[tap+1]*rx[tap+1];
+		phase2 += refBuf[tap+2]*rx[tap+2];
+		phase3 += refBuf[tap+3]*rx[tap+3];
+	}
+	if (tap<refLen)
+		phase0 += refBuf[tap]*rx[tap];
+	if (tap+1<refLen)
+		phase1 += refBuf[tap+1]*rx[tap+1];
+	if (tap+2<refLen)
+		phase2 += refBuf[tap+2]*rx[tap+2];
+
+	//phaseX holds the taps whose received sample sits at carrier phase (lag+X)&3
+	switch (lag & 3){
+	case 0:
+		*corrCos = phase0 - phase2;
+		*corrSin = phase1 - phase3;
+		break;
+	case 1:
+		*corrCos = phase3 - phase1;
+		*corrSin = phase0 - phase2;
+		break;
+	case 2:
+		*corrCos = phase2 - phase0;
+		*corrSin = phase3 - phase1;
+		break;
+	default:
+		*corrCos = phase1 - phase3;
+		*corrSin = phase2 - phase0;
+		break;
+	}
+}
+
+/**
+ * Runs fusedQuarterWaveCorrelationLag() over lags 0 to numLags-1.
+ * @param receiveBuf	The receive buffer which contains the received modulated signal (e.g. recbuf)
+ * @param refBuf		the baseband sinc reference (e.g. basebandSincRef)
+ * @param refLen		number of taps in the reference (usually 2N+1)
+ * @param corrCos		receives the in-phase correlation per lag (e.g. corr_c)
+ * @param corrSin		receives the quadrature correlation per lag (e.g. corr_s)
+ * @param numLags		number of lags to compute (typically 2M), receiveBuf must hold refLen+numLags-1 samples
+ */
+void fusedQuarterWaveCorrelation(const float* receiveBuf, const float* refBuf, short refLen, float* corrCos, float* corrSin, short numLags){
+	short lag;
+	for (lag=0;lag<numLags;lag++)
+		fusedQuarterWaveCorrelationLag(receiveBuf, refBuf, refLen, lag, &corrCos[lag], &corrSin[lag]);
+}
+
+/**
+ * Integer version of fusedQuarterWaveCorrelationLag() for the fixed point build (see FixedPoint.h).
+ * Products of the Q15 samples and the Q14 reference are summed in 64 bit per carrier phase, then scaled back
+ * to sample units, so the outputs match the float kernel up to the rounding of the reference taps.
+ * @param receiveBuf	The Q15 receive buffer which contains the received modulated signal (e.g. recbuf)
+ * @param refBuf		the Q14 baseband sinc reference (e.g. basebandSincRef)
+ * @param refLen		number of taps in the reference (usually 2N+1)
+ * @param lag			lag to evaluate, receiveBuf must hold refLen+lag samples
+ * @param corrCos		receives the in-phase correlation (e.g. &corr_c[lag])
+ * @param corrSin		receives the quadrature correlation (e.g. &corr_s[lag])
+ */
+void fusedQuarterWaveCorrelationLagQ14(const short* receiveBuf, const short* refBuf, short refLen, short lag, int* corrCos, int* corrSin){
+	int tap;
+	long long phase0 = 0, phase1 = 0, phase2 = 0, phase3 = 0;
+	const short* rx = receiveBuf + lag;
+
+	for (tap=0;tap+3<refLen;tap+=4){
+		phase0 += refBuf[tap]*rx[tap];
+		phase1 += refBuf[tap+1]*rx[tap+1];
+		phase2 += refBuf[tap+2]*rx[tap+2];
+		phase3 += refBuf[tap+3]*rx[tap+3];
+	}
+	if (tap<refLen)
+		phase0 += refBuf[tap]*rx[tap];
+	if (tap+1<refLen)
+		phase1 += refBuf[tap+1]*rx[tap+1];
+	if (tap+2<refLen)
+		phase2 += refBuf[tap+2]*rx[tap+2];
+
+	//same carrier phase rotation as the float kernel
+	switch (lag & 3){
+	case 0:
+		*corrCos = (int)((phase0 - phase2)>>14);
+		*corrSin = (int)((phase1 - phase3)>>14);
+		break;
+	case 1:
+		*corrCos = (int)((phase3 - phase1)>>14);
+		*corrSin = (int)((phase0 - phase2)>>14);
+		break;
+	case 2:
+		*corrCos = (int)((phase2 - phase0)>>14);
+		*corrSin = (int)((phase3 - phase1)>>14);
+		break;
+	default:
+		*corrCos = (int)((phase1 - phase3)>>14);
+		*corrSin = (int)((phase2 - phase0)>>14);
+		break;
+	}
+}
+
+/**
+ * Runs fusedQuarterWaveCorrelationLagQ14() over lags 0 to numLags-1.
+ * @param receiveBuf	The Q15 receive buffer which contains the received modulated signal (e.g. recbuf)
+ * @param refBuf		the Q14 baseband sinc reference (e.g. basebandSincRef)
+ * @param refLen		number of taps in the reference (usually 2N+1)
+ * @param corrCos		receives the in-phase correlation per lag (e.g. corr_c)
+ * @param corrSin		receives the quadrature correlation per lag (e.g. corr_s)
+ * @param numLags		number of lags to compute (typically 2M), receiveBuf must hold refLen+numLags-1 samples
+ */
+void fusedQuarterWaveCorrelationQ14(const short* receiveBuf, const short* refBuf, short refLen, int* corrCos, int* corrSin, short numLags){
+	short lag;
+	for (lag=0;lag<numLags;lag++)
+		fusedQuarterWaveCorrelationLagQ14(receiveBuf, refBuf, refLen, lag, &corrCos[lag], &corrSin[lag]);
+}
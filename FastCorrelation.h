@@ -0,0 +1,32 @@
+/**
+ * @file 	FastCorrelation.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the received sinc pulse matched filter kernels in FastCorrelation.c
+ *
+ * The correlators only depend on the buffer lengths passed in, so they carry no CSL/BSL includes.
+ */
+
+#ifndef FASTCORRELATION_H_
+#define FASTCORRELATION_H_
+
+//FFT length used for the matched filter, must be >= (reference length + number of lags - 1)
+#define FFT_CORR_LOG2_LEN 11
+#define FFT_CORR_LEN (1<<FFT_CORR_LOG2_LEN) //2048
+
+//Setup Functions
+void SetupFastCorrelatorReference(const float* refBuf, short refLen);
+
+//Analysis functions
+void fastQuadratureCorrelation(const float* dmCos, const float* dmSin, short sigLen, float* corrCos, float* corrSin, short numLags);
+void fastQuarterWaveCorrelation(const float* receiveBuf, short sigLen, float* corrCos, float* corrSin, short numLags);
+void fusedQuarterWaveCorrelation(const float* receiveBuf, const float* refBuf, short refLen, float* corrCos, float* corrSin, short numLags);
+void fusedQuarterWaveCorrelationLag(const float* receiveBuf, const float* refBuf, short refLen, short lag, float* corrCos, float* corrSin);
+void fusedQuarterWaveCorrelationQ14(const short* receiveBuf, const short* refBuf, short refLen, int* corrCos, int* corrSin, short numLags);
+void fusedQuarterWaveCorrelationLagQ14(const short* receiveBuf, const short* refBuf, short refLen, short lag, int* corrCos, int* corrSin);
+
+//FFT helpers
+void fftComplexInPlace(float* data, short inverse);
+
+
+#endif /* FASTCORRELATION_H_ */
@@ -0,0 +1,55 @@
+/**
+ * @file 	FixedPoint.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Sample, coefficient and accumulator types for the float and the all-integer signal path
+ *
+ * USE_FIXED_POINT and USE_FUSED_DOWNMIX must be defined before this header is included (ProjectDefinitions.h or the
+ * top of the main file).
+ *
+ * Integer path formats:
+ *  - capture samples (buf, recbuf) stay in the codec's Q15 format, as shorts
+ *  - filter coefficients (matched filters, baseband sinc) are Q14, so the fs/4 values of +-1 and the sinc peak are exact
+ *  - correlation sums are 32 bit, scaled back to sample units after each coefficient product (COEF_MUL)
+ *  - the matched filter accumulates in 64 bit before that scaling, the incoherent metric is 64 bit
+ * With integer samples and the +-1/0 fs/4 coefficients every product is exact, so the search sums are bit exact
+ * against the float path. The matched filter differs from the float path only by the Q14 rounding of the sinc taps.
+ */
+
+#ifndef FIXEDPOINT_H_
+#define FIXEDPOINT_H_
+
+#if (USE_FIXED_POINT && !USE_FUSED_DOWNMIX)
+#error "USE_FIXED_POINT only supports the fused downmix matched filter, set USE_FUSED_DOWNMIX"
+#endif
+
+#if (USE_FIXED_POINT)
+
+typedef short capture_t;		// Q15 captured sample
+typedef short coef_t;			// Q14 filter coefficient
+typedef int corr_t;				// correlation sum in sample units
+typedef long long metric_t;		// incoherent (squared) correlation metric
+
+#define COEF_SHIFT 14
+#define COEF_ONE (1<<COEF_SHIFT)
+#define COEF_FROM_FLOAT(v) ((coef_t)((v)*COEF_ONE + (((v)<0) ? -0.5 : 0.5)))
+#define COEF_MUL(c,x) ((((corr_t)(c))*(x))>>COEF_SHIFT)
+#define COEF_TO_FLOAT(c) ((float)(c)/COEF_ONE)
+#define CAPTURE_ABS(x) abs(x)
+
+#else
+
+typedef float capture_t;
+typedef float coef_t;
+typedef float corr_t;
+typedef float metric_t;
+
+#define COEF_FROM_FLOAT(v) ((float)(v))
+#define COEF_MUL(c,x) ((c)*(x))
+#define COEF_TO_FLOAT(c) ((float)(c))
+#define CAPTURE_ABS(x) fabsf(x)
+
+#endif
+
+
+#endif /* FIXEDPOINT_H_ */
@@ -9,128 +9,56 @@
  */
 
 #include "MathCalculations.h"
+#include "CarrierNco.h"
+#include "FastCorrelation.h"
+#include "PulseSynthesis.h"
 #include <math.h>
 
+#if (USE_NCO_DOWNMIX && USE_FUSED_DOWNMIX)
+#error "the fused downmix is the fs/4 mixing pattern, USE_NCO_DOWNMIX needs USE_FUSED_DOWNMIX 0"
+#endif
+
 //Calculation Variables
-float buf[M];       	// search buffer
-float matchedFilterCosine[M];			// in-phase correlation buffer
-float matchedFilterSine[M];       	// quadrature correlation buffer
-float corr_max, corr_max_s, corr_max_c; // correlation variables
-float corr_c[2*M];
-float corr_s[2*M];
-float s[2*M];
-short corr_max_lag;
-short bufindex = 0;
-float corrSumCosine,corrSumSine,corrSumIncoherent;
-short i,j,k;				// Indices
-double t,x,y;				// More Indices
-float basebandSincRef[2*N+1];   		// baseband sinc pulse buffer
-float recbuf[2*N+2*M]; 		// recording buffer
-float downMixedCosine[2*N+2*M];     		// in-phase downmixed buffer
-float downMixedSine[2*N+2*M];     		// quadrature downmixed buffer
-short recbufindex = 0;		//
+coef_t matchedFilterCosine[M];			// in-phase correlation buffer
+coef_t matchedFilterSine[M];       	// quadrature correlation buffer
+coef_t basebandSincRef[2*N+1];   		// baseband sinc pulse buffer
 
 volatile char local_carrier_phase = 0;
-char r = 0;
-double phase_correction_factor;
 short max_samp = 0;
 
-volatile int recbuf_start_clock = 0; // virtual clock counter for first sample in recording buffer
-
-
+#if (!USE_FUSED_DOWNMIX)
 /**
- * Calculates the delay estimates
- * Stores the results in the coarse_delay_estimate and fine_delay_estimate buffers
+ * Mixes the received waveform in recbuf down to baseband. Without USE_NCO_DOWNMIX this ONLY WORKS at currently set
+ * center freq (1/2 of nyquist)
  */
-void runReceviedSincPulseTimingAnalysis(){
-	// this is where we apply the matched filter
-	// we only do this over a limited range
-	for (i=0;i<=(2*M-1);i++) {
-		corr_c[i] = 0;
-		corr_s[i] = 0;
-		for (j=0;j<(2*N+1);j++) {
-			corr_c[i] += basebandSincRef[j]*downMixedCosine[j+i];
-			corr_s[i] += basebandSincRef[j]*downMixedSine[j+i];
-		}
-		s[i] = corr_c[i]*corr_c[i]+corr_s[i]*corr_s[i];  // noncoherent correlation metric
-	}
-
-	// now find the peak
-	corr_max = 0;
-	corr_max_lag = 0;
-	for (i=0;i<=(2*M-1);i++) {
-		if (s[i]>corr_max){
-			corr_max = s[i];
-			corr_max_lag = i;
-		}
-	}
-	corr_max_c = corr_c[corr_max_lag];
-	corr_max_s = corr_s[corr_max_lag];
-
-	/*
-	printf wrecks the real-time operation
-	printf("Max lag: %d\n",corr_max_lag);
-	printf("Coarse delay estimate: %d.\n",recbuf_start_clock+corr_max_lag);
- 	 */
-
-
-	//increment indices
-	cde_index++;
-	if(cde_index>=MAX_STORED_DELAYS_COARSE) cde_index = 0;
-	fde_index++;
-	if(fde_index>=MAX_STORED_DELAYS_FINE) fde_index = 0;
-	//We do this here, so that the current indice that we are about to store is always the most recent.
-
-	// store coarse delay estimates
-	coarse_delay_estimate[cde_index] = recbuf_start_clock+corr_max_lag;
-
-	// fine delay estimate
-	y = (double) corr_max_s;
-	x = (double) corr_max_c;
-	phase_correction_factor = atan2(y,x)*2*INVPI; // phase
-	r = (recbuf_start_clock+corr_max_lag) & 3; // compute remainder
-	if (r==0)
-		fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor;
-	else if (r==1)
-		fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor-1;
-	else if (r==2) {
-		if (phase_correction_factor>0)
-			fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor-2;
-		else
-			fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor+2;
-	}
-	else if (r==3)
-		fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor+1;
-	else
-		printf("ERROR");
-
-	// --- Calculations Finished ---
-}
+void runReceivedPulseBufferDownmixing(NodeContext* node){
+#if (USE_NCO_DOWNMIX)
+	ncoDownmix(&node->receiveNco, node->recbuf, node->downMixedCosine, node->downMixedSine, 2*N+2*M);
+#else
+	short i;
 
-/**
- * Mixes the received waveform in recbuf down to baseband. ONLY WORKS at currently set center freq (1/2 of nyquist)
- */
-void runReceivedPulseBufferDownmixing(){
 	// downmix (had problems using sin/cos here so used a trick)
 	/* The trick is based on the incoming frequency per sample being (n * pi/2), so every other sample goes to zero,
 	 * while the non-zero components sin() multiplicative factor is unity/1 */
 	for (i=0;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = recbuf[i];
-		downMixedSine[i] = 0;
+		node->downMixedCosine[i] = node->recbuf[i];
+		node->downMixedSine[i] = 0;
  	}
 	for (i=1;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = 0;
-		downMixedSine[i] = recbuf[i];
+		node->downMixedCosine[i] = 0;
+		node->downMixedSine[i] = node->recbuf[i];
 	}
 	for (i=2;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = -recbuf[i];
-		downMixedSine[i] = 0;
+		node->downMixedCosine[i] = -node->recbuf[i];
+		node->downMixedSine[i] = 0;
 	}
 	for (i=3;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = 0;
-		downMixedSine[i] = -recbuf[i];
+		node->downMixedCosine[i] = 0;
+		node->downMixedSine[i] = -node->recbuf[i];
 	}
+#endif
 }
+#endif
 
 /**
  * Note, receiveBufSize typically 2N+2M
@@ -140,6 +68,8 @@ void runReceivedPulseBufferDownmixing(){
  * @param receiveBufSize Size of the buffer
  */
 void quarterWavePulseDownmix(float* receiveBuf, float* dmCos, float* dmSin, short receiveBufSize){
+	short i;
+
 	// downmix (had problems using sin/cos here so used a trick)
 	/* The trick is based on the incoming frequency per sample being (n * pi/2), so every other sample goes to zero,
 	 * while the non-zero components sin() multiplicative factor is unity/1 */
@@ -166,6 +96,8 @@ void quarterWavePulseDownmix(float* receiveBuf, float* dmCos, float* dmSin, shor
 	Sets up the transmit buffer for the sinc pulse modulated at quarter sampling frequency
 */
 void SetupTransmitModulatedSincPulseBuffer(){
+	short i;
+	double x, y, t;
 
 	for (i=-N;i<=N;i++){
 		x = i*BW;
@@ -180,8 +112,8 @@ void SetupTransmitModulatedSincPulseBuffer(){
 	//Half sample delayed
 	for (i=-N;i<=N;i++){
 		x = (i-0.5)*BW;
-		t = (i-0.5)*0.25;
-		y = cos(2*PI*t)*(sin(PI*x)/(PI*x)); // modulated sinc pulse at carrier freq = fs/4
+		t = (i-0.5)*CBW;
+		y = cos(2*PI*t)*(sin(PI*x)/(PI*x)); // modulated sinc pulse at carrier freq = CBW
 		tVerifSincPulsePhased[i+N] = y*32767;
 	}
 }
@@ -218,14 +150,20 @@ void setupTransmitBuffer(short* tBuffer, short halfBufLen, float sincBandwidth,
 	Sets up the buffer used for matched filtering of the sinc pulse
 */
 void SetupReceiveBasebandSincPulseBuffer(){
+	short i;
+	double x, y;
+
 	for (i=-N;i<=N;i++){
 		x = i*BW;
 		if (i!=0)
 			y = sin(PI*x)/(PI*x); // double
 		else
 			y = 1.0;
-		basebandSincRef[i+N] = (float) y;
+		basebandSincRef[i+N] = COEF_FROM_FLOAT(y);
 	}
+#if (!USE_FIXED_POINT)
+	SetupFastCorrelatorReference(basebandSincRef, 2*N+1);	// cache the reference spectrum for the FFT matched filter
+#endif
 }
 
 /**
@@ -235,6 +173,9 @@ void SetupReceiveBasebandSincPulseBuffer(){
  * @param sincBandwidth the bandwidth of the sinc pulse (e.g. 0.0125 BW)
  */
 void setupBasebandSincBuffer(float* buffer, short halfBufLen, float sincBandwidth){
+	short i;
+	double x, y;
+
 	for (i=-N;i<=N;i++){
 		x = i*sincBandwidth;
 		if (i!=0)
@@ -249,13 +190,15 @@ void setupBasebandSincBuffer(float* buffer, short halfBufLen, float sincBandwidt
 	Sets up the matched filter buffers which are used for matching and filtering of the incoming sines and cosines
 */
 void SetupReceiveTrigonometricMatchedFilters(){
+	short i;
+	double t, y;
+
 	for (i=0;i<M;i++){
 		t = i*CBW;				// time
 		y = cos(2*PI*t);		// cosine matched filter (double)
-		matchedFilterCosine[i] = (float) y;		// cast and store
+		matchedFilterCosine[i] = COEF_FROM_FLOAT(y);		// cast and store
 		y = sin(2*PI*t);		// sine matched filter (double)
-		matchedFilterSine[i] = (float) y;     // cast and store
-		buf[i] = 0;             // clear searching buffer
+		matchedFilterSine[i] = COEF_FROM_FLOAT(y);     // cast and store
 	}
 }
 
@@ -267,13 +210,15 @@ void SetupReceiveTrigonometricMatchedFilters(){
  * @param cFreq
  */
 void setupQuadratureCarrierWaveFilterBuffer(float* inPhaseBuffer, float* quadraturebuffer, short bufLen, float cFreq){
+	short i;
+	double t, y;
+
 	for (i=0;i<M;i++){
 		t = i*CBW;				// time
 		y = cos(2*PI*t);		// cosine matched filter (double)
-		matchedFilterCosine[i] = (float) y;		// cast and store
+		matchedFilterCosine[i] = COEF_FROM_FLOAT(y);		// cast and store
 		y = sin(2*PI*t);		// sine matched filter (double)
-		matchedFilterSine[i] = (float) y;     // cast and store
-		buf[i] = 0;             // clear searching buffer
+		matchedFilterSine[i] = COEF_FROM_FLOAT(y);     // cast and store
 	}
 }
 
@@ -372,7 +317,8 @@ int calculateNewResponseTimeMasterCoarse(int curTime, int delayEstimate){
  * @param fde_index
  */
 void calculateNewResponseBufferMaster(short* buffer, short bufferLen, float* fine_delay_estimate, short fde_index){
-
+	float responseTime = masterMirrorResponseTime(fine_delay_estimate, fde_index);
+	synthesizeDelayedPulse(buffer, (bufferLen-1)>>1, BW, CBW, getMasterDelayLevelFromResponseTime(responseTime));
 }
 
 
@@ -385,7 +331,9 @@ void calculateNewResponseBufferMaster(short* buffer, short bufferLen, float* fin
  * @param fde_index				index of latest estimate
  */
 void calculateNewVerifBufferSlave(short* buffer, short bufferLen, float* fine_delay_estimate, short fde_index){
-
+	//the slave corrects its clock by half of the round trip, so the verification pulse carries the fraction of that half
+	float halfRoundTrip = 0.5f * fine_delay_estimate[fde_index];
+	synthesizeDelayedPulse(buffer, (bufferLen-1)>>1, BW, CBW, fractionalDelayPart(halfRoundTrip));
 }
 
 /**
@@ -25,6 +25,7 @@
 #include "MathCalculations.h"
 #include "time_stamper_master.h"
 #include "ProjectDefinitions.h"
+#include "FixedPoint.h"
 
 
 // length of searching window in samples
@@ -46,38 +47,17 @@
 #define PI 3.14159265358979323846
 #define INVPI 0.318309886183791
 
-//Delay estimates (here because they're used for all code)
-extern int coarse_delay_estimate[MAX_STORED_DELAYS_COARSE];
-extern float fine_delay_estimate[MAX_STORED_DELAYS_FINE];
-extern short cde_index;
-extern short fde_index;
+//The delay estimates, the capture and the correlation results are the node's (NodeContext.h), the kernels take it
+#include "NodeContext.h"
 
 //Calculation Variables
-extern float buf[M];       	// search buffer
-extern float matchedFilterCosine[M];			// in-phase correlation buffer
-extern float matchedFilterSine[M];       	// quadrature correlation buffer
-extern float corr_max, corr_max_s, corr_max_c; // correlation variables
-extern float corr_c[2*M];
-extern float corr_s[2*M];
-extern float s[2*M];
-extern short corr_max_lag;
-extern short bufindex;
-extern float corrSumCosine,corrSumSine,corrSumIncoherent;
-extern short i,j,k;				// Indices
-extern double t,x,y;				// More Indices
-extern float basebandSincRef[2*N+1];   		// baseband sinc pulse buffer
-extern float recbuf[2*N+2*M]; 		// recording buffer
-extern float downMixedCosine[2*N+2*M];     		// in-phase downmixed buffer
-extern float downMixedSine[2*N+2*M];     		// quadrature downmixed buffer
-extern short recbufindex;		//
+extern coef_t matchedFilterCosine[M];			// in-phase correlation buffer
+extern coef_t matchedFilterSine[M];       	// quadrature correlation buffer
+extern coef_t basebandSincRef[2*N+1];   		// baseband sinc pulse buffer
 
 extern volatile char local_carrier_phase;
-extern char r;
-extern double phase_correction_factor;
 extern short max_samp;
 
-extern volatile int recbuf_start_clock; // virtual clock counter for first sample in recording buffer
-
 
 
 //Basic Math Helpers
@@ -96,9 +76,10 @@ void SetupReceiveTrigonometricMatchedFilters();
 void setupQuadratureCarrierWaveFilterBuffer(float* inPhaseBuffer, float* quadraturebuffer, short bufLen, float cFreq);
 
 //Analysis functions
-void runReceivedPulseBufferDownmixing();
+#if (!USE_FUSED_DOWNMIX)
+void runReceivedPulseBufferDownmixing(NodeContext* node);
+#endif
 void quarterWavePulseDownmix(float* receiveBuf, float* dmCos, float* dmSin, short receiveBufSize);
-void runReceviedSincPulseTimingAnalysis();
 
 // Time Calc Functions
 int calculateNewSynchronizationTimeSlaveCoarse(int curTime, int delayEstimate);
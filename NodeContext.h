@@ -0,0 +1,90 @@
+/**
+ * @file 	NodeContext.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Signal path state of one node: the searching correlation, the capture and the timing analysis
+ *
+ * N, M, the MAX_STORED_DELAYS_ sizes and the USE_ switches must be defined before this header is included (the top
+ * of the main file or ProjectDefinitions.h), like for FixedPoint.h.
+ *
+ * The state handlers of the frame code and the analysis kernels of the main loop take the context they work on
+ * instead of reaching for globals, and keep their loop indices local. So the kernels can run on several nodes in one
+ * process (the host tools), and the DSK compiler keeps the indices in registers instead of going through memory for
+ * globals a call might change. The clock and the state machine around the signal path (state, vclock_counter,
+ * sinc_launch, wait_count, ...) stay globals, the codec ISR has no argument to pass a context in and the debugger and
+ * the host simulator find them by name. The fields keep the names of the globals they replace.
+ */
+
+#ifndef NODECONTEXT_H_
+#define NODECONTEXT_H_
+
+#include "CarrierNco.h"
+#include "FixedPoint.h"
+
+#ifndef CAPTURE_LEAD
+#define CAPTURE_LEAD	M			// samples before the trigger at the start of a capture
+#endif
+#ifndef CAPTURE_SLOTS
+#define CAPTURE_SLOTS	2
+#endif
+
+typedef struct {
+	//searching correlation, frame code
+	capture_t buf[CAPTURE_LEAD];			// search buffer, the start of the next capture
+	short bufindex;
+	corr_t corrSumCosine, corrSumSine;
+	metric_t corrSumIncoherent;
+	corr_t corrFreshCosine, corrFreshSine;	// sliding detector sums rebuilt from scratch over each pass of buf
+#if (USE_NCO_DOWNMIX)
+	float corrSumEnergy, corrFreshEnergy;	// energy of the samples in buf, for the carrier gate (NCO_COHERENCE)
+	CarrierNco searchNco;					// free running, mixes every searched sample
+	float searchMixedCosine[M];				// buf mixed down to baseband
+	float searchMixedSine[M];
+#endif
+
+	//capture, frame code
+#if (USE_PIPELINED_CAPTURE)
+	capture_t recbufSlots[CAPTURE_SLOTS][2*N+2*M];	// capture slots
+	capture_t* recbuf;						// recording buffer, the slot the node state machine works on
+	short spareSlot;						// slot filled in the background while the node is busy with recbuf
+	short spareIndex;						// next sample in the spare slot, 0 while searching
+	short spareStartClock;					// virtual clock counter for first sample in the spare slot
+	short spareStartLaunch;					// sinc_launch at the first sample in the spare slot
+	short spareWaitCount;					// master: wait_count the spare capture would have by now
+	short spareWrapped;						// master: the clock wrapped since the spare capture was completed
+#else
+	capture_t recbuf[2*N+2*M];			// recording buffer
+#endif
+	short recbufindex;
+	short max_recbuf;						// largest sample magnitude in the capture
+	volatile short recbuf_start_clock;		// virtual clock counter for first sample in recording buffer
+	volatile short recbuf_start_launch;		// sinc_launch at the first sample, recbuf_start_clock counts from that tick
+
+	//timing analysis, main loop
+#if (USE_NCO_DOWNMIX)
+	CarrierNco receiveNco;					// downmix of recbuf, starts at phase 0 on recbuf[0]
+#endif
+#if (!USE_FUSED_DOWNMIX)
+	float downMixedCosine[2*N+2*M];		// in-phase downmixed buffer
+	float downMixedSine[2*N+2*M];		// quadrature downmixed buffer
+#endif
+	corr_t corr_c[2*M];						// matched filter output per lag
+	corr_t corr_s[2*M];
+	metric_t s[2*M];						// noncoherent correlation metric per lag
+	metric_t corr_max;
+	corr_t corr_max_s, corr_max_c;
+	short corr_max_lag;
+	float corr_peak_offset;			// sub-lag position of the correlation magnitude peak relative to corr_max_lag
+	float fine_peak_disagreement;	// carrier phase fine estimate minus magnitude peak estimate, in samples
+	double phase_correction_factor;	// carrier phase at the peak in quarter cycles
+
+	//estimate history, rings for the debugger
+	short coarse_delay_estimate[MAX_STORED_DELAYS_COARSE];
+	float fine_delay_estimate[MAX_STORED_DELAYS_FINE];
+	float fine_delay_snr[MAX_STORED_DELAYS_FINE];		// slave: SNR of the capture behind each fine estimate
+	short cde_index;
+	short fde_index;
+} NodeContext;
+
+
+#endif /* NODECONTEXT_H_ */
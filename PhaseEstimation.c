@@ -0,0 +1,65 @@
+/**
+ * @file 	PhaseEstimation.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Single precision atan2 for the fine (carrier phase) delay estimate
+ *
+ * The C67x does double precision in hardware, but libm atan2 is a software routine of range reduction, a division and
+ * a long series in doubles, which the C67x issues at a fraction of its single precision rate. fastAtan2f() folds the
+ * angle into the first octant and evaluates a 9th order odd polynomial (Abramowitz & Stegun 4.4.49) in float.
+ *
+ * Worst case error, measured over a 1e7 point sweep of the full circle against libm atan2 (host/KernelCheck.c atan2):
+ * 1.2e-5 rad.
+ * At the fs/4 carrier one radian is 2/pi samples, so that is 7.4e-6 samples, or about 0.001 us at 8 kHz,
+ * far below the 0.33 us synchronization accuracy.
+ */
+
+#include "PhaseEstimation.h"
+
+#define PHASE_PI 		3.14159265358979f
+#define PHASE_HALF_PI 	1.57079632679490f
+#define PHASE_2_OVER_PI	0.636619772367581f
+
+/**
+ * atan(z) for 0 <= z <= 1
+ */
+static float atanFirstOctant(float z){
+	float z2 = z*z;
+	return z*(0.9998660f + z2*(-0.3302995f + z2*(0.1801410f + z2*(-0.0851330f + z2*0.0208351f))));
+}
+
+/**
+ * Four quadrant arctangent in single precision
+ * @param y	quadrature component
+ * @param x	in-phase component
+ * @return angle of (x,y) in radians, -pi to pi. Returns 0 for (0,0) instead of NaN.
+ */
+float fastAtan2f(float y, float x){
+	float ax = (x<0) ? -x : x;
+	float ay = (y<0) ? -y : y;
+	float angle;
+
+	if ((ax==0)&&(ay==0))
+		return 0;
+
+	if (ay<=ax)
+		angle = atanFirstOctant(ay/ax);
+	else
+		angle = PHASE_HALF_PI - atanFirstOctant(ax/ay);
+
+	if (x<0)
+		angle = PHASE_PI - angle;
+	if (y<0)
+		angle = -angle;
+	return angle;
+}
+
+/**
+ * Converts the carrier phase at the correlation peak into a sub sample offset (one fs/4 carrier period is 4 samples)
+ * @param corrSin	quadrature correlation at the peak (corr_max_s)
+ * @param corrCos	in-phase correlation at the peak (corr_max_c)
+ * @return the phase_correction_factor, -2 to 2 samples
+ */
+float carrierPhaseToSampleOffset(float corrSin, float corrCos){
+	return fastAtan2f(corrSin, corrCos)*PHASE_2_OVER_PI;
+}
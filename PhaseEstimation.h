@@ -0,0 +1,16 @@
+/**
+ * @file 	PhaseEstimation.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the single precision carrier phase estimate in PhaseEstimation.c
+ */
+
+#ifndef PHASEESTIMATION_H_
+#define PHASEESTIMATION_H_
+
+//Phase helpers
+float fastAtan2f(float y, float x);
+float carrierPhaseToSampleOffset(float corrSin, float corrCos);
+
+
+#endif /* PHASEESTIMATION_H_ */
@@ -13,6 +13,7 @@
 //Board node definitions
 #define MASTER_NODE 1
 #define SLAVE_NODE 	2
+#define RELAY_NODE	3
 
 //Node type - This changes whether setting
 #define NODE_TYPE SLAVE_NODE
@@ -20,6 +21,28 @@
 //If use floating point fixes
 #define USE_FDE 1
 
+//If use the FFT matched filter instead of the direct form correlation
+#define USE_FFT_CORRELATOR 0
+
+//If mix down with the table oscillator (CarrierNco.c) so CBW can be any carrier, needs USE_FUSED_DOWNMIX 0
+#define USE_NCO_DOWNMIX 0
+
+//If correlate straight from recbuf using the fs/4 mixing pattern (no downMixedCosine/downMixedSine buffers)
+#define USE_FUSED_DOWNMIX 1
+
+//If update the searching correlation incrementally instead of the full M tap dot product every sample
+#define USE_SLIDING_DETECTOR 1
+
+//If run the capture, search and matched filter path in integer arithmetic (formats in FixedPoint.h)
+#define USE_FIXED_POINT 0
+
+//If the direct form matched filter searches a coarse lag grid first and then refines around the best lag
+#define USE_HIERARCHICAL_LAG_SEARCH 1
+#define LAG_SEARCH_STEP 8
+
+//If use the single precision polynomial atan2 for the carrier phase (PhaseEstimation.c) instead of libm
+#define USE_FAST_ATAN2 1
+
 //Audio codec sample frequency
 #define DSK_SAMPLE_FREQ DSK6713_AIC23_FREQ_8KHZ
 
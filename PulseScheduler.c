@@ -0,0 +1,134 @@
+/**
+ * @file 	PulseScheduler.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Output pulse scheduler: pulses are descriptors mixed into the output frame straight from their waveforms
+ *
+ * A pulse used to be copied sample by sample into an output ring the size of several clock periods, which the frame
+ * code read at its run head and cleared behind it. Here scheduling a pulse only fills a descriptor, and the frame code
+ * adds the current sample of every pulse that is on to its channel, so pulses may overlap on one channel or start on
+ * the same frame on different ones. The sum saturates like the relay's downlink reply.
+ *
+ * A pulse that changes from one send to the next (the slave's fine delayed clock sinc) has no waveform to point to,
+ * its descriptor has a source instead, which the mixer asks for each sample in turn.
+ *
+ * The frame counter is free running. A pulse is on while now - start < length in unsigned arithmetic, so it wraps
+ * like the stream position, and a pulse scheduled for the current frame plays its first sample in the same frame.
+ * A start before now would not come round again for 2^32 frames, so it is not taken.
+ */
+
+#include <stdlib.h>
+
+#include "PulseScheduler.h"
+
+/**
+ * No pulses, frame 0
+ */
+void pulseSchedulerInit(PulseScheduler* sched){
+	short s;
+
+	for(s = 0; s < PULSE_SLOTS; s++)
+		sched->slot[s].on = 0;
+	sched->now = 0;
+	sched->dropped = 0;
+	sched->late = 0;
+}
+
+/**
+ * Takes a free slot for a pulse starting on start
+ * @return the slot, NULL if start is before now (counted in late) or all slots were taken (counted in dropped)
+ */
+static PulseDescriptor* pulseTake(PulseScheduler* sched, unsigned long start, short length, short gain,
+		unsigned char channel){
+	short s;
+
+	if((long)(start - sched->now) < 0){
+		sched->late++;
+		return NULL;
+	}
+	for(s = 0; s < PULSE_SLOTS; s++){
+		if(!sched->slot[s].on){
+			sched->slot[s].start = start;
+			sched->slot[s].length = length;
+			sched->slot[s].gain = gain;
+			sched->slot[s].channel = channel;
+			return &sched->slot[s];
+		}
+	}
+	sched->dropped++;
+	return NULL;
+}
+
+/**
+ * Schedules a pulse
+ * @param start		frame of its first sample, sched->now for the current frame, not before it
+ * @param wave		waveform, has to stay unchanged until the pulse is over
+ * @param length	samples of the waveform
+ * @param gain		Q14, PULSE_UNITY_GAIN for the waveform as it is
+ * @param channel	frameOut channel it is added to
+ * @return the slot it went into, -1 if start was before now (counted in late) or all slots were taken (dropped)
+ */
+short pulseSchedule(PulseScheduler* sched, unsigned long start, const short* wave, short length, short gain,
+		unsigned char channel){
+	PulseDescriptor* pulse = pulseTake(sched, start, length, gain, channel);
+
+	if(pulse == NULL)
+		return -1;
+	pulse->wave = wave;
+	pulse->source = NULL;
+	pulse->on = 1;		// last, the slot is taken from here on
+	return (short)(pulse - sched->slot);
+}
+
+/**
+ * Schedules a pulse that its source generates while it plays
+ * @param source	called for each sample in turn, from the frame code
+ * @param context	handed to source, has to stay until the pulse is over
+ * @return the slot it went into, -1 if start was before now (counted in late) or all slots were taken (dropped)
+ * @see pulseSchedule() for the other parameters
+ */
+short pulseScheduleSource(PulseScheduler* sched, unsigned long start, PulseSource source, void* context,
+		short length, short gain, unsigned char channel){
+	PulseDescriptor* pulse = pulseTake(sched, start, length, gain, channel);
+
+	if(pulse == NULL)
+		return -1;
+	pulse->wave = NULL;
+	pulse->source = source;
+	pulse->context = context;
+	pulse->on = 1;
+	return (short)(pulse - sched->slot);
+}
+
+/**
+ * Adds the pulses that are on to the frame, frees the ones that played their last sample and moves on a frame
+ * @param frame		output frame, the pulses go on top of what is in it
+ */
+void pulseSchedulerMix(PulseScheduler* sched, short* frame){
+	PulseDescriptor* pulse;
+	unsigned long offset;
+	long sample, value;
+	short s;
+
+	for(s = 0; s < PULSE_SLOTS; s++){
+		pulse = &sched->slot[s];
+		if(!pulse->on)
+			continue;
+		offset = sched->now - pulse->start;
+		if(offset >= (unsigned long) pulse->length)
+			continue;	// not started yet
+		if(pulse->wave != NULL)
+			value = pulse->wave[offset];
+		else
+			value = pulse->source(pulse->context, (short) offset);
+		sample = frame[pulse->channel] + ((value*pulse->gain)>>14);
+		if (sample>32767)
+			sample = 32767;
+		else if (sample<-32768)
+			sample = -32768;
+		frame[pulse->channel] = (short) sample;
+		if(offset == (unsigned long) pulse->length-1)
+			pulse->on = 0;
+	}
+	sched->now++;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file 	PulseScheduler.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the output pulse scheduler in PulseScheduler.c
+ *
+ * A pulse to send is a descriptor: the frame it starts on, the waveform it plays (or the source that generates it),
+ * its gain and its output channel. The frame code mixes the pulses that are on into frameOut.
+ */
+
+#ifndef PULSESCHEDULER_H_
+#define PULSESCHEDULER_H_
+
+#ifndef PULSE_SLOTS
+#define PULSE_SLOTS			4			// pulses scheduled or playing at once
+#endif
+#define PULSE_UNITY_GAIN	16384		// gain 1.0, the gain is Q14 so the unity gain plays the waveform exactly
+
+//Generates a pulse while it plays: called once per sample in order, offset 0 to length-1
+typedef short (*PulseSource)(void* context, short offset);
+
+typedef struct {
+	unsigned long start;		// frame of the first sample, counted like PulseScheduler.now
+	const short* wave;			// waveform, NULL if the source generates it
+	PulseSource source;			// generates the samples of a pulse without a waveform
+	void* context;				// handed to the source
+	short length;				// samples of the pulse
+	short gain;					// Q14
+	unsigned char channel;		// frameOut channel
+	unsigned char on;			// 0 for a free slot
+} PulseDescriptor;
+
+typedef struct {
+	PulseDescriptor slot[PULSE_SLOTS];
+	unsigned long now;			// frames mixed so far
+	unsigned long dropped;		// pulses that found no free slot
+	unsigned long late;			// pulses scheduled to start before now, they could not play
+} PulseScheduler;
+
+//Setup Functions
+void pulseSchedulerInit(PulseScheduler* sched);
+
+//Frame code
+short pulseSchedule(PulseScheduler* sched, unsigned long start, const short* wave, short length, short gain,
+		unsigned char channel);
+short pulseScheduleSource(PulseScheduler* sched, unsigned long start, PulseSource source, void* context,
+		short length, short gain, unsigned char channel);
+void pulseSchedulerMix(PulseScheduler* sched, short* frame);
+
+
+#endif /* PULSESCHEDULER_H_ */
@@ -0,0 +1,122 @@
+/**
+ * @file 	PulseSynthesis.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Generates the modulated sinc pulse at any fractional delay, one sample at a time
+ *
+ * Same waveform as setupTransmitBuffer(): cos(2*pi*CBW*(idx-delay)) * sin(pi*BW*(idx-delay))/(pi*BW*(idx-delay)),
+ * but without a table of precomputed delays. The sine and carrier terms advance by a fixed rotation per sample, so
+ * libm is only called four times when a pulse is started, and any delay can be produced instead of multiples of
+ * 1/MAXDELAY. The rotations run in double so the phase stays exact to well under one output LSB over 2N+1 samples.
+ *
+ * nextDelayedPulseSample() is cheap enough to run from the output ISR, synthesizeDelayedPulseBlock() fills small blocks.
+ */
+
+#include "PulseSynthesis.h"
+#include <math.h>
+
+#define SYNTH_PI 3.14159265358979323846
+
+/**
+ * Sets up the synthesizer to produce a pulse starting at sample -halfBufLen
+ * @param synth			synthesizer state to fill
+ * @param halfBufLen	The size of one half of the pulse (e.g. -N, to 0, to N)
+ * @param sincBandwidth The bandwidth of the sinc pulse (e.g. 0.0125 BW)
+ * @param carrierFreq	The frequency to modulate at 	(e.g. 0.25 CBW)
+ * @param delay			the fractional delay in samples (e.g. 0.5 is one half sample delay)
+ */
+void startDelayedPulse(PulseSynth* synth, short halfBufLen, double sincBandwidth, double carrierFreq, double delay){
+	double start = -(double)halfBufLen - delay;
+
+	synth->halfBufLen = halfBufLen;
+	synth->idx = -halfBufLen;
+
+	synth->delay = delay;
+	synth->sincArgStep = SYNTH_PI*sincBandwidth;
+	synth->sincSin = sin(SYNTH_PI*sincBandwidth*start);
+	synth->sincCos = cos(SYNTH_PI*sincBandwidth*start);
+	synth->sincStepSin = sin(synth->sincArgStep);
+	synth->sincStepCos = cos(synth->sincArgStep);
+
+	synth->carrierSin = sin(2*SYNTH_PI*carrierFreq*start);
+	synth->carrierCos = cos(2*SYNTH_PI*carrierFreq*start);
+	synth->carrierStepSin = sin(2*SYNTH_PI*carrierFreq);
+	synth->carrierStepCos = cos(2*SYNTH_PI*carrierFreq);
+}
+
+/**
+ * Returns the next pulse sample and advances the synthesizer. Returns 0 once the pulse is finished.
+ * @param synth	synthesizer started with startDelayedPulse()
+ * @return the output sample, scaled like setupTransmitBuffer()
+ */
+short nextDelayedPulseSample(PulseSynth* synth){
+	double y, sincArg, rotSin, rotCos;
+
+	if (synth->idx > synth->halfBufLen)
+		return 0;
+
+	sincArg = synth->sincArgStep*((double)synth->idx - synth->delay);
+	if ((sincArg < 1e-9)&&(sincArg > -1e-9))	//at the pulse centre sinc is 1, also keeps division by zero from occurring
+		y = synth->carrierCos;
+	else
+		y = synth->carrierCos*synth->sincSin/sincArg;
+
+	//advance both rotations by one sample
+	rotSin = synth->sincSin*synth->sincStepCos + synth->sincCos*synth->sincStepSin;
+	rotCos = synth->sincCos*synth->sincStepCos - synth->sincSin*synth->sincStepSin;
+	synth->sincSin = rotSin;
+	synth->sincCos = rotCos;
+	rotSin = synth->carrierSin*synth->carrierStepCos + synth->carrierCos*synth->carrierStepSin;
+	rotCos = synth->carrierCos*synth->carrierStepCos - synth->carrierSin*synth->carrierStepSin;
+	synth->carrierSin = rotSin;
+	synth->carrierCos = rotCos;
+	synth->idx++;
+
+	return (short)(y*32767.0);
+}
+
+/**
+ * @param synth	synthesizer started with startDelayedPulse()
+ * @return 1 when all 2*halfBufLen+1 samples have been produced
+ */
+short isDelayedPulseDone(PulseSynth* synth){
+	return synth->idx > synth->halfBufLen;
+}
+
+/**
+ * Writes the next numSamples pulse samples (zeros past the end of the pulse)
+ * @param synth			synthesizer started with startDelayedPulse()
+ * @param out			buffer to write into
+ * @param numSamples	number of samples to write
+ */
+void synthesizeDelayedPulseBlock(PulseSynth* synth, short* out, short numSamples){
+	short idx;
+	for (idx=0;idx<numSamples;idx++)
+		out[idx] = nextDelayedPulseSample(synth);
+}
+
+/**
+ * Calculates a whole delayed transmission waveform into a buffer, drop in for setupTransmitBuffer().
+ * @param tBuffer		The buffer to put the waveform into (2*halfBufLen+1 samples)
+ * @param halfBufLen	The size of one half of the buffer (e.g. -N, to 0, to N)
+ * @param sincBandwidth The bandwidth of the sinc pulse (e.g. 0.0125 BW)
+ * @param carrierFreq	The frequency to modulate at 	(e.g. 0.25 CBW)
+ * @param delay			the fractional delay in samples to allow for sync (e.g. 0.5 is one half sample delay)
+ */
+void synthesizeDelayedPulse(short* tBuffer, short halfBufLen, double sincBandwidth, double carrierFreq, double delay){
+	PulseSynth synth;
+	startDelayedPulse(&synth, halfBufLen, sincBandwidth, carrierFreq, delay);
+	synthesizeDelayedPulseBlock(&synth, tBuffer, 2*halfBufLen+1);
+}
+
+/**
+ * Fractional part of a delay, always 0 <= part < 1 (so -0.25 gives 0.75)
+ * @param delay	delay in samples
+ * @return the delay minus the largest whole sample count not above it
+ */
+float fractionalDelayPart(float delay){
+	float part = delay - (float)((int)delay);
+	if (part < 0)
+		part += 1.0f;
+	return part;
+}
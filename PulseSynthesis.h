@@ -0,0 +1,34 @@
+/**
+ * @file 	PulseSynthesis.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the fractional delay pulse synthesizer in PulseSynthesis.c
+ */
+
+#ifndef PULSESYNTHESIS_H_
+#define PULSESYNTHESIS_H_
+
+/**
+ * Running state for one delayed modulated sinc pulse. Fill it with startDelayedPulse(), then pull samples.
+ */
+typedef struct {
+	double sincSin, sincCos;			// sin/cos(pi*BW*(idx-delay)) for the next sample
+	double sincStepSin, sincStepCos;	// sin/cos(pi*BW), one sample rotation
+	double carrierSin, carrierCos;		// sin/cos(2*pi*CBW*(idx-delay)) for the next sample
+	double carrierStepSin, carrierStepCos;
+	double sincArgStep;					// pi*BW
+	double delay;
+	short idx;							// next sample index, -halfBufLen to halfBufLen
+	short halfBufLen;
+} PulseSynth;
+
+//Synthesis functions
+void startDelayedPulse(PulseSynth* synth, short halfBufLen, double sincBandwidth, double carrierFreq, double delay);
+short nextDelayedPulseSample(PulseSynth* synth);
+short isDelayedPulseDone(PulseSynth* synth);
+void synthesizeDelayedPulseBlock(PulseSynth* synth, short* out, short numSamples);
+void synthesizeDelayedPulse(short* tBuffer, short halfBufLen, double sincBandwidth, double carrierFreq, double delay);
+float fractionalDelayPart(float delay);
+
+
+#endif /* PULSESYNTHESIS_H_ */
@@ -0,0 +1,495 @@
+/**
+ * @file 	PulseTables.h
+ * @brief 	Pulse and filter tables for N 512, M 60, BW 0.0125, CBW 0.25, generated by host/TableGen.c
+ *
+ * Do not edit, generate it again. Included once, by time_stamper_master.c. nodeInit() only uses the tables if the
+ * keys below fit the build and the carrier, it computes them otherwise.
+ */
+
+#ifndef PULSETABLES_H_
+#define PULSETABLES_H_
+
+#define PULSE_TABLES_N 512
+#define PULSE_TABLES_M 60
+#define PULSE_TABLES_BW 0.0125
+#define PULSE_TABLES_CBW 0.25
+#define PULSE_TABLES_FIXED_POINT 0
+#define PULSE_TABLES_PEAK 32767
+#define PULSE_TABLES_N2 (2*PULSE_TABLES_N + 1)
+
+//setupTransmitBuffer() at delay 0, standardWaveformBuffer and delayedWaveformBuffer
+const short pulseTableStandard[PULSE_TABLES_N2] = {
+	1549, 0, -1511, 0, 1463, 0, -1406, 0, 1339, 0, -1263, 0,
+	1180, 0, -1088, 0, 988, 0, -882, 0, 769, 0, -651, 0,
+	528, 0, -400, 0, 269, 0, -135, 0, 0, 0, 136, 0,
+	-274, 0, 410, 0, -546, 0, 679, 0, -809, 0, 935, 0,
+	-1057, 0, 1172, 0, -1282, 0, 1385, 0, -1480, 0, 1567, 0,
+	-1644, 0, 1713, 0, -1771, 0, 1819, 0, -1856, 0, 1881, 0,
+	-1896, 0, 1899, 0, -1890, 0, 1869, 0, -1836, 0, 1792, 0,
+	-1737, 0, 1670, 0, -1592, 0, 1503, 0, -1404, 0, 1296, 0,
+	-1178, 0, 1053, 0, -919, 0, 778, 0, -631, 0, 479, 0,
+	-323, 0, 162, 0, 0, 0, -164, 0, 329, 0, -494, 0,
+	657, 0, -818, 0, 976, 0, -1129, 0, 1277, 0, -1418, 0,
+	1552, 0, -1678, 0, 1795, 0, -1902, 0, 1998, 0, -2083, 0,
+	2156, 0, -2216, 0, 2264, 0, -2297, 0, 2317, 0, -2323, 0,
+	2314, 0, -2291, 0, 2254, 0, -2202, 0, 2136, 0, -2056, 0,
+	1962, 0, -1855, 0, 1735, 0, -1603, 0, 1459, 0, -1305, 0,
+	1140, 0, -967, 0, 786, 0, -597, 0, 402, 0, -203, 0,
+	0, 0, 205, 0, -413, 0, 620, 0, -826, 0, 1030, 0,
+	-1229, 0, 1424, 0, -1613, 0, 1794, 0, -1966, 0, 2129, 0,
+	-2280, 0, 2419, 0, -2546, 0, 2658, 0, -2755, 0, 2836, 0,
+	-2901, 0, 2949, 0, -2980, 0, 2992, 0, -2985, 0, 2961, 0,
+	-2917, 0, 2855, 0, -2774, 0, 2674, 0, -2556, 0, 2421, 0,
+	-2269, 0, 2100, 0, -1915, 0, 1716, 0, -1503, 0, 1277, 0,
+	-1039, 0, 791, 0, -534, 0, 270, 0, 0, 0, -275, 0,
+	553, 0, -832, 0, 1111, 0, -1388, 0, 1661, 0, -1929, 0,
+	2189, 0, -2441, 0, 2681, 0, -2910, 0, 3125, 0, -3324, 0,
+	3506, 0, -3670, 0, 3815, 0, -3938, 0, 4039, 0, -4117, 0,
+	4172, 0, -4201, 0, 4204, 0, -4182, 0, 4133, 0, -4057, 0,
+	3954, 0, -3824, 0, 3668, 0, -3486, 0, 3277, 0, -3044, 0,
+	2786, 0, -2505, 0, 2202, 0, -1878, 0, 1534, 0, -1173, 0,
+	795, 0, -404, 0, 0, 0, 414, 0, -836, 0, 1264, 0,
+	-1696, 0, 2128, 0, -2559, 0, 2986, 0, -3405, 0, 3816, 0,
+	-4214, 0, 4597, 0, -4963, 0, 5309, 0, -5632, 0, 5929, 0,
+	-6199, 0, 6439, 0, -6646, 0, 6818, 0, -6953, 0, 7049, 0,
+	-7104, 0, 7117, 0, -7085, 0, 7008, 0, -6883, 0, 6711, 0,
+	-6490, 0, 6220, 0, -5900, 0, 5529, 0, -5108, 0, 4638, 0,
+	-4117, 0, 3547, 0, -2930, 0, 2264, 0, -1553, 0, 798, 0,
+	0, 0, -839, 0, 1717, 0, -2632, 0, 3581, 0, -4561, 0,
+	5570, 0, -6605, 0, 7663, 0, -8740, 0, 9833, 0, -10939, 0,
+	12054, 0, -13174, 0, 14297, 0, -15417, 0, 16532, 0, -17638, 0,
+	18730, 0, -19805, 0, 20860, 0, -21890, 0, 22892, 0, -23863, 0,
+	24798, 0, -25696, 0, 26552, 0, -27363, 0, 28126, 0, -28840, 0,
+	29500, 0, -30105, 0, 30653, 0, -31141, 0, 31567, 0, -31931, 0,
+	32230, 0, -32464, 0, 32632, 0, -32733, 0, 32767, 0, -32733, 0,
+	32632, 0, -32464, 0, 32230, 0, -31931, 0, 31567, 0, -31141, 0,
+	30653, 0, -30105, 0, 29500, 0, -28840, 0, 28126, 0, -27363, 0,
+	26552, 0, -25696, 0, 24798, 0, -23863, 0, 22892, 0, -21890, 0,
+	20860, 0, -19805, 0, 18730, 0, -17638, 0, 16532, 0, -15417, 0,
+	14297, 0, -13174, 0, 12054, 0, -10939, 0, 9833, 0, -8740, 0,
+	7663, 0, -6605, 0, 5570, 0, -4561, 0, 3581, 0, -2632, 0,
+	1717, 0, -839, 0, 0, 0, 798, 0, -1553, 0, 2264, 0,
+	-2930, 0, 3547, 0, -4117, 0, 4638, 0, -5108, 0, 5529, 0,
+	-5900, 0, 6220, 0, -6490, 0, 6711, 0, -6883, 0, 7008, 0,
+	-7085, 0, 7117, 0, -7104, 0, 7049, 0, -6953, 0, 6818, 0,
+	-6646, 0, 6439, 0, -6199, 0, 5929, 0, -5632, 0, 5309, 0,
+	-4963, 0, 4597, 0, -4214, 0, 3816, 0, -3405, 0, 2986, 0,
+	-2559, 0, 2128, 0, -1696, 0, 1264, 0, -836, 0, 414, 0,
+	0, 0, -404, 0, 795, 0, -1173, 0, 1534, 0, -1878, 0,
+	2202, 0, -2505, 0, 2786, 0, -3044, 0, 3277, 0, -3486, 0,
+	3668, 0, -3824, 0, 3954, 0, -4057, 0, 4133, 0, -4182, 0,
+	4204, 0, -4201, 0, 4172, 0, -4117, 0, 4039, 0, -3938, 0,
+	3815, 0, -3670, 0, 3506, 0, -3324, 0, 3125, 0, -2910, 0,
+	2681, 0, -2441, 0, 2189, 0, -1929, 0, 1661, 0, -1388, 0,
+	1111, 0, -832, 0, 553, 0, -275, 0, 0, 0, 270, 0,
+	-534, 0, 791, 0, -1039, 0, 1277, 0, -1503, 0, 1716, 0,
+	-1915, 0, 2100, 0, -2269, 0, 2421, 0, -2556, 0, 2674, 0,
+	-2774, 0, 2855, 0, -2917, 0, 2961, 0, -2985, 0, 2992, 0,
+	-2980, 0, 2949, 0, -2901, 0, 2836, 0, -2755, 0, 2658, 0,
+	-2546, 0, 2419, 0, -2280, 0, 2129, 0, -1966, 0, 1794, 0,
+	-1613, 0, 1424, 0, -1229, 0, 1030, 0, -826, 0, 620, 0,
+	-413, 0, 205, 0, 0, 0, -203, 0, 402, 0, -597, 0,
+	786, 0, -967, 0, 1140, 0, -1305, 0, 1459, 0, -1603, 0,
+	1735, 0, -1855, 0, 1962, 0, -2056, 0, 2136, 0, -2202, 0,
+	2254, 0, -2291, 0, 2314, 0, -2323, 0, 2317, 0, -2297, 0,
+	2264, 0, -2216, 0, 2156, 0, -2083, 0, 1998, 0, -1902, 0,
+	1795, 0, -1678, 0, 1552, 0, -1418, 0, 1277, 0, -1129, 0,
+	976, 0, -818, 0, 657, 0, -494, 0, 329, 0, -164, 0,
+	0, 0, 162, 0, -323, 0, 479, 0, -631, 0, 778, 0,
+	-919, 0, 1053, 0, -1178, 0, 1296, 0, -1404, 0, 1503, 0,
+	-1592, 0, 1670, 0, -1737, 0, 1792, 0, -1836, 0, 1869, 0,
+	-1890, 0, 1899, 0, -1896, 0, 1881, 0, -1856, 0, 1819, 0,
+	-1771, 0, 1713, 0, -1644, 0, 1567, 0, -1480, 0, 1385, 0,
+	-1282, 0, 1172, 0, -1057, 0, 935, 0, -809, 0, 679, 0,
+	-546, 0, 410, 0, -274, 0, 136, 0, 0, 0, -135, 0,
+	269, 0, -400, 0, 528, 0, -651, 0, 769, 0, -882, 0,
+	988, 0, -1088, 0, 1180, 0, -1263, 0, 1339, 0, -1406, 0,
+	1463, 0, -1511, 0, 1549,
+};
+
+//tModulatedSincPulse
+const short pulseTableModulatedSinc[PULSE_TABLES_N2] = {
+	1549, 0, -1511, 0, 1463, 0, -1406, 0, 1339, 0, -1263, 0,
+	1180, 0, -1088, 0, 988, 0, -882, 0, 769, 0, -651, 0,
+	528, 0, -400, 0, 269, 0, -135, 0, 0, 0, 136, 0,
+	-274, 0, 410, 0, -546, 0, 679, 0, -809, 0, 935, 0,
+	-1057, 0, 1172, 0, -1282, 0, 1385, 0, -1480, 0, 1567, 0,
+	-1644, 0, 1713, 0, -1771, 0, 1819, 0, -1856, 0, 1881, 0,
+	-1896, 0, 1899, 0, -1890, 0, 1869, 0, -1836, 0, 1792, 0,
+	-1737, 0, 1670, 0, -1592, 0, 1503, 0, -1404, 0, 1296, 0,
+	-1178, 0, 1053, 0, -919, 0, 778, 0, -631, 0, 479, 0,
+	-323, 0, 162, 0, 0, 0, -164, 0, 329, 0, -494, 0,
+	657, 0, -818, 0, 976, 0, -1129, 0, 1277, 0, -1418, 0,
+	1552, 0, -1678, 0, 1795, 0, -1902, 0, 1998, 0, -2083, 0,
+	2156, 0, -2216, 0, 2264, 0, -2297, 0, 2317, 0, -2323, 0,
+	2314, 0, -2291, 0, 2254, 0, -2202, 0, 2136, 0, -2056, 0,
+	1962, 0, -1855, 0, 1735, 0, -1603, 0, 1459, 0, -1305, 0,
+	1140, 0, -967, 0, 786, 0, -597, 0, 402, 0, -203, 0,
+	0, 0, 205, 0, -413, 0, 620, 0, -826, 0, 1030, 0,
+	-1229, 0, 1424, 0, -1613, 0, 1794, 0, -1966, 0, 2129, 0,
+	-2280, 0, 2419, 0, -2546, 0, 2658, 0, -2755, 0, 2836, 0,
+	-2901, 0, 2949, 0, -2980, 0, 2992, 0, -2985, 0, 2961, 0,
+	-2917, 0, 2855, 0, -2774, 0, 2674, 0, -2556, 0, 2421, 0,
+	-2269, 0, 2100, 0, -1915, 0, 1716, 0, -1503, 0, 1277, 0,
+	-1039, 0, 791, 0, -534, 0, 270, 0, 0, 0, -275, 0,
+	553, 0, -832, 0, 1111, 0, -1388, 0, 1661, 0, -1929, 0,
+	2189, 0, -2441, 0, 2681, 0, -2910, 0, 3125, 0, -3324, 0,
+	3506, 0, -3670, 0, 3815, 0, -3938, 0, 4039, 0, -4117, 0,
+	4172, 0, -4201, 0, 4204, 0, -4182, 0, 4133, 0, -4057, 0,
+	3954, 0, -3824, 0, 3668, 0, -3486, 0, 3277, 0, -3044, 0,
+	2786, 0, -2505, 0, 2202, 0, -1878, 0, 1534, 0, -1173, 0,
+	795, 0, -404, 0, 0, 0, 414, 0, -836, 0, 1264, 0,
+	-1696, 0, 2128, 0, -2559, 0, 2986, 0, -3405, 0, 3816, 0,
+	-4214, 0, 4597, 0, -4963, 0, 5309, 0, -5632, 0, 5929, 0,
+	-6199, 0, 6439, 0, -6646, 0, 6818, 0, -6953, 0, 7049, 0,
+	-7104, 0, 7117, 0, -7085, 0, 7008, 0, -6883, 0, 6711, 0,
+	-6490, 0, 6220, 0, -5900, 0, 5529, 0, -5108, 0, 4638, 0,
+	-4117, 0, 3547, 0, -2930, 0, 2264, 0, -1553, 0, 798, 0,
+	0, 0, -839, 0, 1717, 0, -2632, 0, 3581, 0, -4561, 0,
+	5570, 0, -6605, 0, 7663, 0, -8740, 0, 9833, 0, -10939, 0,
+	12054, 0, -13174, 0, 14297, 0, -15417, 0, 16532, 0, -17638, 0,
+	18730, 0, -19805, 0, 20860, 0, -21890, 0, 22892, 0, -23863, 0,
+	24798, 0, -25696, 0, 26552, 0, -27363, 0, 28126, 0, -28840, 0,
+	29500, 0, -30105, 0, 30653, 0, -31141, 0, 31567, 0, -31931, 0,
+	32230, 0, -32464, 0, 32632, 0, -32733, 0, 32767, 0, -32733, 0,
+	32632, 0, -32464, 0, 32230, 0, -31931, 0, 31567, 0, -31141, 0,
+	30653, 0, -30105, 0, 29500, 0, -28840, 0, 28126, 0, -27363, 0,
+	26552, 0, -25696, 0, 24798, 0, -23863, 0, 22892, 0, -21890, 0,
+	20860, 0, -19805, 0, 18730, 0, -17638, 0, 16532, 0, -15417, 0,
+	14297, 0, -13174, 0, 12054, 0, -10939, 0, 9833, 0, -8740, 0,
+	7663, 0, -6605, 0, 5570, 0, -4561, 0, 3581, 0, -2632, 0,
+	1717, 0, -839, 0, 0, 0, 798, 0, -1553, 0, 2264, 0,
+	-2930, 0, 3547, 0, -4117, 0, 4638, 0, -5108, 0, 5529, 0,
+	-5900, 0, 6220, 0, -6490, 0, 6711, 0, -6883, 0, 7008, 0,
+	-7085, 0, 7117, 0, -7104, 0, 7049, 0, -6953, 0, 6818, 0,
+	-6646, 0, 6439, 0, -6199, 0, 5929, 0, -5632, 0, 5309, 0,
+	-4963, 0, 4597, 0, -4214, 0, 3816, 0, -3405, 0, 2986, 0,
+	-2559, 0, 2128, 0, -1696, 0, 1264, 0, -836, 0, 414, 0,
+	0, 0, -404, 0, 795, 0, -1173, 0, 1534, 0, -1878, 0,
+	2202, 0, -2505, 0, 2786, 0, -3044, 0, 3277, 0, -3486, 0,
+	3668, 0, -3824, 0, 3954, 0, -4057, 0, 4133, 0, -4182, 0,
+	4204, 0, -4201, 0, 4172, 0, -4117, 0, 4039, 0, -3938, 0,
+	3815, 0, -3670, 0, 3506, 0, -3324, 0, 3125, 0, -2910, 0,
+	2681, 0, -2441, 0, 2189, 0, -1929, 0, 1661, 0, -1388, 0,
+	1111, 0, -832, 0, 553, 0, -275, 0, 0, 0, 270, 0,
+	-534, 0, 791, 0, -1039, 0, 1277, 0, -1503, 0, 1716, 0,
+	-1915, 0, 2100, 0, -2269, 0, 2421, 0, -2556, 0, 2674, 0,
+	-2774, 0, 2855, 0, -2917, 0, 2961, 0, -2985, 0, 2992, 0,
+	-2980, 0, 2949, 0, -2901, 0, 2836, 0, -2755, 0, 2658, 0,
+	-2546, 0, 2419, 0, -2280, 0, 2129, 0, -1966, 0, 1794, 0,
+	-1613, 0, 1424, 0, -1229, 0, 1030, 0, -826, 0, 620, 0,
+	-413, 0, 205, 0, 0, 0, -203, 0, 402, 0, -597, 0,
+	786, 0, -967, 0, 1140, 0, -1305, 0, 1459, 0, -1603, 0,
+	1735, 0, -1855, 0, 1962, 0, -2056, 0, 2136, 0, -2202, 0,
+	2254, 0, -2291, 0, 2314, 0, -2323, 0, 2317, 0, -2297, 0,
+	2264, 0, -2216, 0, 2156, 0, -2083, 0, 1998, 0, -1902, 0,
+	1795, 0, -1678, 0, 1552, 0, -1418, 0, 1277, 0, -1129, 0,
+	976, 0, -818, 0, 657, 0, -494, 0, 329, 0, -164, 0,
+	0, 0, 162, 0, -323, 0, 479, 0, -631, 0, 778, 0,
+	-919, 0, 1053, 0, -1178, 0, 1296, 0, -1404, 0, 1503, 0,
+	-1592, 0, 1670, 0, -1737, 0, 1792, 0, -1836, 0, 1869, 0,
+	-1890, 0, 1899, 0, -1896, 0, 1881, 0, -1856, 0, 1819, 0,
+	-1771, 0, 1713, 0, -1644, 0, 1567, 0, -1480, 0, 1385, 0,
+	-1282, 0, 1172, 0, -1057, 0, 935, 0, -809, 0, 679, 0,
+	-546, 0, 410, 0, -274, 0, 136, 0, 0, 0, -135, 0,
+	269, 0, -400, 0, 528, 0, -651, 0, 769, 0, -882, 0,
+	988, 0, -1088, 0, 1180, 0, -1263, 0, 1339, 0, -1406, 0,
+	1463, 0, -1511, 0, 1549,
+};
+
+//tModulatedSincPulse_delayed
+const short pulseTableModulatedSincDelayed[PULSE_TABLES_N2] = {
+	1101, 1089, -1076, -1060, 1043, 1025, -1004, -983, 959, 934, -907, -879,
+	849, 818, -786, -752, 717, 680, -643, -604, 564, 523, -482, -439,
+	395, 351, -306, -260, 214, 167, -119, -72, 24, -24, 72, 121,
+	-169, -218, 266, 314, -362, -409, 457, 503, -549, -594, 639, 683,
+	-726, -768, 809, 849, -888, -925, 961, 996, -1030, -1062, 1093, 1122,
+	-1149, -1175, 1199, 1222, -1242, -1261, 1278, 1293, -1306, -1317, 1326, 1334,
+	-1339, -1342, 1343, 1342, -1338, -1333, 1326, 1316, -1305, -1291, 1276, 1258,
+	-1238, -1217, 1193, 1167, -1140, -1110, 1079, 1046, -1011, -974, 936, 896,
+	-854, -811, 767, 721, -674, -625, 575, 525, -473, -420, 366, 311,
+	-256, -200, 143, 86, -28, 28, -87, -145, 203, 262, -320, -378,
+	436, 493, -550, -607, 662, 717, -771, -825, 877, 928, -978, -1027,
+	1074, 1120, -1165, -1208, 1249, 1289, -1326, -1362, 1396, 1428, -1459, -1486,
+	1512, 1536, -1557, -1576, 1593, 1607, -1619, -1629, 1636, 1640, -1642, -1642,
+	1639, 1633, -1625, -1614, 1601, 1585, -1567, -1546, 1523, 1497, -1469, -1438,
+	1405, 1369, -1331, -1291, 1249, 1204, -1157, -1109, 1058, 1005, -950, -894,
+	836, 776, -715, -652, 588, 522, -456, -388, 319, 249, -179, -108,
+	36, -36, 109, 182, -255, -328, 402, 475, -548, -620, 692, 763,
+	-834, -904, 973, 1041, -1107, -1173, 1237, 1299, -1360, -1420, 1477, 1533,
+	-1586, -1638, 1687, 1734, -1778, -1821, 1860, 1897, -1932, -1963, 1992, 2018,
+	-2041, -2061, 2078, 2092, -2103, -2110, 2114, 2115, -2113, -2108, 2099, 2087,
+	-2071, -2053, 2031, 2005, -1977, -1945, 1910, 1871, -1830, -1785, 1737, 1686,
+	-1632, -1575, 1516, 1453, -1388, -1320, 1249, 1176, -1101, -1023, 943, 861,
+	-777, -692, 604, 515, -424, -331, 238, 143, -48, 48, -145, -243,
+	341, 440, -539, -638, 736, 835, -932, -1030, 1126, 1222, -1317, -1410,
+	1502, 1593, -1682, -1769, 1854, 1937, -2018, -2096, 2172, 2246, -2316, -2384,
+	2448, 2509, -2567, -2622, 2673, 2721, -2764, -2804, 2840, 2871, -2899, -2923,
+	2942, 2956, -2967, -2973, 2974, 2970, -2963, -2950, 2933, 2910, -2884, -2852,
+	2816, 2775, -2729, -2678, 2623, 2563, -2499, -2429, 2356, 2278, -2195, -2108,
+	2017, 1922, -1822, -1719, 1612, 1501, -1386, -1268, 1147, 1022, -894, -764,
+	630, 494, -355, -215, 72, -72, 219, 367, -516, -667, 818, 970,
+	-1123, -1275, 1428, 1581, -1733, -1885, 2036, 2186, -2334, -2481, 2626, 2769,
+	-2910, -3048, 3184, 3316, -3446, -3572, 3694, 3812, -3927, -4036, 4142, 4242,
+	-4338, -4428, 4513, 4592, -4665, -4732, 4793, 4847, -4895, -4936, 4970, 4997,
+	-5016, -5028, 5033, 5029, -5018, -4999, 4972, 4936, -4892, -4840, 4779, 4710,
+	-4632, -4545, 4449, 4345, -4231, -4109, 3978, 3838, -3690, -3532, 3366, 3190,
+	-3006, -2814, 2612, 2402, -2184, -1957, 1722, 1478, -1227, -968, 700, 426,
+	-143, 145, -442, -746, 1056, 1373, -1697, -2026, 2362, 2703, -3050, -3402,
+	3758, 4120, -4486, -4856, 5230, 5607, -5988, -6372, 6759, 7148, -7539, -7931,
+	8326, 8721, -9117, -9514, 9911, 10308, -10704, -11099, 11493, 11886, -12277, -12666,
+	13052, 13435, -13815, -14192, 14565, 14934, -15298, -15657, 16012, 16361, -16704, -17041,
+	17372, 17696, -18014, -18324, 18626, 18921, -19208, -19487, 19757, 20018, -20270, -20513,
+	20746, 20970, -21184, -21388, 21582, 21765, -21937, -22099, 22250, 22390, -22518, -22636,
+	22741, 22836, -22918, -22990, 23049, 23096, -23132, -23156, 23168, 23168, -23156, -23132,
+	23096, 23049, -22990, -22918, 22836, 22741, -22636, -22518, 22390, 22250, -22099, -21937,
+	21765, 21582, -21388, -21184, 20970, 20746, -20513, -20270, 20018, 19757, -19487, -19208,
+	18921, 18626, -18324, -18014, 17696, 17372, -17041, -16704, 16361, 16012, -15657, -15298,
+	14934, 14565, -14192, -13815, 13435, 13052, -12666, -12277, 11886, 11493, -11099, -10704,
+	10308, 9911, -9514, -9117, 8721, 8326, -7931, -7539, 7148, 6759, -6372, -5988,
+	5607, 5230, -4856, -4486, 4120, 3758, -3402, -3050, 2703, 2362, -2026, -1697,
+	1373, 1056, -746, -442, 145, -143, 426, 700, -968, -1227, 1478, 1722,
+	-1957, -2184, 2402, 2612, -2814, -3006, 3190, 3366, -3532, -3690, 3838, 3978,
+	-4109, -4231, 4345, 4449, -4545, -4632, 4710, 4779, -4840, -4892, 4936, 4972,
+	-4999, -5018, 5029, 5033, -5028, -5016, 4997, 4970, -4936, -4895, 4847, 4793,
+	-4732, -4665, 4592, 4513, -4428, -4338, 4242, 4142, -4036, -3927, 3812, 3694,
+	-3572, -3446, 3316, 3184, -3048, -2910, 2769, 2626, -2481, -2334, 2186, 2036,
+	-1885, -1733, 1581, 1428, -1275, -1123, 970, 818, -667, -516, 367, 219,
+	-72, 72, -215, -355, 494, 630, -764, -894, 1022, 1147, -1268, -1386,
+	1501, 1612, -1719, -1822, 1922, 2017, -2108, -2195, 2278, 2356, -2429, -2499,
+	2563, 2623, -2678, -2729, 2775, 2816, -2852, -2884, 2910, 2933, -2950, -2963,
+	2970, 2974, -2973, -2967, 2956, 2942, -2923, -2899, 2871, 2840, -2804, -2764,
+	2721, 2673, -2622, -2567, 2509, 2448, -2384, -2316, 2246, 2172, -2096, -2018,
+	1937, 1854, -1769, -1682, 1593, 1502, -1410, -1317, 1222, 1126, -1030, -932,
+	835, 736, -638, -539, 440, 341, -243, -145, 48, -48, 143, 238,
+	-331, -424, 515, 604, -692, -777, 861, 943, -1023, -1101, 1176, 1249,
+	-1320, -1388, 1453, 1516, -1575, -1632, 1686, 1737, -1785, -1830, 1871, 1910,
+	-1945, -1977, 2005, 2031, -2053, -2071, 2087, 2099, -2108, -2113, 2115, 2114,
+	-2110, -2103, 2092, 2078, -2061, -2041, 2018, 1992, -1963, -1932, 1897, 1860,
+	-1821, -1778, 1734, 1687, -1638, -1586, 1533, 1477, -1420, -1360, 1299, 1237,
+	-1173, -1107, 1041, 973, -904, -834, 763, 692, -620, -548, 475, 402,
+	-328, -255, 182, 109, -36, 36, -108, -179, 249, 319, -388, -456,
+	522, 588, -652, -715, 776, 836, -894, -950, 1005, 1058, -1109, -1157,
+	1204, 1249, -1291, -1331, 1369, 1405, -1438, -1469, 1497, 1523, -1546, -1567,
+	1585, 1601, -1614, -1625, 1633, 1639, -1642, -1642, 1640, 1636, -1629, -1619,
+	1607, 1593, -1576, -1557, 1536, 1512, -1486, -1459, 1428, 1396, -1362, -1326,
+	1289, 1249, -1208, -1165, 1120, 1074, -1027, -978, 928, 877, -825, -771,
+	717, 662, -607, -550, 493, 436, -378, -320, 262, 203, -145, -87,
+	28, -28, 86, 143, -200, -256, 311, 366, -420, -473, 525, 575,
+	-625, -674, 721, 767, -811, -854, 896, 936, -974, -1011, 1046, 1079,
+	-1110, -1140, 1167, 1193, -1217, -1238, 1258, 1276, -1291, -1305, 1316, 1326,
+	-1333, -1338, 1342, 1343, -1342, -1339, 1334, 1326, -1317, -1306, 1293, 1278,
+	-1261, -1242, 1222, 1199, -1175, -1149, 1122, 1093, -1062, -1030, 996, 961,
+	-925, -888, 849, 809, -768, -726, 683, 639, -594, -549, 503, 457,
+	-409, -362, 314, 266, -218, -169, 121, 72, -24, 24, -72, -119,
+	167, 214, -260, -306, 351, 395, -439, -482, 523, 564, -604, -643,
+	680, 717, -752, -786, 818, 849, -879, -907, 934, 959, -983, -1004,
+	1025, 1043, -1060, -1076, 1089,
+};
+
+//basebandSincRef and basebandSincEnergy
+const coef_t pulseTableBasebandSinc[PULSE_TABLES_N2] = {
+	0.0473016724f, 0.0467531234f, 0.0461301953f, 0.0454335473f, 0.0446639657f, 0.0438223444f,
+	0.0429096892f, 0.041927129f, 0.0408758894f, 0.0397573188f, 0.0385728665f, 0.0373240896f,
+	0.0360126533f, 0.0346403196f, 0.0332089551f, 0.0317205191f, 0.0301770736f, 0.028580768f,
+	0.0269338395f, 0.0252386164f, 0.023497507f, 0.0217129998f, 0.0198876597f, 0.0180241279f,
+	0.016125109f, 0.0141933765f, 0.0122317644f, 0.0102431634f, 0.00823051855f, 0.00619682251f,
+	0.00414511282f, 0.00207846775f, -3.89817169e-17f, -0.00208714604f, -0.00417979993f, -0.00627477001f,
+	-0.00836884696f, -0.0104588093f, -0.0125414291f, -0.0146134766f, -0.0166717228f, -0.0187129471f,
+	-0.0207339432f, -0.0227315202f, -0.0247025061f, -0.0266437642f, -0.028552182f, -0.030424688f,
+	-0.0322582498f, -0.0340498872f, -0.0357966647f, -0.0374957025f, -0.0391441882f, -0.0407393649f,
+	-0.042278558f, -0.0437591486f, -0.0451786146f, -0.0465345047f, -0.0478244573f, -0.0490461998f,
+	-0.0501975566f, -0.0512764417f, -0.052280888f, -0.0532090105f, -0.054059051f, -0.0548293553f,
+	-0.0555183776f, -0.0561247021f, -0.0566470213f, -0.0570841543f, -0.0574350469f, -0.0576987714f,
+	-0.0578745231f, -0.0579616353f, -0.0579595678f, -0.0578679182f, -0.0576864146f, -0.0574149229f,
+	-0.0570534468f, -0.0566021279f, -0.0560612381f, -0.0554311983f, -0.0547125563f, -0.0539060049f,
+	-0.0530123711f, -0.0520326197f, -0.0509678498f, -0.0498192944f, -0.0485883206f, -0.0472764336f,
+	-0.0458852574f, -0.0444165543f, -0.0428722054f, -0.0412542224f, -0.0395647325f, -0.0378059894f,
+	-0.0359803587f, -0.0340903141f, -0.0321384445f, -0.0301274527f, -0.0280601289f, -0.0259393733f,
+	-0.0237681791f, -0.021549629f, -0.0192868952f, -0.0169832297f, -0.0146419639f, -0.0122665046f,
+	-0.00986032374f, -0.00742696086f, -0.0049700113f, -0.00249312469f, 3.89817169e-17f, 0.00250562164f,
+	0.00501996092f, 0.00753920712f, 0.0100595225f, 0.0125770485f, 0.0150879119f, 0.0175882298f,
+	0.0200741161f, 0.022541685f, 0.0249870606f, 0.0274063814f, 0.0297958069f, 0.0321515203f,
+	0.0344697312f, 0.0367466994f, 0.0389787219f, 0.0411621369f, 0.0432933457f, 0.0453688167f,
+	0.0473850705f, 0.0493387058f, 0.0512263998f, 0.0530449115f, 0.0547910854f, 0.0564618669f,
+	0.058054287f, 0.059565492f, 0.0609927289f, 0.0623333603f, 0.0635848641f, 0.0647448376f,
+	0.0658110231f, 0.0667812601f, 0.0676535442f, 0.0684260055f, 0.0690969154f, 0.0696646869f,
+	0.0701278746f, 0.0704852045f, 0.0707355291f, 0.0708778799f, 0.0709114298f, 0.0708355233f,
+	0.0706496537f, 0.0703535005f, 0.0699468851f, 0.0694298074f, 0.0688024312f, 0.068065092f,
+	0.0672182813f, 0.0662626848f, 0.0651991218f, 0.0640286133f, 0.0627523214f, 0.0613715947f,
+	0.0598879308f, 0.058303006f, 0.0566186532f, 0.0548368581f, 0.0529597849f, 0.0509897321f,
+	0.048929166f, 0.0467807055f, 0.0445471071f, 0.0422312841f, 0.0398362763f, 0.0373652801f,
+	0.0348216072f, 0.0322087072f, 0.029530162f, 0.0267896615f, 0.0239910148f, 0.0211381484f,
+	0.0182350837f, 0.015285952f, 0.0122949723f, 0.00926645566f, 0.00620479649f, 0.00311446423f,
+	-3.89817169e-17f, -0.00313399057f, -0.00628284412f, -0.00944184605f, -0.0126062371f, -0.0157712195f,
+	-0.0189319663f, -0.0220836233f, -0.0252213236f, -0.0283401888f, -0.0314353332f, -0.0345018841f,
+	-0.0375349782f, -0.0405297652f, -0.0434814282f, -0.0463851802f, -0.049236279f, -0.0520300269f,
+	-0.0547617823f, -0.0574269742f, -0.0600210875f, -0.0625396967f, -0.0649784505f, -0.0673331022f,
+	-0.0695994869f, -0.0717735589f, -0.0738513693f, -0.0758291036f, -0.0777030662f, -0.0794696733f,
+	-0.0811255127f, -0.0826672912f, -0.0840918571f, -0.0853962451f, -0.0865776092f, -0.0876333043f,
+	-0.0885608345f, -0.0893578827f, -0.0900223106f, -0.0905521661f, -0.0909456834f, -0.091201283f,
+	-0.0913175941f, -0.0912934318f, -0.0911278129f, -0.0908199698f, -0.0903693289f, -0.0897755325f,
+	-0.0890384391f, -0.0881581008f, -0.0871348083f, -0.0859690532f, -0.0846615508f, -0.0832132176f,
+	-0.0816252008f, -0.079898864f, -0.0780357867f, -0.0760377645f, -0.0739067867f, -0.0716450959f,
+	-0.0692550987f, -0.0667394549f, -0.0641010031f, -0.0613427944f, -0.0584680811f, -0.0554803126f,
+	-0.052383136f, -0.0491803847f, -0.0458760858f, -0.0424744338f, -0.0389798135f, -0.0353967808f,
+	-0.0317300521f, -0.0279845111f, -0.0241651926f, -0.0202772822f, -0.0163261108f, -0.0123171406f,
+	-0.0082559688f, -0.00414831098f, 3.89817169e-17f, 0.0041830251f, 0.00839472469f, 0.0126289669f,
+	0.0168795381f, 0.0211401451f, 0.0254044328f, 0.0296659842f, 0.0339183323f, 0.0381549709f,
+	0.042369362f, 0.0465549454f, 0.050705146f, 0.0548133813f, 0.0588730834f, 0.0628776848f,
+	0.0668206662f, 0.0706955045f, 0.0744957626f, 0.0782150179f, 0.0818469375f, 0.0853852481f,
+	0.0888237581f, 0.0921563655f, 0.0953770801f, 0.0984800011f, 0.101459362f, 0.104309522f,
+	0.107024975f, 0.109600358f, 0.112030469f, 0.114310272f, 0.11643488f, 0.11839962f,
+	0.120199986f, 0.12183167f, 0.123290576f, 0.124572814f, 0.12567471f, 0.12659283f,
+	0.127323955f, 0.127865121f, 0.128213599f, 0.128366902f, 0.12832284f, 0.128079444f,
+	0.127635032f, 0.126988187f, 0.126137793f, 0.12508297f, 0.123823151f, 0.122358076f,
+	0.120687738f, 0.118812449f, 0.116732813f, 0.114449732f, 0.111964397f, 0.109278314f,
+	0.106393293f, 0.103311434f, 0.100035146f, 0.0965671465f, 0.0929104388f, 0.0890683532f,
+	0.0850444809f, 0.0808427408f, 0.0764673352f, 0.0719227642f, 0.0672137961f, 0.0623455122f,
+	0.0573232546f, 0.0521526523f, 0.0468396023f, 0.0413902663f, 0.0358110704f, 0.0301086921f,
+	0.0242900662f, 0.0183623638f, 0.0123329908f, 0.00620958395f, -3.89817169e-17f, -0.00628769165f,
+	-0.0126452185f, -0.0190641098f, -0.025535712f, -0.032051187f, -0.03860154f, -0.0451776087f,
+	-0.0517700873f, -0.0583695248f, -0.0649663582f, -0.0715508908f, -0.0781133324f, -0.0846437961f,
+	-0.0911323056f, -0.0975688249f, -0.103943251f, -0.110245444f, -0.116465203f, -0.12259233f,
+	-0.128616616f, -0.134527832f, -0.140315786f, -0.1459703f, -0.151481241f, -0.156838521f,
+	-0.162032112f, -0.16705209f, -0.17188859f, -0.176531881f, -0.180972308f, -0.185200363f,
+	-0.18920669f, -0.192982063f, -0.196517438f, -0.199803934f, -0.202832878f, -0.205595776f,
+	-0.20808436f, -0.210290566f, -0.212206587f, -0.213824868f, -0.215138063f, -0.216139153f,
+	-0.216821358f, -0.217178196f, -0.217203483f, -0.216891333f, -0.216236204f, -0.215232849f,
+	-0.213876352f, -0.212162167f, -0.210086063f, -0.207644194f, -0.204833046f, -0.201649517f,
+	-0.198090851f, -0.19415468f, -0.189839005f, -0.185142264f, -0.180063263f, -0.174601197f,
+	-0.168755695f, -0.162526786f, -0.155914888f, -0.148920834f, -0.141545922f, -0.133791804f,
+	-0.125660583f, -0.117154755f, -0.108277261f, -0.0990314409f, -0.0894210562f, -0.0794502795f,
+	-0.0691236928f, -0.0584462844f, -0.0474234633f, -0.0360610262f, -0.0243651755f, -0.0123425061f,
+	3.89817169e-17f, 0.0126549751f, 0.0256146733f, 0.0388709791f, 0.0524154082f, 0.066239126f,
+	0.0803329349f, 0.0946873203f, 0.109292403f, 0.124138005f, 0.139213622f, 0.154508442f,
+	0.170011371f, 0.185711011f, 0.201595709f, 0.217653543f, 0.233872324f, 0.25023964f,
+	0.266742885f, 0.283369154f, 0.300105453f, 0.31693846f, 0.333854795f, 0.350840896f,
+	0.367882997f, 0.384967268f, 0.402079701f, 0.419206202f, 0.436332583f, 0.45344463f,
+	0.470527977f, 0.487568289f, 0.504551172f, 0.521462142f, 0.538286865f, 0.555010915f,
+	0.571619928f, 0.588099539f, 0.604435503f, 0.620613635f, 0.636619747f, 0.652439952f,
+	0.668060303f, 0.683467031f, 0.698646605f, 0.713585496f, 0.728270471f, 0.742688537f,
+	0.756826758f, 0.770672441f, 0.784213305f, 0.797437131f, 0.810331941f, 0.822886229f,
+	0.835088611f, 0.846928f, 0.858393669f, 0.869475305f, 0.880162656f, 0.890446126f,
+	0.900316298f, 0.909764171f, 0.918781042f, 0.927358687f, 0.935489297f, 0.943165302f,
+	0.950379789f, 0.957125962f, 0.963397741f, 0.969189346f, 0.974495351f, 0.97931093f,
+	0.98363167f, 0.987453461f, 0.990772903f, 0.993586838f, 0.995892763f, 0.997688413f,
+	0.998972237f, 0.999742985f, 1.0f, 0.999742985f, 0.998972237f, 0.997688413f,
+	0.995892763f, 0.993586838f, 0.990772903f, 0.987453461f, 0.98363167f, 0.97931093f,
+	0.974495351f, 0.969189346f, 0.963397741f, 0.957125962f, 0.950379789f, 0.943165302f,
+	0.935489297f, 0.927358687f, 0.918781042f, 0.909764171f, 0.900316298f, 0.890446126f,
+	0.880162656f, 0.869475305f, 0.858393669f, 0.846928f, 0.835088611f, 0.822886229f,
+	0.810331941f, 0.797437131f, 0.784213305f, 0.770672441f, 0.756826758f, 0.742688537f,
+	0.728270471f, 0.713585496f, 0.698646605f, 0.683467031f, 0.668060303f, 0.652439952f,
+	0.636619747f, 0.620613635f, 0.604435503f, 0.588099539f, 0.571619928f, 0.555010915f,
+	0.538286865f, 0.521462142f, 0.504551172f, 0.487568289f, 0.470527977f, 0.45344463f,
+	0.436332583f, 0.419206202f, 0.402079701f, 0.384967268f, 0.367882997f, 0.350840896f,
+	0.333854795f, 0.31693846f, 0.300105453f, 0.283369154f, 0.266742885f, 0.25023964f,
+	0.233872324f, 0.217653543f, 0.201595709f, 0.185711011f, 0.170011371f, 0.154508442f,
+	0.139213622f, 0.124138005f, 0.109292403f, 0.0946873203f, 0.0803329349f, 0.066239126f,
+	0.0524154082f, 0.0388709791f, 0.0256146733f, 0.0126549751f, 3.89817169e-17f, -0.0123425061f,
+	-0.0243651755f, -0.0360610262f, -0.0474234633f, -0.0584462844f, -0.0691236928f, -0.0794502795f,
+	-0.0894210562f, -0.0990314409f, -0.108277261f, -0.117154755f, -0.125660583f, -0.133791804f,
+	-0.141545922f, -0.148920834f, -0.155914888f, -0.162526786f, -0.168755695f, -0.174601197f,
+	-0.180063263f, -0.185142264f, -0.189839005f, -0.19415468f, -0.198090851f, -0.201649517f,
+	-0.204833046f, -0.207644194f, -0.210086063f, -0.212162167f, -0.213876352f, -0.215232849f,
+	-0.216236204f, -0.216891333f, -0.217203483f, -0.217178196f, -0.216821358f, -0.216139153f,
+	-0.215138063f, -0.213824868f, -0.212206587f, -0.210290566f, -0.20808436f, -0.205595776f,
+	-0.202832878f, -0.199803934f, -0.196517438f, -0.192982063f, -0.18920669f, -0.185200363f,
+	-0.180972308f, -0.176531881f, -0.17188859f, -0.16705209f, -0.162032112f, -0.156838521f,
+	-0.151481241f, -0.1459703f, -0.140315786f, -0.134527832f, -0.128616616f, -0.12259233f,
+	-0.116465203f, -0.110245444f, -0.103943251f, -0.0975688249f, -0.0911323056f, -0.0846437961f,
+	-0.0781133324f, -0.0715508908f, -0.0649663582f, -0.0583695248f, -0.0517700873f, -0.0451776087f,
+	-0.03860154f, -0.032051187f, -0.025535712f, -0.0190641098f, -0.0126452185f, -0.00628769165f,
+	-3.89817169e-17f, 0.00620958395f, 0.0123329908f, 0.0183623638f, 0.0242900662f, 0.0301086921f,
+	0.0358110704f, 0.0413902663f, 0.0468396023f, 0.0521526523f, 0.0573232546f, 0.0623455122f,
+	0.0672137961f, 0.0719227642f, 0.0764673352f, 0.0808427408f, 0.0850444809f, 0.0890683532f,
+	0.0929104388f, 0.0965671465f, 0.100035146f, 0.103311434f, 0.106393293f, 0.109278314f,
+	0.111964397f, 0.114449732f, 0.116732813f, 0.118812449f, 0.120687738f, 0.122358076f,
+	0.123823151f, 0.12508297f, 0.126137793f, 0.126988187f, 0.127635032f, 0.128079444f,
+	0.12832284f, 0.128366902f, 0.128213599f, 0.127865121f, 0.127323955f, 0.12659283f,
+	0.12567471f, 0.124572814f, 0.123290576f, 0.12183167f, 0.120199986f, 0.11839962f,
+	0.11643488f, 0.114310272f, 0.112030469f, 0.109600358f, 0.107024975f, 0.104309522f,
+	0.101459362f, 0.0984800011f, 0.0953770801f, 0.0921563655f, 0.0888237581f, 0.0853852481f,
+	0.0818469375f, 0.0782150179f, 0.0744957626f, 0.0706955045f, 0.0668206662f, 0.0628776848f,
+	0.0588730834f, 0.0548133813f, 0.050705146f, 0.0465549454f, 0.042369362f, 0.0381549709f,
+	0.0339183323f, 0.0296659842f, 0.0254044328f, 0.0211401451f, 0.0168795381f, 0.0126289669f,
+	0.00839472469f, 0.0041830251f, 3.89817169e-17f, -0.00414831098f, -0.0082559688f, -0.0123171406f,
+	-0.0163261108f, -0.0202772822f, -0.0241651926f, -0.0279845111f, -0.0317300521f, -0.0353967808f,
+	-0.0389798135f, -0.0424744338f, -0.0458760858f, -0.0491803847f, -0.052383136f, -0.0554803126f,
+	-0.0584680811f, -0.0613427944f, -0.0641010031f, -0.0667394549f, -0.0692550987f, -0.0716450959f,
+	-0.0739067867f, -0.0760377645f, -0.0780357867f, -0.079898864f, -0.0816252008f, -0.0832132176f,
+	-0.0846615508f, -0.0859690532f, -0.0871348083f, -0.0881581008f, -0.0890384391f, -0.0897755325f,
+	-0.0903693289f, -0.0908199698f, -0.0911278129f, -0.0912934318f, -0.0913175941f, -0.091201283f,
+	-0.0909456834f, -0.0905521661f, -0.0900223106f, -0.0893578827f, -0.0885608345f, -0.0876333043f,
+	-0.0865776092f, -0.0853962451f, -0.0840918571f, -0.0826672912f, -0.0811255127f, -0.0794696733f,
+	-0.0777030662f, -0.0758291036f, -0.0738513693f, -0.0717735589f, -0.0695994869f, -0.0673331022f,
+	-0.0649784505f, -0.0625396967f, -0.0600210875f, -0.0574269742f, -0.0547617823f, -0.0520300269f,
+	-0.049236279f, -0.0463851802f, -0.0434814282f, -0.0405297652f, -0.0375349782f, -0.0345018841f,
+	-0.0314353332f, -0.0283401888f, -0.0252213236f, -0.0220836233f, -0.0189319663f, -0.0157712195f,
+	-0.0126062371f, -0.00944184605f, -0.00628284412f, -0.00313399057f, -3.89817169e-17f, 0.00311446423f,
+	0.00620479649f, 0.00926645566f, 0.0122949723f, 0.015285952f, 0.0182350837f, 0.0211381484f,
+	0.0239910148f, 0.0267896615f, 0.029530162f, 0.0322087072f, 0.0348216072f, 0.0373652801f,
+	0.0398362763f, 0.0422312841f, 0.0445471071f, 0.0467807055f, 0.048929166f, 0.0509897321f,
+	0.0529597849f, 0.0548368581f, 0.0566186532f, 0.058303006f, 0.0598879308f, 0.0613715947f,
+	0.0627523214f, 0.0640286133f, 0.0651991218f, 0.0662626848f, 0.0672182813f, 0.068065092f,
+	0.0688024312f, 0.0694298074f, 0.0699468851f, 0.0703535005f, 0.0706496537f, 0.0708355233f,
+	0.0709114298f, 0.0708778799f, 0.0707355291f, 0.0704852045f, 0.0701278746f, 0.0696646869f,
+	0.0690969154f, 0.0684260055f, 0.0676535442f, 0.0667812601f, 0.0658110231f, 0.0647448376f,
+	0.0635848641f, 0.0623333603f, 0.0609927289f, 0.059565492f, 0.058054287f, 0.0564618669f,
+	0.0547910854f, 0.0530449115f, 0.0512263998f, 0.0493387058f, 0.0473850705f, 0.0453688167f,
+	0.0432933457f, 0.0411621369f, 0.0389787219f, 0.0367466994f, 0.0344697312f, 0.0321515203f,
+	0.0297958069f, 0.0274063814f, 0.0249870606f, 0.022541685f, 0.0200741161f, 0.0175882298f,
+	0.0150879119f, 0.0125770485f, 0.0100595225f, 0.00753920712f, 0.00501996092f, 0.00250562164f,
+	3.89817169e-17f, -0.00249312469f, -0.0049700113f, -0.00742696086f, -0.00986032374f, -0.0122665046f,
+	-0.0146419639f, -0.0169832297f, -0.0192868952f, -0.021549629f, -0.0237681791f, -0.0259393733f,
+	-0.0280601289f, -0.0301274527f, -0.0321384445f, -0.0340903141f, -0.0359803587f, -0.0378059894f,
+	-0.0395647325f, -0.0412542224f, -0.0428722054f, -0.0444165543f, -0.0458852574f, -0.0472764336f,
+	-0.0485883206f, -0.0498192944f, -0.0509678498f, -0.0520326197f, -0.0530123711f, -0.0539060049f,
+	-0.0547125563f, -0.0554311983f, -0.0560612381f, -0.0566021279f, -0.0570534468f, -0.0574149229f,
+	-0.0576864146f, -0.0578679182f, -0.0579595678f, -0.0579616353f, -0.0578745231f, -0.0576987714f,
+	-0.0574350469f, -0.0570841543f, -0.0566470213f, -0.0561247021f, -0.0555183776f, -0.0548293553f,
+	-0.054059051f, -0.0532090105f, -0.052280888f, -0.0512764417f, -0.0501975566f, -0.0490461998f,
+	-0.0478244573f, -0.0465345047f, -0.0451786146f, -0.0437591486f, -0.042278558f, -0.0407393649f,
+	-0.0391441882f, -0.0374957025f, -0.0357966647f, -0.0340498872f, -0.0322582498f, -0.030424688f,
+	-0.028552182f, -0.0266437642f, -0.0247025061f, -0.0227315202f, -0.0207339432f, -0.0187129471f,
+	-0.0166717228f, -0.0146134766f, -0.0125414291f, -0.0104588093f, -0.00836884696f, -0.00627477001f,
+	-0.00417979993f, -0.00208714604f, -3.89817169e-17f, 0.00207846775f, 0.00414511282f, 0.00619682251f,
+	0.00823051855f, 0.0102431634f, 0.0122317644f, 0.0141933765f, 0.016125109f, 0.0180241279f,
+	0.0198876597f, 0.0217129998f, 0.023497507f, 0.0252386164f, 0.0269338395f, 0.028580768f,
+	0.0301770736f, 0.0317205191f, 0.0332089551f, 0.0346403196f, 0.0360126533f, 0.0373240896f,
+	0.0385728665f, 0.0397573188f, 0.0408758894f, 0.041927129f, 0.0429096892f, 0.0438223444f,
+	0.0446639657f, 0.0454335473f, 0.0461301953f, 0.0467531234f, 0.0473016724f,
+};
+
+const float pulseTableBasebandSincEnergy = 78.7159805f;
+
+//matchedFilterCosine and matchedFilterSine
+const coef_t pulseTableMatchedCosine[PULSE_TABLES_M] = {
+	1.0f, 6.12323426e-17f, -1.0f, -1.83697015e-16f, 1.0f, 3.061617e-16f,
+	-1.0f, -4.28626385e-16f, 1.0f, 5.5109107e-16f, -1.0f, -2.44991257e-15f,
+	1.0f, -9.80336451e-16f, -1.0f, -2.69484189e-15f, 1.0f, -7.35407081e-16f,
+	-1.0f, -2.9397712e-15f, 1.0f, -4.9047771e-16f, -1.0f, -3.18470073e-15f,
+	1.0f, -2.4554834e-16f, -1.0f, -3.42963005e-15f, 1.0f, -6.18980648e-19f,
+	-1.0f, -3.67455937e-15f, 1.0f, 2.44310375e-16f, -1.0f, -3.91948869e-15f,
+	1.0f, 4.89239719e-16f, -1.0f, -4.164418e-15f, 1.0f, 7.83959655e-15f,
+	-1.0f, -4.40934732e-15f, 1.0f, 9.79098407e-16f, -1.0f, 2.45115051e-15f,
+	1.0f, 8.32945519e-15f, -1.0f, -4.89920638e-15f, 1.0f, 1.46895715e-15f,
+	-1.0f, 1.96129187e-15f, 1.0f, 8.81931382e-15f, -1.0f, -5.38906501e-15f,
+};
+
+const coef_t pulseTableMatchedSine[PULSE_TABLES_M] = {
+	0.0f, 1.0f, 1.22464685e-16f, -1.0f, -2.44929371e-16f, 1.0f,
+	3.67394029e-16f, -1.0f, -4.89858741e-16f, 1.0f, 6.123234e-16f, -1.0f,
+	-7.34788059e-16f, 1.0f, 8.5725277e-16f, -1.0f, -9.79717482e-16f, 1.0f,
+	1.10218214e-15f, -1.0f, -1.2246468e-15f, 1.0f, 4.89982514e-15f, -1.0f,
+	-1.46957612e-15f, 1.0f, -1.9606729e-15f, -1.0f, -1.71450554e-15f, 1.0f,
+	5.38968377e-15f, -1.0f, -1.95943496e-15f, 1.0f, -1.47081416e-15f, -1.0f,
+	-2.20436428e-15f, 1.0f, 5.87954241e-15f, -1.0f, -2.4492936e-15f, 1.0f,
+	-9.80955421e-16f, -1.0f, -9.79965027e-15f, 1.0f, 6.36940147e-15f, -1.0f,
+	-2.93915223e-15f, 1.0f, -4.9109668e-16f, -1.0f, 3.92134581e-15f, 1.0f,
+	6.8592601e-15f, -1.0f, -3.42901108e-15f, 1.0f, -1.2379613e-18f, -1.0f,
+};
+
+
+#endif /* PULSETABLES_H_ */
@@ -0,0 +1,272 @@
+/**
+ * @file 	RelayDownlink.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Downlink of a relay node: the master's mirror on a carrier of its own, timed by the relay's clock
+ *
+ * The relay's clock is the slave clock it keeps against its parent, so its children sync to the parent through it and
+ * each hop adds its own error. The mirror is the single channel master's: search on the carrier, capture 2N+2M
+ * samples, wait for the tick, and play the capture back backwards as long after the tick as it ended before it. The
+ * search is the USE_NCO_DOWNMIX detector with its own oscillator and its carrier gate (NCO_COHERENCE), so it lets the
+ * parent's pulses pass by, and the uplink and downlink searches never share a carrier or a window.
+ *
+ * The tick is passed in rather than read off the clock: the relay's slave clock can skip or repeat a sample at the
+ * wrap, and the reply has to turn about the wrap the parent's children see on the air.
+ *
+ * Unlike the master's, the reply is band limited to the downlink carrier. A child's slot falls on the same tick as the
+ * relay's sibling's slot upstream, so the capture holds the sibling's pulse on CBW as well, and played back as it is
+ * the parent would take it for a pulse and mirror it back with the relay's reply in it, round and round. The filter
+ * is a triangle of two window/2 boxcars at baseband, zero phase so the reply still turns about the tick, run while
+ * the reply plays out in the search rings, which are idle then.
+ */
+
+#include <stdlib.h>
+
+#include "RelayDownlink.h"
+
+static void relayClearSearch(RelayDownlink* link);
+static short relaySearchSample(RelayDownlink* link, short sample);
+static void relayStartCapture(RelayDownlink* link);
+static void relayStartReply(RelayDownlink* link);
+static float relayReplySample(RelayDownlink* link, short sample);
+
+/**
+ * Sets up the downlink mirror, searching
+ * @param carrier	downlink carrier in cycles per sample
+ * @param mixedCos	window floats for the in-phase mixed samples
+ * @param mixedSin	same for the quadrature ones
+ * @param lead		window samples for the start of a capture
+ * @param capture	length samples
+ * @param window	search window in samples (M)
+ * @param length	capture length (2N+2M)
+ * @param threshold	detection threshold on the metric (T1), used without a cfar
+ * @param cfar		adaptive threshold of the downlink search, or NULL for the fixed one
+ */
+void relayDownlinkInit(RelayDownlink* link, double carrier, float* mixedCos, float* mixedSin, short* lead,
+		short* capture, short window, short length, float threshold, CfarDetector* cfar){
+	ncoInit(&link->nco, carrier);
+	link->mixedCos = mixedCos;
+	link->mixedSin = mixedSin;
+	link->lead = lead;
+	link->capture = capture;
+	link->window = window;
+	link->taps = window/2;
+	link->length = length;
+	link->threshold = threshold;
+	link->cfar = cfar;
+	link->state = RELAY_SEARCHING;
+	link->index = 0;
+	link->waitCount = 0;
+	link->peak = 0;
+	link->scale = 0;
+	link->captures = 0;
+	link->replies = 0;
+	link->silent = 0;
+	relayClearSearch(link);
+}
+
+/**
+ * Runs the downlink on one sample
+ * @param sample	received sample (RECEIVE_SINC)
+ * @param tick		1 on the frame the relay's clock wraps
+ * @return the reply sample for TRANSMIT_SINC, 0 while there is none
+ */
+short relayDownlinkSample(RelayDownlink* link, short sample, short tick){
+	short out = 0;
+	float reply;
+
+	if (tick && link->state==RELAY_CALCULATION)
+		link->state = RELAY_TRANSMIT;	// the tick, like the wrap does for the master
+
+	if (link->state==RELAY_SEARCHING) {
+		if (relaySearchSample(link, sample))
+			relayStartCapture(link);
+	}
+	else if (link->state==RELAY_RECORDING) {
+		link->capture[link->index] = sample;
+		if (abs(sample)>link->peak)
+			link->peak = (short) abs(sample);
+		link->index++;
+		if (link->index==link->length) {
+			// the master's playback_scale, but from this capture's peak alone
+			if (link->peak<2048)
+				link->scale = 0;
+			else if (link->peak<4096)
+				link->scale = 8;
+			else if (link->peak<8192)
+				link->scale = 4;
+			else if (link->peak<16384)
+				link->scale = 2;
+			else
+				link->scale = 1;
+			link->waitCount = 0;
+			link->state = RELAY_CALCULATION;
+			link->captures++;
+		}
+	}
+	else if (link->state==RELAY_CALCULATION) {
+		link->waitCount++;
+	}
+	else if (link->state==RELAY_TRANSMIT) {
+		link->waitCount--;
+		if (link->waitCount<=0) {
+			if (link->scale) {
+				relayStartReply(link);
+				link->state = RELAY_SENDSINC;
+			}
+			else {
+				link->silent++;
+				relayClearSearch(link);
+				link->state = RELAY_SEARCHING;
+			}
+		}
+	}
+	else if (link->state==RELAY_SENDSINC) {
+		link->index--;
+		if (link->index>=0) {
+			reply = link->scale*relayReplySample(link, link->index>=link->taps-1 ? link->capture[link->index-link->taps+1] : 0);
+			if (reply>32767)
+				reply = 32767;
+			else if (reply<-32768)
+				reply = -32768;
+			out = (short) reply;
+		}
+		else {
+			link->replies++;
+			relayClearSearch(link);
+			link->state = RELAY_SEARCHING;
+		}
+	}
+	return out;
+}
+
+/**
+ * Empties the search window, the sums start over from the next sample
+ */
+static void relayClearSearch(RelayDownlink* link){
+	short pos;
+
+	for (pos=0;pos<link->window;pos++) {
+		link->mixedCos[pos] = 0;
+		link->mixedSin[pos] = 0;
+		link->lead[pos] = 0;
+	}
+	link->sumCos = 0;
+	link->sumSin = 0;
+	link->energy = 0;
+	link->freshCos = 0;
+	link->freshSin = 0;
+	link->freshEnergy = 0;
+	link->metric = 0;
+	link->pos = 0;
+}
+
+/**
+ * Mixes one sample down and slides the window sums over it
+ * @return 1 if the metric is over the threshold
+ */
+static short relaySearchSample(RelayDownlink* link, short sample){
+	float mixedCos = sample*NCO_COS(link->nco.phase);
+	float mixedSin = sample*NCO_SIN(link->nco.phase);
+	short hit;
+
+	link->nco.phase += link->nco.step;
+	link->sumCos += mixedCos - link->mixedCos[link->pos];
+	link->sumSin += mixedSin - link->mixedSin[link->pos];
+	link->energy += (float) sample*sample - (float) link->lead[link->pos]*link->lead[link->pos];
+	link->freshCos += mixedCos;
+	link->freshSin += mixedSin;
+	link->freshEnergy += (float) sample*sample;
+	link->mixedCos[link->pos] = mixedCos;
+	link->mixedSin[link->pos] = mixedSin;
+	link->lead[link->pos] = sample;
+
+	link->pos++;
+	if (link->pos>=link->window) {
+		link->pos = 0;		// now the oldest sample
+		link->sumCos = link->freshCos;
+		link->sumSin = link->freshSin;
+		link->energy = link->freshEnergy;
+		link->freshCos = 0;
+		link->freshSin = 0;
+		link->freshEnergy = 0;
+	}
+	link->metric = link->sumCos*link->sumCos + link->sumSin*link->sumSin;
+
+	if (link->cfar != NULL)
+		hit = cfarTest(link->cfar, link->metric);
+	else
+		hit = (link->metric>link->threshold);
+	return hit && (link->metric>=NCO_COHERENCE*link->window*link->energy);	// not the parent's carrier
+}
+
+/**
+ * The window starts the capture, oldest sample first, and the search waits until the reply is out
+ */
+static void relayStartCapture(RelayDownlink* link){
+	short dst, src = link->pos;
+
+	for (dst=0;dst<link->window;dst++) {
+		link->capture[dst] = link->lead[src];
+		src++;
+		if (src>=link->window)
+			src = 0;
+	}
+	link->peak = 0;
+	link->index = link->window;
+	link->state = RELAY_RECORDING;
+	if (link->cfar != NULL) {
+		link->cfar->triggers++;
+		cfarRestart(link->cfar);
+	}
+}
+
+/**
+ * Starts the reply filter on the first taps-1 samples of the reply, the filter output is that far behind its input
+ */
+static void relayStartReply(RelayDownlink* link){
+	short pos;
+
+	for (pos=0;pos<2*link->taps;pos++) {
+		link->mixedCos[pos] = 0;
+		link->mixedSin[pos] = 0;
+	}
+	link->replyCos = 0;
+	link->replySin = 0;
+	link->replyCos2 = 0;
+	link->replySin2 = 0;
+	link->pos = 0;
+	link->nco.phase = 0;
+	for (link->index=link->length-1;link->index>link->length-link->taps;link->index--)
+		relayReplySample(link, link->capture[link->index]);
+	link->index = link->length;
+}
+
+/**
+ * Runs one reply sample through the filter: mix down, two boxcars, mix up
+ * @param sample	the reply sample taps-1 ahead of the one that goes out
+ * @return the band limited reply sample that goes out
+ */
+static float relayReplySample(RelayDownlink* link, short sample){
+	float* ringCos2 = link->mixedCos + link->taps;		// second boxcar, behind the first one in the search rings
+	float* ringSin2 = link->mixedSin + link->taps;
+	float mixedCos = sample*NCO_COS(link->nco.phase);
+	float mixedSin = sample*NCO_SIN(link->nco.phase);
+	unsigned int phase;
+
+	link->nco.phase += link->nco.step;
+	link->replyCos += mixedCos - link->mixedCos[link->pos];
+	link->replySin += mixedSin - link->mixedSin[link->pos];
+	link->mixedCos[link->pos] = mixedCos;
+	link->mixedSin[link->pos] = mixedSin;
+	link->replyCos2 += link->replyCos - ringCos2[link->pos];
+	link->replySin2 += link->replySin - ringSin2[link->pos];
+	ringCos2[link->pos] = link->replyCos;
+	ringSin2[link->pos] = link->replySin;
+	link->pos++;
+	if (link->pos>=link->taps)
+		link->pos = 0;
+
+	phase = link->nco.phase - link->taps*link->nco.step;		// of the sample at the centre of the triangle
+	return 2*(link->replyCos2*NCO_COS(phase) + link->replySin2*NCO_SIN(phase))/((float) link->taps*link->taps);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file 	RelayDownlink.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the downlink of a relay node in RelayDownlink.c
+ *
+ * A relay (NODE_TYPE RELAY_NODE) syncs its virtual clock to its parent on CBW like a slave, and mirrors its children's
+ * pulses about its own ticks on a carrier of its own, like a master. Its children are plain slaves built for that
+ * carrier, to them the relay is the master.
+ */
+
+#ifndef RELAYDOWNLINK_H_
+#define RELAYDOWNLINK_H_
+
+#include "CarrierNco.h"
+#include "CfarDetector.h"
+
+//Downlink states, the same numbers as the STATE_ definitions in time_stamper_master.c
+#define RELAY_SEARCHING		0
+#define RELAY_RECORDING		1
+#define RELAY_CALCULATION	2
+#define RELAY_TRANSMIT		3
+#define RELAY_SENDSINC		4
+
+/**
+ * The master's mirror on the downlink carrier: the searching correlation, the capture, and the reply played back
+ * about the relay's tick. It runs beside the relay's own slave state machine and never waits on it.
+ */
+typedef struct {
+	CarrierNco nco;				// downlink carrier, free running over the searched samples
+	float* mixedCos;			// window mixed samples, ring
+	float* mixedSin;
+	short* lead;				// window received samples, ring, they start the capture
+	short* capture;				// length samples, played back backwards as the reply
+	float sumCos;				// correlation over the last window samples
+	float sumSin;
+	float energy;				// of the samples in the window, for the carrier gate
+	float freshCos;				// sums rebuilt over the current pass, like corrFreshCosine
+	float freshSin;
+	float freshEnergy;
+	float metric;				// sumCos^2 + sumSin^2
+	float replyCos;				// reply filter, first boxcar
+	float replySin;
+	float replyCos2;			// second boxcar
+	float replySin2;
+	float threshold;			// fixed detection threshold on the metric, when there is no cfar
+	CfarDetector* cfar;			// adaptive threshold instead, or NULL
+	short window;				// search window in samples (M)
+	short taps;					// boxcar length of the reply filter, window/2
+	short length;				// capture length (2N+2M)
+	short pos;					// ring position of the next sample
+	short state;				// RELAY_*
+	short index;				// next capture sample, then next reply sample
+	short waitCount;			// reply timing, counted like wait_count
+	short peak;					// largest magnitude in the capture
+	short scale;				// reply gain from the peak, like playback_scale, 0 for no reply
+	unsigned long captures;
+	unsigned long replies;
+	unsigned long silent;		// captures too weak to reply to
+} RelayDownlink;
+
+//Setup Functions
+void relayDownlinkInit(RelayDownlink* link, double carrier, float* mixedCos, float* mixedSin, short* lead,
+		short* capture, short window, short length, float threshold, CfarDetector* cfar);
+
+//Frame code
+short relayDownlinkSample(RelayDownlink* link, short sample, short tick);
+
+
+#endif /* RELAYDOWNLINK_H_ */
@@ -0,0 +1,361 @@
+/**
+ * @file 	SampleIODsk.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	DSK6713 sample I/O backend: board and codec setup, the main loop and the drivers that feed process()
+ *
+ * USE_EDMA_PINGPONG 0: McBSP1 receive interrupt on INT15 runs process() on one frame (the original per sample timing)
+ * USE_EDMA_PINGPONG 1: EDMA moves DMA_BLOCK_FRAMES codec words per block between McBSP1 and a ping and a pong buffer,
+ * 						the EDMA completion interrupt on INT8 runs process() on the block that just came in.
+ *
+ * The ping-pong path adds one block of latency on the way in and one on the way out. That is a constant like the
+ * codec delay, but it moves the sync point, so both nodes need the same DMA_BLOCK_FRAMES.
+ */
+
+#include <stdio.h>					//For printf
+#include <c6x.h>					//generic include
+#include <csl.h>					//generic csl include
+#include <csl_gpio.h>
+#include <csl_mcbsp.h>				//for codec support
+#include <csl_irq.h>				//interrupt support
+#include <csl_edma.h>				//ping-pong transfers
+#include <csl_timer.h>				//profiler time base
+
+#include "dsk6713.h"
+#include "dsk6713_aic23.h"
+#include "dsk6713_led.h"
+
+#include "BlockProcessing.h"
+#include "CycleProfiler.h"
+
+//If move the codec data in EDMA ping-pong blocks instead of one McBSP interrupt per frame
+#define USE_EDMA_PINGPONG 0
+#define DMA_BLOCK_FRAMES 32
+
+//Audio codec sample frequency
+#define DSK_SAMPLE_FREQ DSK6713_AIC23_FREQ_8KHZ
+
+//Profiler time base: TIMER1 counting CPU clock/4, 225 MHz on the DSK6713
+#define PROFILE_TIMER_HZ 56250000
+#define PROFILE_TIMER_CTL 0x00000380	// CLKSRC internal (CPU/4), CP clock mode, HLD off, GO is set by TIMER_start
+
+//gpio registers
+#define GPIO_ENABLE_ADDRESS		0x01B00000
+#define GPIO_DIRECTION_ADDRESS	0x01B00004
+#define GPIO_VALUE_ADDRESS		0x01B00008
+
+// ISR combos
+union {Uint32 combo; short channel[2];} tempOutput;
+union {Uint32 combo; short channel[2];} tempInput;
+
+//EDMA ping-pong buffers, one 32 bit codec word per frame
+#pragma DATA_ALIGN(dmaRcvBuf, 8)
+#pragma DATA_ALIGN(dmaXmtBuf, 8)
+Uint32 dmaRcvBuf[2][DMA_BLOCK_FRAMES];
+Uint32 dmaXmtBuf[2][DMA_BLOCK_FRAMES];
+EDMA_Handle hEdmaRcv, hEdmaXmt;					// channels
+EDMA_Handle hEdmaRcvPing, hEdmaRcvPong;			// reload parameter sets
+EDMA_Handle hEdmaXmtPing, hEdmaXmtPong;
+int tccRcv;										// transfer complete code of the receive channel
+volatile short dmaBlock = 0;					// 0 ping, 1 pong, the block the next completion interrupt is for
+
+TIMER_Handle hProfileTimer;						// free running, read by CycleProfiler.c
+
+DSK6713_AIC23_CodecHandle hCodec;							// Codec handle
+DSK6713_AIC23_Config config = DSK6713_AIC23_DEFAULTCONFIG;  // Codec configuration with default settings
+
+GPIO_Handle    hGpio; /* GPIO handle */
+
+GPIO_Handle gpio_handle;
+GPIO_Config gpio_config = {
+    0x00000000, // gpgc = global control
+    0x0000FFFF, // gpen = enable 0-15
+    0x00000000, // gdir = all inputs
+    0x00000000, // gpval = n/a
+    0x00000000, // gphm all interrupts disabled for io pins
+    0x00000000, // gplm all interrupts to cpu or edma disabled
+    0x00000000  // gppol -- default state */
+};
+
+interrupt void serialPortRcvISR(void);
+interrupt void edmaBlockISR(void);
+void setupEdmaPingPong();
+void setupProfileTimer();
+
+//debug gpio function
+void gpioInit();
+void gpioToggle();
+
+int led_prev=0;//not sure how to check led state so just keep local copy
+void toggle_LED(int led)
+{
+	if(led_prev){
+		DSK6713_LED_off(led);
+		led_prev = 0;
+	}else{
+		DSK6713_LED_on(led);
+		led_prev=1;
+	}
+}
+
+void main()
+{
+	nodeInit();
+
+	// -------- DSK Hardware Setup --------
+
+	DSK6713_init();		// Initialize the board support library, must be called first
+	DSK6713_LED_init(); // initialize LEDs
+    hCodec = DSK6713_AIC23_openCodec(0, &config);	// open codec and get handle
+
+	// Configure buffered serial ports for 32 bit operation
+	// This allows transfer of both right and left channels in one read/write
+	MCBSP_FSETS(SPCR1, RINTM, FRM);
+	MCBSP_FSETS(SPCR1, XINTM, FRM);
+	MCBSP_FSETS(RCR1, RWDLEN1, 32BIT);
+	MCBSP_FSETS(XCR1, XWDLEN1, 32BIT);
+
+	// set codec sampling frequency
+	DSK6713_AIC23_setFreq(hCodec, DSK_SAMPLE_FREQ);
+
+	//Example taken from TI forums
+	//Setup GPIO
+	gpioInit();
+
+	//NOTE inf loop
+	//gpioToggle();
+
+	setupProfileTimer();
+
+	// interrupt setup
+	IRQ_globalDisable();			// Globally disables interrupts
+	IRQ_nmiEnable();				// Enables the NMI interrupt
+#if (USE_EDMA_PINGPONG)
+	setupEdmaPingPong();
+	IRQ_map(IRQ_EVT_EDMAINT,8);		// EDMA completion interrupt, see vectors.asm
+	IRQ_enable(IRQ_EVT_EDMAINT);
+#else
+	IRQ_map(IRQ_EVT_RINT1,15);		// Maps an event to a physical interrupt
+	IRQ_enable(IRQ_EVT_RINT1);		// Enables the event
+#endif
+	IRQ_globalEnable();				// Globally enables interrupts
+#if (USE_EDMA_PINGPONG)
+	EDMA_setChannel(hEdmaXmt);		// DXR is already empty, so the first transmit event has to be given by hand
+#endif
+
+	// -------- End DSK Hardware Setup --------
+
+	while(1)						// main loop
+	{
+		nodeBackgroundTask();
+	}
+}
+
+/**
+ * McBSP1 receive interrupt, one frame per interrupt
+ */
+interrupt void serialPortRcvISR()
+{
+#if (USE_CYCLE_PROFILER)
+	profile_tick_t start = profilerTimerRead();
+#endif
+
+	tempInput.combo = MCBSP_read(DSK6713_AIC23_DATAHANDLE);
+
+	process(tempInput.channel, tempOutput.channel, 1);
+
+	//Write the output sample to the audio codec
+	MCBSP_write(DSK6713_AIC23_DATAHANDLE, tempOutput.combo);
+
+	PROFILE_STOP(PROFILE_ISR, start);
+}
+
+/**
+ * EDMA completion interrupt, one block per interrupt. The transmit channel runs in step with the receive channel, so
+ * the output block with the same index was just sent and is free to be filled.
+ */
+interrupt void edmaBlockISR()
+{
+	short block;
+#if (USE_CYCLE_PROFILER)
+	profile_tick_t start = profilerTimerRead();
+#endif
+
+	if(!EDMA_intTest(tccRcv))
+		return;
+	EDMA_intClear(tccRcv);
+
+	block = dmaBlock;
+	dmaBlock ^= 1;
+
+	// a 32 bit codec word has the same layout as two frame channels
+	process((const short*) dmaRcvBuf[block], (short*) dmaXmtBuf[block], DMA_BLOCK_FRAMES);
+
+	PROFILE_STOP(PROFILE_ISR, start);
+}
+
+/**
+ * Sets up the receive (McBSP1 -> dmaRcvBuf) and transmit (dmaXmtBuf -> McBSP1) channels, each alternating between
+ * the ping and pong buffer through linked reload parameter sets. Only the receive channel interrupts.
+ */
+void setupEdmaPingPong()
+{
+	Uint32 rcvAddr = MCBSP_getRcvAddr(DSK6713_AIC23_DATAHANDLE);
+	Uint32 xmtAddr = MCBSP_getXmtAddr(DSK6713_AIC23_DATAHANDLE);
+	Uint32 cnt = EDMA_FMK(CNT, FRMCNT, 0) | EDMA_FMK(CNT, ELECNT, DMA_BLOCK_FRAMES);
+	Uint32 rld = EDMA_FMK(RLD, ELERLD, DMA_BLOCK_FRAMES);
+	Uint32 rcvOpt, xmtOpt;
+	short f;
+
+	for(f = 0; f < DMA_BLOCK_FRAMES; f++){
+		dmaXmtBuf[0][f] = 0;
+		dmaXmtBuf[1][f] = 0;
+	}
+	dmaBlock = 0;
+
+	hEdmaRcv = EDMA_open(EDMA_CHA_REVT1, EDMA_OPEN_RESET);
+	hEdmaXmt = EDMA_open(EDMA_CHA_XEVT1, EDMA_OPEN_RESET);
+	hEdmaRcvPing = EDMA_allocTable(-1);
+	hEdmaRcvPong = EDMA_allocTable(-1);
+	hEdmaXmtPing = EDMA_allocTable(-1);
+	hEdmaXmtPong = EDMA_allocTable(-1);
+	tccRcv = EDMA_intAlloc(-1);
+
+	rcvOpt = EDMA_FMKS(OPT, PRI, HIGH) | EDMA_FMKS(OPT, ESIZE, 32BIT) | EDMA_FMKS(OPT, 2DS, NO) |
+			EDMA_FMKS(OPT, SUM, NONE) | EDMA_FMKS(OPT, 2DD, NO) | EDMA_FMKS(OPT, DUM, INC) |
+			EDMA_FMKS(OPT, TCINT, YES) | EDMA_FMK(OPT, TCC, tccRcv) | EDMA_FMKS(OPT, LINK, YES) | EDMA_FMKS(OPT, FS, NO);
+	xmtOpt = EDMA_FMKS(OPT, PRI, HIGH) | EDMA_FMKS(OPT, ESIZE, 32BIT) | EDMA_FMKS(OPT, 2DS, NO) |
+			EDMA_FMKS(OPT, SUM, INC) | EDMA_FMKS(OPT, 2DD, NO) | EDMA_FMKS(OPT, DUM, NONE) |
+			EDMA_FMKS(OPT, TCINT, NO) | EDMA_FMKS(OPT, LINK, YES) | EDMA_FMKS(OPT, FS, NO);
+
+	EDMA_configArgs(hEdmaRcv, rcvOpt, rcvAddr, cnt, (Uint32) dmaRcvBuf[0], 0, rld);
+	EDMA_configArgs(hEdmaRcvPing, rcvOpt, rcvAddr, cnt, (Uint32) dmaRcvBuf[0], 0, rld);
+	EDMA_configArgs(hEdmaRcvPong, rcvOpt, rcvAddr, cnt, (Uint32) dmaRcvBuf[1], 0, rld);
+	EDMA_link(hEdmaRcv, hEdmaRcvPong);
+	EDMA_link(hEdmaRcvPong, hEdmaRcvPing);
+	EDMA_link(hEdmaRcvPing, hEdmaRcvPong);
+
+	EDMA_configArgs(hEdmaXmt, xmtOpt, (Uint32) dmaXmtBuf[0], cnt, xmtAddr, 0, rld);
+	EDMA_configArgs(hEdmaXmtPing, xmtOpt, (Uint32) dmaXmtBuf[0], cnt, xmtAddr, 0, rld);
+	EDMA_configArgs(hEdmaXmtPong, xmtOpt, (Uint32) dmaXmtBuf[1], cnt, xmtAddr, 0, rld);
+	EDMA_link(hEdmaXmt, hEdmaXmtPong);
+	EDMA_link(hEdmaXmtPong, hEdmaXmtPing);
+	EDMA_link(hEdmaXmtPing, hEdmaXmtPong);
+
+	EDMA_intClear(tccRcv);
+	EDMA_intEnable(tccRcv);
+	EDMA_enableChannel(hEdmaRcv);
+	EDMA_enableChannel(hEdmaXmt);
+}
+
+/**
+ * Starts TIMER1 free running over the full 32 bit period for the profiler
+ */
+void setupProfileTimer()
+{
+	hProfileTimer = TIMER_open(TIMER_DEV1, TIMER_OPEN_RESET);
+	TIMER_configArgs(hProfileTimer, PROFILE_TIMER_CTL, 0xFFFFFFFF, 0x00000000);
+	TIMER_start(hProfileTimer);
+}
+
+/**
+ * Profiler time base
+ */
+profile_tick_t profilerTimerRead(){
+	return TIMER_getCount(hProfileTimer);
+}
+
+unsigned long profilerTimerHz(){
+	return PROFILE_TIMER_HZ;
+}
+
+/**
+ * State indicators, the node numbers its LEDs and debug pins by state
+ */
+void indicatorLedOn(short led){
+	DSK6713_LED_on(led);
+}
+
+void indicatorLedOff(short led){
+	DSK6713_LED_off(led);
+}
+
+void gpioInit()
+{
+	//--------------NOTE------------------
+	//	FOR GPIOs TO WORK ON C6713 DSK SPECTRUM DIGITAL BOARD
+	//	SWITCH 4 OF THE DIPSWITCH SW3 (NOT SW1!!!) HAS TO BE ON-CLOSED
+	//--------------NOTE------------------
+
+	GPIO_Config MyConfig = {
+
+	0x00000000, /* gpgc */
+
+	0x0000FFFF, /* gpen --*/
+
+	0x00000000, /* gdir -*/
+
+	0x00000000, /* gpval */
+
+	0x00000000, /* gphm all interrupts disabled for io pins */
+
+	0x00000000, /* gplm all interrupts to cpu or edma disabled  */
+
+	0x00000000  /* gppol -- default state */
+
+	};
+
+	hGpio  = GPIO_open( GPIO_DEV0, GPIO_OPEN_RESET );
+
+	GPIO_config(hGpio  , &MyConfig );
+
+	/* Enables pins */
+	GPIO_pinEnable (hGpio,GPIO_PIN0| GPIO_PIN1 | GPIO_PIN2 | GPIO_PIN3 | GPIO_PIN4 | GPIO_PIN5);//enable here or in MyConfig
+
+	/* Sets Pin0, Pin1, and Pin2 as an output pins. */
+	int Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN0, GPIO_OUTPUT);
+	Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN1, GPIO_OUTPUT);
+	Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN2, GPIO_OUTPUT);
+	Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN3, GPIO_OUTPUT);
+
+}
+
+void gpioToggle()
+{
+	while(1)
+	{
+		GPIO_pinWrite( hGpio, GPIO_PIN0, 0 );
+		GPIO_pinWrite( hGpio, GPIO_PIN1, 0 );
+		*((int*)GPIO_VALUE_ADDRESS) = 255;
+		DSK6713_waitusec(500000);
+		GPIO_pinWrite( hGpio, GPIO_PIN0, 1 );
+		GPIO_pinWrite( hGpio, GPIO_PIN1, 1 );
+		*((int*)GPIO_VALUE_ADDRESS) = 0;
+		DSK6713_waitusec(500000);
+
+
+	}
+}
+
+
+void ToggleDebugGPIO(short IONum){
+	if (IONum == 0){
+		GPIO_pinWrite(hGpio,GPIO_PIN0,1);
+		GPIO_pinWrite(hGpio,GPIO_PIN0,0);
+	}
+	else if(IONum == 1){
+		GPIO_pinWrite(hGpio,GPIO_PIN1, 1);
+		GPIO_pinWrite(hGpio,GPIO_PIN1, 0);
+	}
+	else if(IONum == 2){
+		GPIO_pinWrite(hGpio,GPIO_PIN2, 1);
+		GPIO_pinWrite(hGpio,GPIO_PIN2, 0);
+	}
+	else if(IONum == 3){
+		GPIO_pinWrite(hGpio,GPIO_PIN3, 1);
+		GPIO_pinWrite(hGpio,GPIO_PIN3, 0);
+	}
+	else{
+		//error
+	}
+}
@@ -0,0 +1,153 @@
+/**
+ * @file 	StreamEstimator.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Received sample stream with clock stamps, and the peak tracker that finds the pulses in the matched filter
+ *
+ * The stream replaces the search and record states: the frame code only writes each sample with its clock, and the
+ * main loop runs the matched filter over the stream in blocks, so every sample is searched and none is left out while
+ * a capture is analysed. The clock is stamped per sample because the slave's clock slips and steps, the position of a
+ * pulse in the stream is in samples of the air, its time is read off the stamp of the sample it starts on.
+ *
+ * The tracker takes the metric of each lag, the lag being the stream position the pulse would start on. A lag over
+ * the threshold starts a peak or raises it, and the peak is confirmed once guard lags have passed without a higher
+ * one. The guard is at least the matched filter's main lobe, so the sidelobes before the peak are always overtaken by
+ * the main lobe in time. The sidelobes after it are masked for the reach of the pulse: a later peak there has to be
+ * STREAM_SIDELOBE of the confirmed one. So a pulse is reported a fixed number of lags after it starts, and the next
+ * one can follow right after it.
+ */
+
+#include "StreamEstimator.h"
+
+#if defined(__GNUC__)
+#define STREAM_LOAD_ACQUIRE(p)		__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STREAM_STORE_RELEASE(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#else
+#define STREAM_LOAD_ACQUIRE(p)		(*(p))
+#define STREAM_STORE_RELEASE(p, v)	(*(p) = (v))
+#endif
+
+/**
+ * Empty stream, no peak, not listening for a reply
+ * @param guard		lags after a peak that confirm it, at least the main lobe of the metric
+ * @param reach		lags after a confirmed peak its sidelobes reach (2N)
+ */
+void streamInit(StreamEstimator* stream, unsigned long guard, unsigned long reach){
+	stream->head = 0;
+	stream->listenFrom = 0;
+	stream->ticks = 0;
+	stream->next = 0;
+	stream->guard = guard;
+	stream->reach = reach;
+	stream->pending = 0;
+	stream->peakPosition = 0;
+	stream->peakMetric = 0;
+	stream->maskEnd = 0;
+	stream->maskMetric = 0;
+	stream->answered = 0;
+	stream->lastTicks = 0;
+	stream->pulses = 0;
+	stream->replies = 0;
+	stream->overruns = 0;
+	stream->latencyMax = 0;
+}
+
+/**
+ * Writes one received sample with the clock it came in on
+ * @param clock		vclock label of the sample
+ * @param launch	sinc_launch
+ */
+void streamPush(StreamEstimator* stream, short sample, short clock, short launch){
+	unsigned long head = stream->head;		// only this side writes head
+	unsigned long pos = STREAM_INDEX(head);
+
+	stream->ring[pos] = sample;
+	stream->stamp[pos].clock = clock;
+	stream->stamp[pos].launch = launch;
+	stream->stamp[pos].ticks = stream->ticks;
+	STREAM_STORE_RELEASE(&stream->head, head + 1);		// after the sample, the main loop may read it from here on
+}
+
+/**
+ * The node's own pulse is out, the first pulse that starts from the next sample on is the reply
+ */
+void streamListen(StreamEstimator* stream){
+	STREAM_STORE_RELEASE(&stream->listenFrom, stream->head);
+}
+
+/**
+ * @return the samples written so far, the ones before it may be read
+ */
+unsigned long streamWritten(const StreamEstimator* stream){
+	return STREAM_LOAD_ACQUIRE(&stream->head);
+}
+
+/**
+ * Checks that the block of lags from next on can be run. If the main loop fell so far behind that the frame code may
+ * be overwriting the block, it skips ahead to the newest samples and drops the peak it was tracking.
+ * @param span	samples a block reads from next on (2N+2M)
+ * @return 1 if the samples are in
+ */
+short streamBlockReady(StreamEstimator* stream, short span){
+	unsigned long head = STREAM_LOAD_ACQUIRE(&stream->head);
+
+	if(span < 0 || span > STREAM_RING)
+		return 0;		// the ring can never hold the block
+	if(head - stream->next > (unsigned long) (STREAM_RING - span)){
+		stream->next = head - span;
+		stream->pending = 0;
+		stream->overruns++;
+	}
+	return (head - stream->next >= (unsigned long) span);
+}
+
+/**
+ * @return 1 if the span samples from first on are all written and not being overwritten yet
+ */
+short streamHolds(const StreamEstimator* stream, unsigned long first, short span){
+	unsigned long head = STREAM_LOAD_ACQUIRE(&stream->head);
+
+	if(span < 0 || span > STREAM_RING)
+		return 0;
+	return (head - first >= (unsigned long) span) && (head - first <= (unsigned long) (STREAM_RING - span));
+}
+
+/**
+ * Takes the metric of one lag into the peak tracker
+ * @param position	stream position of the lag, lags come in rising order
+ * @param hit		1 if the metric is over the detection threshold
+ * @return 1 if the peak in peakPosition and peakMetric was confirmed on this lag
+ */
+short streamPeakUpdate(StreamEstimator* stream, unsigned long position, float metric, short hit){
+	if(hit && ((long) (position - stream->maskEnd) >= 0 || metric > stream->maskMetric)
+			&& (!stream->pending || metric > stream->peakMetric)){
+		stream->pending = 1;
+		stream->peakPosition = position;
+		stream->peakMetric = metric;
+		return 0;
+	}
+	if(stream->pending && position - stream->peakPosition >= stream->guard){
+		stream->pending = 0;
+		stream->maskEnd = stream->peakPosition + stream->reach;
+		stream->maskMetric = STREAM_SIDELOBE*stream->peakMetric;
+		stream->pulses++;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * A pulse was estimated and found valid, decides whether it is the reply the node is listening for: the first one
+ * that starts after its own pulse went out
+ * @param position	stream position of the pulse start
+ * @return 1 if it is
+ */
+short streamTakeReply(StreamEstimator* stream, unsigned long position){
+	unsigned long listenFrom = STREAM_LOAD_ACQUIRE(&stream->listenFrom);
+
+	if(listenFrom == stream->answered || (long) (position - listenFrom) < 0)
+		return 0;
+	stream->answered = listenFrom;
+	stream->replies++;
+	return 1;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file 	StreamEstimator.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the received sample stream and the pulse peak tracker in StreamEstimator.c
+ *
+ * The frame code writes every received sample into the ring with the clock it arrived on, the main loop runs the
+ * matched filter over it a block of lags at a time and hands each lag's metric to the peak tracker.
+ *
+ * Ordering: a sample and its stamp are written before head is published, the same way as in EventQueue.h. With GCC
+ * and Clang head and listenFrom are accessed with __atomic acquire/release, on the C6000 they are volatile.
+ */
+
+#ifndef STREAMESTIMATOR_H_
+#define STREAMESTIMATOR_H_
+
+#ifndef STREAM_RING
+#define STREAM_RING			4096		// received samples kept, a power of two. 0.5 s at 8 kHz.
+#endif
+#define STREAM_INDEX(pos)	((pos) & (STREAM_RING-1))
+#define STREAM_SIDELOBE		0.1f		// a pulse within the reach of the last one has to be this much of its metric,
+										// the matched filter's first sidelobe is at 0.05
+
+//Clock a sample arrived on
+typedef struct {
+	short clock;			// vclock label, counted like recbuf_start_clock (may be -1 on the wrap frame)
+	short launch;			// sinc_launch
+	unsigned short ticks;	// clock wraps so far
+} StreamStamp;
+
+typedef struct {
+	//frame code
+	short ring[STREAM_RING];			// received samples
+	StreamStamp stamp[STREAM_RING];
+	volatile unsigned long head;		// samples written so far
+	volatile unsigned long listenFrom;	// first sample after the node's own pulse went out
+	unsigned short ticks;				// clock wraps, stamped on each sample
+
+	//main loop
+	unsigned long next;					// first lag of the next block
+	unsigned long guard;				// lags after a peak without a higher one that confirm it
+	unsigned long reach;				// lags after a confirmed peak its sidelobes are masked for (2N)
+	short pending;						// a peak is waiting for its guard
+	unsigned long peakPosition;			// stream position of the pulse start at the peak
+	float peakMetric;
+	unsigned long maskEnd;				// sidelobes of the last confirmed peak until here
+	float maskMetric;
+	unsigned long answered;				// listenFrom of the last pulse taken as the reply
+	unsigned short lastTicks;			// ticks at the end of the last reply
+	unsigned long pulses;				// peaks confirmed
+	unsigned long replies;				// of them taken as the reply to the node's own pulse
+	unsigned long overruns;				// times the main loop fell a ring behind and skipped ahead
+	unsigned long latencyMax;			// most samples from a pulse start until its estimate
+} StreamEstimator;
+
+//Setup Functions
+void streamInit(StreamEstimator* stream, unsigned long guard, unsigned long reach);
+
+//Frame code
+void streamPush(StreamEstimator* stream, short sample, short clock, short launch);
+void streamListen(StreamEstimator* stream);
+
+//Main loop
+unsigned long streamWritten(const StreamEstimator* stream);
+short streamBlockReady(StreamEstimator* stream, short span);
+short streamHolds(const StreamEstimator* stream, unsigned long first, short span);
+short streamPeakUpdate(StreamEstimator* stream, unsigned long position, float metric, short hit);
+short streamTakeReply(StreamEstimator* stream, unsigned long position);
+
+
+#endif /* STREAMESTIMATOR_H_ */
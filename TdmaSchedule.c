@@ -0,0 +1,114 @@
+/**
+ * @file 	TdmaSchedule.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Slot arithmetic of the master's TDMA superframe and the per slot estimate history
+ *
+ * The master cannot tell slaves apart, a pulse belongs to the slot whose tick it is centred on. The history is kept
+ * by the main loop only, the frame code just says on which superframe tick a pulse arrived.
+ */
+
+#include <math.h>
+
+#include "TdmaSchedule.h"
+
+/**
+ * Forgets all slots, call before the superframe starts
+ */
+void tdmaInit(TdmaSlot slots[TDMA_SLOTS]){
+	short slot, h;
+
+	for(slot = 0; slot < TDMA_SLOTS; slot++){
+		slots[slot].pulses = 0;
+		slots[slot].replies = 0;
+		slots[slot].silent = 0;
+		slots[slot].lastSuperframe = 0;
+		for(h = 0; h < TDMA_HISTORY; h++){
+			slots[slot].arrival[h] = 0;
+			slots[slot].snr[h] = 0;
+		}
+		slots[slot].historyIndex = TDMA_HISTORY-1;
+		slots[slot].historyCount = 0;
+	}
+}
+
+/**
+ * Superframe tick the pulses of a slot are centred on, also the tick its slave sends its first pulse in
+ */
+short tdmaSlotTick(short slot){
+	return slot*TDMA_SLOT_TICKS;
+}
+
+/**
+ * Slot of a pulse centred on a superframe tick
+ * @param tick				0 to TDMA_SUPERFRAME_TICKS-1
+ * @param ticksFromSlot		set to the tick minus the slot tick, -1 to 1
+ * @return the slot, or TDMA_OFF_SLOT for a pulse that is more than a tick away from every slot tick
+ */
+short tdmaSlotOfTick(short tick, short* ticksFromSlot){
+	short slot = (tick + 1)/TDMA_SLOT_TICKS;		// tick -1 of a slot still counts
+	short offset = tick - tdmaSlotTick(slot);
+
+	if(slot >= TDMA_SLOTS)
+		slot = 0;		// the last tick of the superframe is tick -1 of slot 0
+	if(offset > 1)
+		return TDMA_OFF_SLOT;
+	*ticksFromSlot = offset;
+	return slot;
+}
+
+/**
+ * Adds the arrival of one pulse to its slot
+ * @param arrival	pulse centre minus the slot tick, samples
+ */
+void tdmaRecordArrival(TdmaSlot* slot, unsigned short superframe, float arrival, float snr){
+	slot->historyIndex++;
+	if(slot->historyIndex >= TDMA_HISTORY)
+		slot->historyIndex = 0;
+	slot->arrival[slot->historyIndex] = arrival;
+	slot->snr[slot->historyIndex] = snr;
+	if(slot->historyCount < TDMA_HISTORY)
+		slot->historyCount++;
+	slot->pulses++;
+	slot->lastSuperframe = superframe;
+}
+
+/**
+ * Counts the reply to the slot's newest pulse
+ * @param sent	0 if the pulse was too weak to reply to
+ */
+void tdmaRecordReply(TdmaSlot* slot, short sent){
+	if(sent)
+		slot->replies++;
+	else
+		slot->silent++;
+}
+
+/**
+ * Standard deviation of the newest arrivals, how steadily the slave of the slot holds its sync as seen from the
+ * master. Leave out the acquisition, the first arrivals of a slot are up to half a tick apart.
+ * @param count		arrivals to use, at most TDMA_HISTORY
+ * @return 0 with fewer than two arrivals
+ */
+float tdmaArrivalSpread(const TdmaSlot* slot, short count){
+	float mean = 0, var = 0, d;
+	short h, idx;
+
+	if(count > slot->historyCount)
+		count = slot->historyCount;
+	if(count < 2)
+		return 0;
+	idx = slot->historyIndex;
+	for(h = 0; h < count; h++){
+		mean += slot->arrival[idx];
+		idx = idx ? idx-1 : TDMA_HISTORY-1;
+	}
+	mean /= count;
+	idx = slot->historyIndex;
+	for(h = 0; h < count; h++){
+		d = slot->arrival[idx] - mean;
+		var += d*d;
+		idx = idx ? idx-1 : TDMA_HISTORY-1;
+	}
+	return (float) sqrt(var/(count - 1));
+}
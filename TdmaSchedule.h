@@ -0,0 +1,49 @@
+/**
+ * @file 	TdmaSchedule.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the master's slot table and the slot arithmetic of TdmaSchedule.c
+ *
+ * The master's superframe is TDMA_SLOTS slots of TDMA_SLOT_TICKS virtual clock ticks. The slave of slot k sends once
+ * per superframe. Once it is synced, its pulse is centred on master tick k*TDMA_SLOT_TICKS and the mirrored reply on
+ * the tick two later. A pulse one tick either side of the slot tick still belongs to the slot, because acquisition
+ * can settle the slave one tick off. With TDMA_SLOT_TICKS 5, even neighbours that are off in opposite directions do
+ * not overlap.
+ */
+
+#ifndef TDMASCHEDULE_H_
+#define TDMASCHEDULE_H_
+
+#ifndef TDMA_SLOTS
+#define TDMA_SLOTS			8		// slaves the master serves
+#endif
+#define TDMA_SLOT_TICKS		5		// pulse tick, reply two ticks later, a tick of slack on either side
+#define TDMA_SUPERFRAME_TICKS	(TDMA_SLOTS*TDMA_SLOT_TICKS)
+#define TDMA_HISTORY		16		// arrivals kept per slot
+#define TDMA_OFF_SLOT		(-1)	// a pulse between two slots
+
+typedef struct {
+	unsigned short pulses;			// pulses analysed in the slot
+	unsigned short replies;			// replies sent
+	unsigned short silent;			// pulses too weak to reply to (playback_scale 0)
+	unsigned short lastSuperframe;	// superframe of the newest pulse
+	float arrival[TDMA_HISTORY];	// pulse centre minus the slot tick, samples, the slave's offset plus the path
+	float snr[TDMA_HISTORY];		// SNR of the capture behind each arrival
+	short historyIndex;				// newest entry
+	short historyCount;
+} TdmaSlot;
+
+//Setup Functions
+void tdmaInit(TdmaSlot slots[TDMA_SLOTS]);
+
+//Slot arithmetic
+short tdmaSlotTick(short slot);
+short tdmaSlotOfTick(short tick, short* ticksFromSlot);
+
+//Slot history
+void tdmaRecordArrival(TdmaSlot* slot, unsigned short superframe, float arrival, float snr);
+void tdmaRecordReply(TdmaSlot* slot, short sent);
+float tdmaArrivalSpread(const TdmaSlot* slot, short count);
+
+
+#endif /* TDMASCHEDULE_H_ */
@@ -0,0 +1,115 @@
+/**
+ * @file 	WaveformBank.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Compressed bank of the modulated sinc pulse at delays of 0 to MAXDELAY-1 hundredths of a sample
+ *
+ * The pulse p_d[idx] = f(idx - d) is built from f(t) = cos(2*pi*CBW*t)*sinc(BW*t), which is even in t. So
+ *  - p_d[idx] = p_(1-d)[1-idx]: the pulse at delay 1-d is the time reverse of the pulse at delay d. This holds bit for
+ *    bit on the 16 bit table, only delays 0 to 0.5 are stored and the others are read backwards (one sample past
+ *    N is kept per row for that).
+ *  - p_d[-idx] ~ s(idx)*p_d[idx], with s = +1 for even and -1 for odd idx (the fs/4 carrier). The two sides only differ
+ *    by the slope of the sinc envelope times 2d. Next to the centre that is several hundred LSB, so the left half keeps
+ *    WAVEBANK_CORE_LEN samples at 16 bit and stores the rest as 8 bit residuals against the mirrored right half.
+ *
+ * Reads are exact as long as storeDelayedWaveformRow() returned 0 for every row. With WAVEBANK_PREBUILT the bank is
+ * not filled at boot, host/TableGen.c fills it on the host and writes it out as WaveformBankTable.h.
+ */
+
+#include "WaveformBank.h"
+
+//the bank still lives in SDRAM with the other large buffers
+#ifdef _TMS320C6X
+#pragma DATA_SECTION(bankRight,".mydata")
+#pragma DATA_SECTION(bankCore,".mydata")
+#pragma DATA_SECTION(bankTail,".mydata")
+#define BANK_FAR far
+#else
+#define BANK_FAR
+#endif
+
+#if (WAVEBANK_PREBUILT)
+#include "WaveformBankTable.h"		// bankRight, bankCore and bankTail as const data
+
+#if (WAVEBANK_TABLE_HALF_LEN != WAVEBANK_HALF_LEN || WAVEBANK_TABLE_RESOLUTION != WAVEBANK_RESOLUTION)
+#error "WaveformBankTable.h was generated for a different N or MAXDELAY"
+#endif
+
+/**
+ * Checks that the generated bank holds the pulse the node sends, instead of filling it with storeDelayedWaveformRow()
+ * @param sincBandwidth	bandwidth of the sinc pulse (BW)
+ * @param carrierFreq	carrier of the pulse
+ * @return 0 if WaveformBankTable.h was generated for this pulse, WAVEBANK_ROW_INPUT_LEN (no row fits) otherwise
+ */
+short prebuiltWaveformBankMisfits(double sincBandwidth, double carrierFreq){
+	if(sincBandwidth != WAVEBANK_TABLE_BW || carrierFreq != WAVEBANK_TABLE_CBW)
+		return WAVEBANK_ROW_INPUT_LEN;
+	return 0;
+}
+#else
+static BANK_FAR short bankRight[WAVEBANK_ROWS][WAVEBANK_HALF_LEN + 2];		// idx 0 to N+1
+static BANK_FAR short bankCore[WAVEBANK_ROWS][WAVEBANK_CORE_LEN];			// idx -1 to -CORE_LEN
+static BANK_FAR signed char bankTail[WAVEBANK_ROWS][WAVEBANK_TAIL_LEN];	// idx -(CORE_LEN+1) to -N
+
+/**
+ * Stores one row of the bank
+ * @param row		delay in units of 1/WAVEBANK_RESOLUTION, 0 to WAVEBANK_RESOLUTION/2
+ * @param paddedRow	the pulse from -(N+1) to N+1 (e.g. setupTransmitBuffer(paddedRow, N+1, ...)), centre at paddedRow[N+1]
+ * @return number of samples that do not fit the bank format, 0 if the row reads back exactly
+ */
+short storeDelayedWaveformRow(short row, const short* paddedRow){
+	const short* centre = paddedRow + WAVEBANK_HALF_LEN + 1;
+	short idx, misfits = 0;
+	int residual;
+
+	if(row < 0 || row >= WAVEBANK_ROWS)
+		return WAVEBANK_ROW_INPUT_LEN;
+
+	for(idx = 0; idx <= WAVEBANK_HALF_LEN + 1; idx++)
+		bankRight[row][idx] = centre[idx];
+
+	for(idx = 1; idx <= WAVEBANK_CORE_LEN; idx++)
+		bankCore[row][idx - 1] = centre[-idx];
+
+	for(idx = WAVEBANK_CORE_LEN + 1; idx <= WAVEBANK_HALF_LEN; idx++){
+		residual = (idx & 1) ? centre[-idx] + centre[idx] : centre[-idx] - centre[idx];
+		if(residual > 127){
+			residual = 127;
+			misfits++;
+		}else if(residual < -128){
+			residual = -128;
+			misfits++;
+		}
+		bankTail[row][idx - WAVEBANK_CORE_LEN - 1] = (signed char)residual;
+	}
+
+	return misfits;
+}
+#endif
+
+/**
+ * Reads one sample of a delayed pulse, replaces allMyDelayedWaveforms[index][i + N]
+ * @param index	delay in units of 1/WAVEBANK_RESOLUTION, 0 to WAVEBANK_RESOLUTION-1
+ * @param i		sample index, -N to N
+ * @return the pulse sample
+ */
+short delayedWaveformSample(short index, short i){
+	short row = index;
+	short idx = i;
+
+	if(index > WAVEBANK_RESOLUTION/2){
+		row = WAVEBANK_RESOLUTION - index;	// delay 1-d read backwards
+		idx = 1 - i;
+	}
+
+	if(idx >= 0)
+		return bankRight[row][idx];
+
+	idx = -idx;
+	if(idx <= WAVEBANK_CORE_LEN)
+		return bankCore[row][idx - 1];
+
+	if(idx & 1)
+		return bankTail[row][idx - WAVEBANK_CORE_LEN - 1] - bankRight[row][idx];
+	return bankTail[row][idx - WAVEBANK_CORE_LEN - 1] + bankRight[row][idx];
+}
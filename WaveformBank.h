@@ -0,0 +1,50 @@
+/**
+ * @file 	WaveformBank.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the compressed bank of delayed modulated sinc pulses in WaveformBank.c
+ *
+ * Drop-in for the allMyDelayedWaveforms[MAXDELAY][N2] table: delayedWaveformSample(index, i) returns exactly
+ * allMyDelayedWaveforms[index][i + N].
+ *
+ * Memory with N = 512, MAXDELAY = 100:
+ *  - full table:	100 rows * 1025 shorts					= 205000 bytes
+ *  - bank:			51 rows * (514 + 192 shorts + 320 bytes)	=  88332 bytes (43%, 35% of the samples kept at 16 bit)
+ *
+ * The bank is only exact at the fs/4 carrier (CBW 0.25). At any other carrier about a quarter of the samples do not
+ * fit, storeDelayedWaveformRow() counts them and the slave synthesizes its clock sinc instead. host/KernelCheck.c
+ * (bank) checks the bank against the formula.
+ */
+
+#ifndef WAVEFORMBANK_H_
+#define WAVEFORMBANK_H_
+
+//must match N and MAXDELAY of the pulses stored in the bank
+#define WAVEBANK_HALF_LEN 512
+#define WAVEBANK_RESOLUTION 100
+
+//If the bank is the const data host/TableGen.c generated into WaveformBankTable.h instead of being filled at boot
+#ifndef WAVEBANK_PREBUILT
+#define WAVEBANK_PREBUILT 0
+#endif
+
+#define WAVEBANK_ROWS (WAVEBANK_RESOLUTION/2 + 1)				// delays 0 to 0.5, the rest are mirrored
+#define WAVEBANK_CORE_LEN 192									// left half samples next to the centre kept at 16 bit
+#define WAVEBANK_TAIL_LEN (WAVEBANK_HALF_LEN - WAVEBANK_CORE_LEN)	// left half samples kept as 8 bit residuals
+#define WAVEBANK_ROW_INPUT_LEN (2*WAVEBANK_HALF_LEN + 3)		// one pulse from -(N+1) to N+1
+
+#define WAVEBANK_BYTES ((long)WAVEBANK_ROWS*((WAVEBANK_HALF_LEN + 2 + WAVEBANK_CORE_LEN)*sizeof(short) + WAVEBANK_TAIL_LEN))
+#define WAVEBANK_FULL_TABLE_BYTES ((long)WAVEBANK_RESOLUTION*(2*WAVEBANK_HALF_LEN + 1)*sizeof(short))
+
+//Setup Functions
+#if (WAVEBANK_PREBUILT)
+short prebuiltWaveformBankMisfits(double sincBandwidth, double carrierFreq);
+#else
+short storeDelayedWaveformRow(short row, const short* paddedRow);
+#endif
+
+//Read functions
+short delayedWaveformSample(short index, short i);
+
+
+#endif /* WAVEFORMBANK_H_ */
@@ -0,0 +1,326 @@
+/**
+ * @file 	CaptureAnalyzer.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Offline analyzer: the node's search, capture and delay estimate over a long recording, on all cores
+ *
+ * For field issues: the codec input recorded as a raw stereo file (the SampleIOHost.c format, the RECEIVE_SINC channel
+ * is analysed) goes through the node's own kernels, runSearchCorrelator() and takeSearchWindow() for the search and
+ * the capture, then runReceivedPulseBufferDownmixing(), runReceviedSincPulseTimingAnalysis() and
+ * estimateCaptureSnr(), on a NodeContext per worker thread. The node source is compiled into this file, like into
+ * host/KernelBench.c, so N, M and the USE_ switches come from the compiler command line and match the node build.
+ *
+ * The recording is cut into chunks that the workers take in turn. A worker starts searching a capture length plus a
+ * window before its chunk (with CFAR 16 floor lengths more), so its search is in step with a run over the whole file
+ * by the time the chunk starts, and it reports the captures that trigger inside the chunk. The merge puts the chunks
+ * back in order and drops a capture that triggered during the one before it, which is the previous worker's. So the
+ * pulses are the ones a single worker finds (-chunk 0), unless two pulses come closer than a capture length at a
+ * chunk border. The CFAR floor is only that close to the single worker's, a trigger may come a few samples later, the
+ * estimate of the pulse is the same.
+ * Unlike the node, the search starts again right after each capture, there is no reply to wait for.
+ *
+ * The clock is the node's as if it had started on the first sample of the file: sample idx is at clock idx+1, so a
+ * capture starts at the file index recbuf_start_clock. Per pulse the csv has
+ *   pulse, trigger (file index), capture start, corr_max_lag, coarse (capture start + lag), fine (the same with the
+ *   carrier phase, fine_delay_estimate), clock (fine modulo VCLK_MAX), snr, valid (snr >= CFAR_VALID_SNR),
+ *   fine_peak_disagreement, max_recbuf
+ *
+ * Build and run from the project root, for example:
+ *   gcc -O2 -pthread -DSAMPLEIO_HOST_NO_MAIN -I. host/CaptureAnalyzer.c host/SampleIOHost.c CycleProfiler.c
+ *       EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c CorrelatorBank.c FastCorrelation.c PhaseEstimation.c
+ *       PulseScheduler.c PulseSynthesis.c TdmaSchedule.c WaveformBank.c -lm -o capanalyze
+ *   ./capanalyze capture.raw pulses.csv [-threads n] [-chunk seconds] [-carrier f]
+ */
+
+#include "time_stamper_master.c"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if (USE_FDM_BANK)
+#error "the analyzer searches one carrier, build it without USE_FDM_BANK and pick the channel with -carrier"
+#endif
+#if (USE_FFT_CORRELATOR)
+#error "the FFT matched filter works in one shared buffer (FastCorrelation.c), the workers would overwrite it"
+#endif
+
+#define ANALYZER_FS				8000		// samples per second
+#define ANALYZER_MAX_THREADS	64
+#define ANALYZER_CHUNK_S		60.0		// default chunk length
+#define ANALYZER_CAPTURE		(2*N+2*M)
+#if (USE_CFAR_THRESHOLD)
+#define ANALYZER_LEAD_IN		(ANALYZER_CAPTURE + M + 16*CFAR_FLOOR_SAMPLES)	// the floor forgets all but e^-16
+#else
+#define ANALYZER_LEAD_IN		(ANALYZER_CAPTURE + M)
+#endif
+
+typedef struct {
+	long long trigger;			// file index of the sample that started the capture
+	long long start;			// file index of recbuf[0]
+	short lag;					// corr_max_lag
+	double fine;				// file index of the pulse start, with the carrier phase
+	float snr;
+	float disagreement;			// fine_peak_disagreement
+	short peak;					// max_recbuf
+} AnalyzedPulse;
+
+typedef struct {
+	AnalyzedPulse* pulses;		// in the order they triggered
+	long count;
+	long size;
+	long cutOff;				// captures the end of the file cut short
+} ChunkResult;
+
+static const short* analyzerIn;		// the recording, mapped
+static long long analyzerFrames;
+static long long analyzerChunkFrames;
+static long analyzerChunks;
+static long analyzerNextChunk = 0;	// next chunk a worker takes
+static ChunkResult* analyzerResults;
+static pthread_mutex_t analyzerLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void analyzerAdd(ChunkResult* result, const AnalyzedPulse* pulse){
+	if(result->count == result->size){
+		result->size = result->size ? 2*result->size : 64;
+		result->pulses = (AnalyzedPulse*) realloc(result->pulses, result->size*sizeof(AnalyzedPulse));
+		if(result->pulses == NULL){
+			printf("ERROR: out of memory\n");
+			exit(1);
+		}
+	}
+	result->pulses[result->count++] = *pulse;
+}
+
+/**
+ * Searches, captures and estimates over one chunk
+ * @param node	the worker's context
+ */
+static void analyzeChunk(NodeContext* node, long chunk, ChunkResult* result){
+	long long first = chunk*analyzerChunkFrames;
+	long long end = first + analyzerChunkFrames;
+	long long idx = first - ANALYZER_LEAD_IN;
+	AnalyzedPulse pulse;
+	capture_t sample;
+	short onCarrier, hit, tap;
+#if (USE_CFAR_THRESHOLD)
+	CfarDetector cfar;
+#endif
+
+	if(end > analyzerFrames)
+		end = analyzerFrames;
+	if(idx < 0)
+		idx = 0;
+
+	nodeContextInit(node);
+#if (USE_NCO_DOWNMIX)
+	node->searchNco.phase = (unsigned int)(node->searchNco.step*(unsigned long long) idx);	// free running from idx 0
+#endif
+#if (USE_CFAR_THRESHOLD)
+	cfarInit(&cfar, CFAR_FALSE_ALARM, M);
+#endif
+
+	while(idx < end){
+		sample = (capture_t) analyzerIn[idx*FRAME_CHANNELS + RECEIVE_SINC];
+		onCarrier = runSearchCorrelator(node, sample, (char)((idx + 1) & 3));
+#if (USE_CFAR_THRESHOLD)
+		hit = cfarTest(&cfar, (float) node->corrSumIncoherent) && onCarrier;
+#else
+		hit = (node->corrSumIncoherent>T1) && onCarrier;
+#endif
+		idx++;
+		if(!hit)
+			continue;
+
+		// the capture, as runSearchingStateCodeISR() and runRecordingStateCodeISR() take it
+		pulse.trigger = idx - 1;
+		pulse.start = idx - CAPTURE_LEAD;
+		takeSearchWindow(node, node->recbuf);
+#if (USE_CFAR_THRESHOLD)
+		cfar.triggers++;
+		cfarRestart(&cfar);
+#endif
+		if(pulse.start + ANALYZER_CAPTURE > analyzerFrames){
+			if(pulse.trigger >= first)
+				result->cutOff++;
+			break;
+		}
+		node->max_recbuf = 0;
+		for(tap = CAPTURE_LEAD; tap < ANALYZER_CAPTURE; tap++){
+			node->recbuf[tap] = (capture_t) analyzerIn[(pulse.start + tap)*FRAME_CHANNELS + RECEIVE_SINC];
+			if(abs(node->recbuf[tap]) > node->max_recbuf)
+				node->max_recbuf = abs(node->recbuf[tap]);
+		}
+		idx = pulse.start + ANALYZER_CAPTURE;
+
+		// the estimate, as nodeBackgroundTask() runs it. The start clock only keeps the carrier phase, so the float
+		// estimate stays small and exact.
+		node->recbuf_start_clock = (short)(pulse.start & 3);
+#if (!USE_FUSED_DOWNMIX)
+		runReceivedPulseBufferDownmixing(node);
+#endif
+		runReceviedSincPulseTimingAnalysis(node);
+		pulse.snr = estimateCaptureSnr(node);
+#if (USE_CFAR_THRESHOLD)
+		cfarValidate(&cfar, pulse.snr);
+#endif
+		if(pulse.trigger < first)
+			continue;		// the previous chunk's
+		pulse.lag = node->corr_max_lag;
+		pulse.fine = pulse.start + (node->fine_delay_estimate[node->fde_index] - node->recbuf_start_clock);
+		pulse.disagreement = node->fine_peak_disagreement;
+		pulse.peak = node->max_recbuf;
+		analyzerAdd(result, &pulse);
+	}
+}
+
+static void* analyzerWorker(void* arg){
+	NodeContext* node = (NodeContext*) malloc(sizeof(NodeContext));
+	long chunk;
+
+	(void) arg;
+	if(node == NULL){
+		printf("ERROR: out of memory\n");
+		exit(1);
+	}
+	for(;;){
+		pthread_mutex_lock(&analyzerLock);
+		chunk = analyzerNextChunk++;
+		pthread_mutex_unlock(&analyzerLock);
+		if(chunk >= analyzerChunks)
+			break;
+		analyzeChunk(node, chunk, &analyzerResults[chunk]);
+	}
+	free(node);
+	return NULL;
+}
+
+static double analyzerNowS(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void analyzerUsage(const char* name){
+	printf("usage: %s capture.raw pulses.csv [options]\n", name);
+	printf("  -threads n     worker threads (all cores)\n");
+	printf("  -chunk s       seconds of audio per chunk, 0 for one chunk (%.0f)\n", ANALYZER_CHUNK_S);
+#if (USE_NCO_DOWNMIX)
+	printf("  -carrier f     carrier to search, cycles per sample (CBW)\n");
+#endif
+}
+
+int main(int argc, char** argv){
+	pthread_t workers[ANALYZER_MAX_THREADS];
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+	double chunkSeconds = ANALYZER_CHUNK_S;
+	double started, wall, seconds;
+	long long lastEnd = -1;
+	long chunk, p, pulses = 0, valid = 0, merged = 0, cutOff = 0;
+	const AnalyzedPulse* pulse;
+	struct stat st;
+	FILE* csv;
+	int fd, a;
+
+	if(argc < 3){
+		analyzerUsage(argv[0]);
+		return 1;
+	}
+	for(a = 3; a + 1 < argc; a += 2){
+		if(strcmp(argv[a], "-threads") == 0)			threads = atol(argv[a+1]);
+		else if(strcmp(argv[a], "-chunk") == 0)		chunkSeconds = atof(argv[a+1]);
+#if (USE_NCO_DOWNMIX)
+		else if(strcmp(argv[a], "-carrier") == 0)		carrier_freq = atof(argv[a+1]);
+#endif
+		else{
+			analyzerUsage(argv[0]);
+			return 1;
+		}
+	}
+	if(a < argc){
+		analyzerUsage(argv[0]);
+		return 1;
+	}
+	if(threads < 1)
+		threads = 1;
+	if(threads > ANALYZER_MAX_THREADS)
+		threads = ANALYZER_MAX_THREADS;
+
+	fd = open(argv[1], O_RDONLY);
+	if(fd < 0 || fstat(fd, &st) != 0){
+		printf("ERROR: cannot open %s\n", argv[1]);
+		return 1;
+	}
+	analyzerFrames = st.st_size/(FRAME_CHANNELS*sizeof(short));
+	if(analyzerFrames == 0){
+		printf("ERROR: %s holds no frames\n", argv[1]);
+		return 1;
+	}
+	analyzerIn = (const short*) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(analyzerIn == MAP_FAILED){
+		printf("ERROR: cannot map %s\n", argv[1]);
+		return 1;
+	}
+	csv = fopen(argv[2], "w");
+	if(csv == NULL){
+		printf("ERROR: cannot open %s\n", argv[2]);
+		return 1;
+	}
+
+	analyzerChunkFrames = (long long)(chunkSeconds*ANALYZER_FS);
+	if(analyzerChunkFrames <= 0 || analyzerChunkFrames > analyzerFrames)
+		analyzerChunkFrames = analyzerFrames;
+	analyzerChunks = (long)((analyzerFrames + analyzerChunkFrames - 1)/analyzerChunkFrames);
+	analyzerResults = (ChunkResult*) calloc(analyzerChunks, sizeof(ChunkResult));
+	if(analyzerResults == NULL){
+		printf("ERROR: out of memory\n");
+		return 1;
+	}
+	if(threads > analyzerChunks)
+		threads = analyzerChunks;
+
+	nodeInit();		// the node's tables, the workers only read them
+
+	started = analyzerNowS();
+	for(a = 0; a < threads; a++)
+		pthread_create(&workers[a], NULL, analyzerWorker, NULL);
+	for(a = 0; a < threads; a++)
+		pthread_join(workers[a], NULL);
+	wall = analyzerNowS() - started;
+
+	fprintf(csv, "pulse,trigger,capture_start,lag,coarse,fine,clock,snr,valid,disagreement,peak\n");
+	for(chunk = 0; chunk < analyzerChunks; chunk++){
+		for(p = 0; p < analyzerResults[chunk].count; p++){
+			pulse = &analyzerResults[chunk].pulses[p];
+			if(pulse->trigger < lastEnd){
+				merged++;		// triggered during the previous chunk's last capture
+				continue;
+			}
+			lastEnd = pulse->start + ANALYZER_CAPTURE;
+			fprintf(csv, "%ld,%lld,%lld,%d,%lld,%.4f,%.4f,%.1f,%d,%.4f,%d\n", pulses, pulse->trigger, pulse->start,
+					pulse->lag, pulse->start + pulse->lag, pulse->fine, fmod(pulse->fine, VCLK_MAX), pulse->snr,
+					pulse->snr >= CFAR_VALID_SNR, pulse->disagreement, pulse->peak);
+			pulses++;
+			valid += (pulse->snr >= CFAR_VALID_SNR);
+		}
+		cutOff += analyzerResults[chunk].cutOff;
+		free(analyzerResults[chunk].pulses);
+	}
+	fclose(csv);
+
+	seconds = (double) analyzerFrames/ANALYZER_FS;
+	printf("%s: %.1f s, %lld frames, %ld chunks on %ld threads, carrier %.4f\n", argv[1], seconds, analyzerFrames,
+			analyzerChunks, threads, carrier_freq);
+	printf("pulses:  %ld, %ld of them with SNR >= %.0f, %ld dropped in the merge, %ld cut off by the end of the file\n",
+			pulses, valid, (double) CFAR_VALID_SNR, merged, cutOff);
+	printf("wall:    %.2f s, %.0fx real time\n", wall, wall > 0 ? seconds/wall : 0.0);
+
+	free(analyzerResults);
+	munmap((void*) analyzerIn, st.st_size);
+	close(fd);
+	return 0;
+}
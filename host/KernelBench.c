@@ -0,0 +1,371 @@
+/**
+ * @file 	KernelBench.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Host microbenchmarks for the node's DSP kernels on synthetic pulses
+ *
+ * The kernels work on a node context of their own and on the node's tables, so the node source is compiled into this
+ * file. N, M and the USE_ switches come from the compiler command line, one binary per configuration, and every run
+ * appends its rows to a csv file:
+ *   kernel, configuration (N, M, switches), calls, samples per call, ns/call, samples/s, cycles/sample, carrier,
+ *   FDM channels, adaptive threshold
+ * ns/call is the fastest of BENCH_REPEATS timed runs. Cycles are read from the x86 time stamp counter, which counts
+ * at the nominal clock rate, and are -1 on hosts without one.
+ *
+ * Build and run one configuration from the project root:
+ *   gcc -O2 -DN=512 -DM=60 -DSAMPLEIO_HOST_NO_MAIN -I. host/KernelBench.c host/SampleIOHost.c CycleProfiler.c
+ *       EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c CorrelatorBank.c FastCorrelation.c
+ *       PhaseEstimation.c PulseScheduler.c PulseSynthesis.c TdmaSchedule.c WaveformBank.c -lm -o kernelbench
+ *   ./kernelbench bench.csv
+ * host/bench.sh runs all the N, M and switch configurations into one csv file.
+ * The downmix row only exists with USE_FUSED_DOWNMIX 0, the fused matched filter has no separate downmix. With
+ * USE_NCO_DOWNMIX the search triggers on every carrier phase instead of one in four, so the search row also counts
+ * more recording starts while the synthetic pulse passes.
+ *
+ * The fdm_search_bank row is the searching correlation of the frequency division bank on all FDM_CHANNELS carriers,
+ * with its own bank so it exists in every configuration. host/bench.sh builds it for 1 to 16 channels and prints the
+ * cost of a channel, the slope of the row over FDM_CHANNELS. With -DUSE_CFAR_THRESHOLD=1 the search row includes the
+ * noise floor update.
+ *
+ * The pulse_mix row is one frame of the output pulse scheduler with two or three pulses on, the work a transmission
+ * costs the frame code now that it is no longer copied into an output ring. The delayed_pulse row is a whole fine
+ * delayed pulse through the scheduler like the slave's clock sinc, started and generated by its pulse source (the
+ * synthesizer, or the waveform bank with USE_PULSE_SYNTH 0).
+ */
+
+#include "time_stamper_master.c"
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+#define BENCH_REPEATS		5
+#define BENCH_MIN_MS		20			// default shortest timed run
+#define BENCH_STREAM_LEN	4096		// synthetic input for the per sample kernels
+#define BENCH_PHASES		1024		// correlator outputs for the phase estimators
+#define BENCH_PULSE_DELAY	0.37		// fractional delay of the synthetic pulse
+#define BENCH_PULSE_AMP		16000.0
+#define BENCH_NOISE_AMP		4.0
+
+typedef void (*BenchBody)(long calls);
+
+static short benchStream[BENCH_STREAM_LEN*FRAME_CHANNELS];
+static float benchPhaseSin[BENCH_PHASES];
+static float benchPhaseCos[BENCH_PHASES];
+static volatile float benchSink;		// keeps the phase estimates from being optimized away
+static unsigned int benchNoiseState = 12345;
+static FdmSearchBank benchBank;
+static float benchBankCos[M*FDM_CHANNELS];
+static float benchBankSin[M*FDM_CHANNELS];
+static volatile unsigned int benchHits;	// same for the bank's hits
+static NodeContext benchNode;			// the kernels' state, apart from node_context
+static PulseScheduler benchPulses;		// overlapping pulses for the mix, apart from pulse_scheduler
+static short benchFrame[FRAME_CHANNELS];
+static PulseScheduler benchDelayedPulses;	// the delayed pulse on its own
+#if (USE_PULSE_SYNTH)
+static PulseSynth benchSynth;
+#else
+static short benchRow = (short)(BENCH_PULSE_DELAY*MAXDELAY + 0.5);
+#if (!SLAVE_ROLE && !WAVEBANK_PREBUILT)
+static short benchRowBuffer[WAVEBANK_ROW_INPUT_LEN];	// only a slave fills the bank for its clock sinc
+#endif
+#endif
+
+/**
+ * Uniform noise in -amp to amp, fixed sequence
+ */
+static double benchNoise(double amp){
+	benchNoiseState = benchNoiseState*1664525u + 1013904223u;
+	return amp*((double)(benchNoiseState >> 8)/8388608.0 - 1.0);
+}
+
+/**
+ * Modulated sinc pulse starting at sample start, with the fractional delay, into a float buffer
+ */
+static void benchPulse(float* out, long len, long start, double delay){
+	long idx;
+	double u;
+
+	for(idx = 0; idx < len; idx++){
+		u = idx - start - N - delay;
+		out[idx] = (float) benchNoise(BENCH_NOISE_AMP);
+		if(u >= -N && u <= N)
+			out[idx] += (float)(BENCH_PULSE_AMP*cos(2*PI*CBW*u)*((u != 0) ? sin(PI*BW*u)/(PI*BW*u) : 1.0));
+	}
+}
+
+static void benchFillInputs(){
+	static float stream[BENCH_STREAM_LEN];
+	float pulse[2*N+2*M];
+	long idx;
+	double angle;
+
+	//a pulse now and then in low noise, so the search also takes its trigger path
+	benchPulse(stream, BENCH_STREAM_LEN, BENCH_STREAM_LEN/4, BENCH_PULSE_DELAY);
+	for(idx = 0; idx < BENCH_STREAM_LEN; idx++)
+		benchStream[idx*FRAME_CHANNELS + RECEIVE_SINC] = (short) stream[idx];
+
+	//recbuf as the recording state leaves it, the pulse start sits a little after lag M
+	benchPulse(pulse, 2*N+2*M, M+3, BENCH_PULSE_DELAY);
+	for(idx = 0; idx < 2*N+2*M; idx++)
+		benchNode.recbuf[idx] = (capture_t) pulse[idx];
+
+	for(idx = 0; idx < BENCH_PHASES; idx++){
+		angle = 2*PI*idx/BENCH_PHASES - PI;
+		benchPhaseSin[idx] = (float)(1e6*sin(angle));
+		benchPhaseCos[idx] = (float)(1e6*cos(angle));
+	}
+}
+
+//Kernel bodies
+
+static void benchSearch(long calls){
+	long c;
+
+	for(c = 0; c < calls; c++){
+		frameIn = &benchStream[(c & (BENCH_STREAM_LEN-1))*FRAME_CHANNELS];
+		local_carrier_phase = (char)(c & 3);
+		runSearchingStateCodeISR(&benchNode);
+	}
+}
+
+static void benchFdmSearch(long calls){
+	unsigned int hits = 0;
+	long c;
+
+	for(c = 0; c < calls; c++)
+		hits |= fdmSearchSample(&benchBank, benchStream[(c & (BENCH_STREAM_LEN-1))*FRAME_CHANNELS + RECEIVE_SINC], T1);
+	benchHits = hits;
+}
+
+#if (!USE_FUSED_DOWNMIX)
+static void benchDownmix(long calls){
+	long c;
+
+	for(c = 0; c < calls; c++)
+		runReceivedPulseBufferDownmixing(&benchNode);
+}
+#endif
+
+static void benchMatchedFilter(long calls){
+	long c;
+
+	for(c = 0; c < calls; c++){
+#if (!USE_FUSED_DOWNMIX)
+		runReceivedPulseBufferDownmixing(&benchNode);
+#endif
+		runReceviedSincPulseTimingAnalysis(&benchNode);
+	}
+}
+
+static void benchSetupTransmitBuffer(long calls){
+	long c;
+
+	for(c = 0; c < calls; c++)
+		setupTransmitBuffer(delayedWaveformBuffer, N, BW, CBW, BENCH_PULSE_DELAY);
+}
+
+static void benchPulseMix(long calls){
+	long c;
+
+	for(c = 0; c < calls; c++){
+		if(benchPulses.now % N == 0)	// a new pulse every N frames, two or three are always on
+			pulseSchedule(&benchPulses, benchPulses.now, tModulatedSincPulse, OUTPUT_BUF_SIZE, PULSE_UNITY_GAIN,
+					TRANSMIT_SINC);
+		benchFrame[TRANSMIT_SINC] = 0;
+		pulseSchedulerMix(&benchPulses, benchFrame);
+	}
+	benchSink = benchFrame[TRANSMIT_SINC];
+}
+
+#if (!USE_PULSE_SYNTH && !SLAVE_ROLE && !WAVEBANK_PREBUILT)
+/**
+ * Fills the waveform bank like a slave's nodeInit()
+ */
+static void benchFillBank(){
+	short row;
+
+	for(row = 0; row < WAVEBANK_ROWS; row++){
+		setupTransmitBuffer(benchRowBuffer, N+1, BW, CBW, ((double) row) / MAXDELAY);
+		storeDelayedWaveformRow(row, benchRowBuffer);
+	}
+}
+#endif
+
+/**
+ * PulseSource of the delayed pulse, like the slave's clockSincSynthSample() or clockSincBankSample()
+ */
+static short benchDelayedSample(void* pulse, short offset){
+#if (USE_PULSE_SYNTH)
+	(void) offset;
+	return nextDelayedPulseSample((PulseSynth*) pulse);
+#else
+	return delayedWaveformSample(*(short*) pulse, offset - N);
+#endif
+}
+
+static void benchDelayedPulse(long calls){
+	long c;
+	short s;
+
+	for(c = 0; c < calls; c++){
+#if (USE_PULSE_SYNTH)
+		startDelayedPulse(&benchSynth, N, BW, CBW, BENCH_PULSE_DELAY);
+		pulseScheduleSource(&benchDelayedPulses, benchDelayedPulses.now, benchDelayedSample, &benchSynth,
+				OUTPUT_BUF_SIZE, PULSE_UNITY_GAIN, TRANSMIT_CLOCK);
+#else
+		pulseScheduleSource(&benchDelayedPulses, benchDelayedPulses.now, benchDelayedSample, &benchRow,
+				OUTPUT_BUF_SIZE, PULSE_UNITY_GAIN, TRANSMIT_CLOCK);
+#endif
+		for(s = 0; s < OUTPUT_BUF_SIZE; s++){
+			benchFrame[TRANSMIT_CLOCK] = 0;
+			pulseSchedulerMix(&benchDelayedPulses, benchFrame);
+		}
+	}
+	benchSink = benchFrame[TRANSMIT_CLOCK];
+}
+
+static void benchPhaseFast(long calls){
+	long c;
+	float acc = 0;
+
+	for(c = 0; c < calls; c++)
+		acc += carrierPhaseToSampleOffset(benchPhaseSin[c & (BENCH_PHASES-1)], benchPhaseCos[c & (BENCH_PHASES-1)]);
+	benchSink = acc;
+}
+
+static void benchPhaseLibm(long calls){
+	long c;
+	double acc = 0;
+
+	for(c = 0; c < calls; c++)
+		acc += atan2((double) benchPhaseSin[c & (BENCH_PHASES-1)], (double) benchPhaseCos[c & (BENCH_PHASES-1)])*2*INVPI;
+	benchSink = (float) acc;
+}
+
+//Timing
+
+static double benchNowNs(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static unsigned long long benchTicks(){
+#if (BENCH_HAVE_TSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Times a kernel and appends its row
+ * @param name				kernel name in the csv
+ * @param body				runs the kernel a given number of times
+ * @param samplesPerCall	samples one call handles, for samples/s and cycles/sample
+ */
+static void benchKernel(FILE* csv, const char* name, BenchBody body, long samplesPerCall, double minMs){
+	long calls = 1;
+	double start, elapsed, bestNs = 0;
+	unsigned long long ticks, bestTicks = 0;
+	short r;
+
+	//warm up and find a call count that runs for at least minMs
+	while(1){
+		start = benchNowNs();
+		body(calls);
+		elapsed = benchNowNs() - start;
+		if(elapsed >= minMs*1e6 || calls >= (1L<<40))
+			break;
+		calls *= 2;
+	}
+
+	for(r = 0; r < BENCH_REPEATS; r++){
+		ticks = benchTicks();
+		start = benchNowNs();
+		body(calls);
+		elapsed = benchNowNs() - start;
+		ticks = benchTicks() - ticks;
+		if(r == 0 || elapsed < bestNs){
+			bestNs = elapsed;
+			bestTicks = ticks;
+		}
+	}
+
+	fprintf(csv, "%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%ld,%ld,%.3f,%.0f,%.3f,%d,%g,%d,%d\n", name, N, M, USE_FUSED_DOWNMIX,
+			USE_SLIDING_DETECTOR, USE_FFT_CORRELATOR, USE_HIERARCHICAL_LAG_SEARCH, USE_FIXED_POINT, USE_FAST_ATAN2,
+			USE_PULSE_SYNTH, calls, samplesPerCall, bestNs/calls, samplesPerCall*calls/(bestNs*1e-9),
+			BENCH_HAVE_TSC ? (double) bestTicks/((double) calls*samplesPerCall) : -1.0, USE_NCO_DOWNMIX, CBW,
+			FDM_CHANNELS, USE_CFAR_THRESHOLD);
+	printf("%-24s %12.1f ns/call %14.0f samples/s %10.2f cycles/sample\n", name, bestNs/calls,
+			samplesPerCall*calls/(bestNs*1e-9), BENCH_HAVE_TSC ? (double) bestTicks/((double) calls*samplesPerCall) : -1.0);
+}
+
+int main(int argc, char** argv){
+	FILE* csv;
+	double minMs = BENCH_MIN_MS;
+	float fineError;
+
+	if(argc < 2){
+		printf("usage: %s results.csv [shortest timed run in ms]\n", argv[0]);
+		return 1;
+	}
+	if(argc > 2)
+		minMs = atof(argv[2]);
+
+	csv = fopen(argv[1], "a");
+	if(csv == NULL){
+		printf("ERROR: cannot open %s\n", argv[1]);
+		return 1;
+	}
+	fseek(csv, 0, SEEK_END);
+	if(ftell(csv) == 0)
+		fprintf(csv, "kernel,N,M,fused_downmix,sliding_detector,fft_correlator,hierarchical_lag_search,fixed_point,"
+				"fast_atan2,pulse_synth,calls,samples_per_call,ns_per_call,samples_per_s,cycles_per_sample,nco_downmix,"
+				"carrier,fdm_channels,cfar_threshold\n");
+
+	nodeInit();
+	nodeContextInit(&benchNode);
+	pulseSchedulerInit(&benchPulses);
+	pulseSchedulerInit(&benchDelayedPulses);
+#if (!USE_PULSE_SYNTH && !SLAVE_ROLE && !WAVEBANK_PREBUILT)
+	benchFillBank();
+#endif
+	benchFillInputs();
+	fdmSearchInit(&benchBank, CBW, benchBankCos, benchBankSin, M, M>>1);
+
+	//the matched filter has to find the synthetic pulse, or the numbers are for the wrong code path
+	benchNode.recbuf_start_clock = 0;
+#if (!USE_FUSED_DOWNMIX)
+	runReceivedPulseBufferDownmixing(&benchNode);
+#endif
+	runReceviedSincPulseTimingAnalysis(&benchNode);
+	fineError = benchNode.fine_delay_estimate[benchNode.fde_index] - (M + 3 + BENCH_PULSE_DELAY);
+	printf("N %d, M %d: pulse at %.2f, estimate %.4f\n", N, M, M + 3 + BENCH_PULSE_DELAY,
+			benchNode.fine_delay_estimate[benchNode.fde_index]);
+	if(fineError > 0.05 || fineError < -0.05){
+		printf("ERROR: the matched filter missed the synthetic pulse\n");
+		fclose(csv);
+		return 1;
+	}
+
+	benchKernel(csv, "search_correlator", benchSearch, 1, minMs);
+	benchKernel(csv, "fdm_search_bank", benchFdmSearch, 1, minMs);
+#if (!USE_FUSED_DOWNMIX)
+	benchKernel(csv, "downmix", benchDownmix, 2*N+2*M, minMs);
+#endif
+	benchKernel(csv, "matched_filter", benchMatchedFilter, 2*N+2*M, minMs);
+	benchKernel(csv, "setup_transmit_buffer", benchSetupTransmitBuffer, 2*N+1, minMs);
+	benchKernel(csv, "pulse_mix", benchPulseMix, 1, minMs);
+	benchKernel(csv, "delayed_pulse", benchDelayedPulse, OUTPUT_BUF_SIZE, minMs);
+	benchKernel(csv, "phase_estimate", benchPhaseFast, 1, minMs);
+	benchKernel(csv, "phase_estimate_libm", benchPhaseLibm, 1, minMs);
+
+	fclose(csv);
+	return 0;
+}
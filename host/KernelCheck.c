@@ -0,0 +1,759 @@
+/**
+ * @file 	KernelCheck.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Host checks that the node's fast kernels give the results of the code they stand in for
+ *
+ * The node source is compiled into this file, with its N, M and switches. The kernel checks compare a kernel with the
+ * code of time_stamper_master.c it replaces, copied here; the node checks run the node's own handlers, on a
+ * NodeContext of their own, on captures and sample streams with known pulses. Built as a slave (NODE_TYPE 2) it also
+ * has the slave's clock sinc. Each check runs both on the same input and fails if they differ by more than its
+ * tolerance:
+ *   correlator	the FFT matched filter (USE_FFT_CORRELATOR) against the direct form on pulses at every lag, on the
+ *				downmix and fused (fastQuarterWaveCorrelation()): corr_c and corr_s within CHECK_CORR_REL of the
+ *				peak, and the same corr_max_lag
+ *   fused		the fused fs/4 matched filter (USE_FUSED_DOWNMIX) against the downmix and the direct form: the same
+ *				tolerance
+ *   fixed		the Q14 matched filter of USE_FIXED_POINT (fusedQuarterWaveCorrelationQ14()) on the same capture as
+ *				Q15 shorts: bit exact against the integer direct form, within CHECK_FIXED_REL of the float direct
+ *				form (the Q14 rounding of the sinc taps), the same corr_max_lag and the carrier phase at the peak
+ *				within CHECK_FIXED_PHASE; skipped off the fs/4 carrier
+ *   sliding	the sliding search sums of runSearchingStateCodeISR() (USE_SLIDING_DETECTOR) against the full M tap
+ *				dot product on a stream of pulses in noise, sample for sample: corrSumIncoherent within CHECK_CORR_REL
+ *				of the largest, and the same trigger decisions at T1; with USE_NCO_DOWNMIX against the full sums over
+ *				the M mixed samples, triggering on any carrier phase that passes the carrier gate (NCO_COHERENCE)
+ *   estimate	the whole estimate (runReceviedSincPulseTimingAnalysis()) on pulses at known delays:
+ *				fine_delay_estimate within CHECK_FINE_SAMPLES of the delay, coarse_delay_estimate within a lag of it,
+ *				and at CHECK_PERIOD_NOISE_AMP, where the integer lag can be a lag off, within half a carrier period
+ *   lagsearch	the coarse-to-fine lag search (USE_HIERARCHICAL_LAG_SEARCH) against the scan of every lag: the same
+ *				corr_max_lag and corr_max, and the interpolated magnitude peak within CHECK_PEAK_SAMPLES of the
+ *				carrier phase estimate (fine_peak_disagreement) where the peak has a lag on either side
+ *   atan2		fastAtan2f() (USE_FAST_ATAN2) against libm atan2 on CHECK_ATAN2_POINTS angles round the full
+ *				circle, at magnitudes from 1 to 1e9: within CHECK_ATAN2_RAD
+ *   synth		the delayed pulse synthesizer (USE_PULSE_SYNTH) at CHECK_SYNTH_DELAYS delays in a sample, whole and in
+ *				blocks, against setupTransmitBuffer(): within CHECK_SYNTH_LSB, sample for sample
+ *   bank		the waveform bank (USE_PULSE_SYNTH 0) filled like nodeInit() does, every row read back against
+ *				setupTransmitBuffer(): the misfits storeDelayedWaveformRow() counts have to tell whether a sample
+ *				reads back wrong, which at fs/4 none does; in a slave build also the clock sinc at every bank
+ *				delay, mixed out through pulse_scheduler: exact from the bank, within CHECK_CLOCK_SINC_LSB from the
+ *				synthesizer it falls back to off fs/4
+ *   profiler	profileRecord() (CycleProfiler.c) on known durations from 0 to 2^32-1 ticks: the log2 histogram bins,
+ *				count, min, max and sum, and nothing recorded in the other regions or for a region out of range
+ *   queue		the frame code to main loop ring (EventQueue.c): a full ring takes EVENT_QUEUE_LEN events and drops
+ *				and counts the rest, and events come out in order at every fill level over several head and tail wraps
+ *   scheduler	the output pulse scheduler (PulseScheduler.c) on PULSE_SLOTS+2 overlapping pulses, waveforms and
+ *				sources on two channels: the first PULSE_SLOTS mix into the frame as the sum of their samples and free
+ *				their slots, the rest are dropped and counted; a pulse that starts before now is rejected and counted
+ *				in late, one that starts on now plays in the same frame, also across a wrap of the frame counter
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -DNODE_TYPE=2 -DSAMPLEIO_HOST_NO_MAIN -I. host/KernelCheck.c host/SampleIOHost.c CycleProfiler.c
+ *       EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c CorrelatorBank.c FastCorrelation.c PhaseEstimation.c
+ *       PulseScheduler.c PulseSynthesis.c TdmaSchedule.c WaveformBank.c -lm -o kernelcheck && ./kernelcheck
+ * ./kernelcheck runs every check, ./kernelcheck correlator only that one. It exits with 1 if a check fails.
+ */
+
+#include "time_stamper_master.c"
+
+#include <string.h>
+
+#define CHECK_CORR_REL		1e-4	// FFT against direct correlation, of the largest correlator output
+#define CHECK_FIXED_REL		1e-4	// Q14 against float matched filter, of the largest correlator output
+#define CHECK_FIXED_PHASE	1e-4	// radians
+#define CHECK_PEAK_SAMPLES	0.5		// fine_peak_disagreement
+#define CHECK_ATAN2_RAD		1.2e-5	// the worst case in PhaseEstimation.c
+#define CHECK_ATAN2_POINTS	10000000L
+#define CHECK_SYNTH_LSB		0		// the synthesizer's recurrences against the double formula
+#define CHECK_SYNTH_DELAYS	1000
+#define CHECK_SYNTH_BLOCK	32		// samples per synthesizeDelayedPulseBlock() call
+#define CHECK_CLOCK_SINC_LSB	1		// the synthesized clock sinc, its delay is a float tick error
+#define CHECK_LAG_STEP		7		// pulse positions, every CHECK_LAG_STEP-th lag
+#define CHECK_PULSE_AMP		16000.0
+#define CHECK_NOISE_AMP		400.0
+#define CHECK_FINE_SAMPLES	0.01	// fine_delay_estimate from the delay, at CHECK_PULSE_AMP over CHECK_NOISE_AMP
+#define CHECK_QUIET_AMP		40.0	// noise between the searched pulses, under T1
+#define CHECK_PERIOD_NOISE_AMP	1500.0	// noise that puts the integer lag off the flat top of the metric
+#define CHECK_STREAM_PULSES	16
+#define CHECK_SCHED_LENGTH	16		// samples per scheduled pulse
+#define CHECK_SCHED_SPACING	2		// frames between the starts of the overlapping pulses
+
+typedef int (*CheckBody)();
+
+static float checkSincRef[2*N+1];				// basebandSincRef
+static float checkRecbuf[2*N+2*M];				// recbuf
+static float checkDownCos[2*N+2*M], checkDownSin[2*N+2*M];
+static float checkCorrCos[2*M], checkCorrSin[2*M], checkMetric[2*M];
+
+static short checkSincRefQ14[2*N+1];			// basebandSincRef with USE_FIXED_POINT
+static short checkRecbufQ15[2*N+2*M];
+
+static NodeContext checkNode;					// what the node checks run the node's handlers on
+
+static unsigned int checkNoiseState = 12345;
+
+/**
+ * Uniform noise in -amp to amp, fixed sequence
+ */
+static double checkNoise(double amp){
+	checkNoiseState = checkNoiseState*1664525u + 1013904223u;
+	return amp*((double)(checkNoiseState >> 8)/8388608.0 - 1.0);
+}
+
+/**
+ * The modulated sinc pulse, at u samples from its centre
+ */
+static double checkPulse(double u){
+	if(u < -N || u > N)
+		return 0;
+	return CHECK_PULSE_AMP*cos(2*PI*CBW*u)*((u != 0) ? sin(PI*BW*u)/(PI*BW*u) : 1.0);
+}
+
+/**
+ * basebandSincRef, as SetupReceiveBasebandSincPulseBuffer() fills it
+ */
+static void checkSetupReference(){
+	short idx;
+	double x;
+
+	for(idx = -N; idx <= N; idx++){
+		x = idx*BW;
+		checkSincRef[idx + N] = (float)((idx != 0) ? sin(PI*x)/(PI*x) : 1.0);
+		checkSincRefQ14[idx + N] = (short)(checkSincRef[idx + N]*(1<<14) + ((checkSincRef[idx + N] < 0) ? -0.5 : 0.5));
+	}
+	SetupFastCorrelatorReference(checkSincRef, 2*N+1);
+}
+
+/**
+ * A capture like the recording state leaves it, with the modulated sinc pulse starting at start plus the delay, and
+ * its fs/4 downmix as runReceivedPulseBufferDownmixing() does it
+ */
+static void checkCapture(long start, double delay){
+	long idx;
+
+	for(idx = 0; idx < 2*N+2*M; idx++){
+		// whole codec samples, so the float and Q15 captures hold the same values
+		checkRecbufQ15[idx] = (short)floor(checkNoise(CHECK_NOISE_AMP) + checkPulse(idx - start - N - delay) + 0.5);
+		checkRecbuf[idx] = checkRecbufQ15[idx];
+	}
+	for(idx = 0; idx < 2*N+2*M; idx++){
+		// (1,0,-1,0) and (0,1,0,-1)
+		checkDownCos[idx] = ((idx & 1) == 0) ? (((idx & 2) == 0) ? checkRecbuf[idx] : -checkRecbuf[idx]) : 0;
+		checkDownSin[idx] = ((idx & 1) == 1) ? (((idx & 2) == 0) ? checkRecbuf[idx] : -checkRecbuf[idx]) : 0;
+	}
+}
+
+/**
+ * The direct form of runReceviedSincPulseTimingAnalysis(), every lag
+ */
+static void checkDirectCorrelation(){
+	short lag, tap;
+
+	for(lag = 0; lag < 2*M; lag++){
+		checkCorrCos[lag] = 0;
+		checkCorrSin[lag] = 0;
+		for(tap = 0; tap < 2*N+1; tap++){
+			checkCorrCos[lag] += checkSincRef[tap]*checkDownCos[tap + lag];
+			checkCorrSin[lag] += checkSincRef[tap]*checkDownSin[tap + lag];
+		}
+		checkMetric[lag] = checkCorrCos[lag]*checkCorrCos[lag] + checkCorrSin[lag]*checkCorrSin[lag];
+	}
+}
+
+/**
+ * Lag of the largest metric
+ */
+static short checkPeakLag(const float* metric){
+	short lag, best = 0;
+
+	for(lag = 1; lag < 2*M; lag++){
+		if(metric[lag] > metric[best])
+			best = lag;
+	}
+	return best;
+}
+
+/**
+ * Compares a kernel's correlator outputs with the direct form's in checkCorrCos and checkCorrSin
+ * @param worst		raised to the largest difference, relative to the largest direct form output
+ * @return 1 if the kernel's metric peaks on another lag
+ */
+static short checkAgainstDirect(const float* corrCos, const float* corrSin, double* worst){
+	static float metric[2*M];
+	short lag;
+	double peak = 0, diff;
+
+	for(lag = 0; lag < 2*M; lag++){
+		metric[lag] = corrCos[lag]*corrCos[lag] + corrSin[lag]*corrSin[lag];
+		if(fabs(checkCorrCos[lag]) > peak)
+			peak = fabs(checkCorrCos[lag]);
+		if(fabs(checkCorrSin[lag]) > peak)
+			peak = fabs(checkCorrSin[lag]);
+	}
+	for(lag = 0; lag < 2*M; lag++){
+		diff = fabs(corrCos[lag] - checkCorrCos[lag]) / peak;
+		if(diff > *worst)
+			*worst = diff;
+		diff = fabs(corrSin[lag] - checkCorrSin[lag]) / peak;
+		if(diff > *worst)
+			*worst = diff;
+	}
+	return checkPeakLag(metric) != checkPeakLag(checkMetric);
+}
+
+static int checkCorrelator(){
+	static float fftCos[2*M], fftSin[2*M];
+	short start, captures = 0, lagsOff = 0;
+	double delay, worst = 0;
+
+	for(start = 0; start < 2*M; start += CHECK_LAG_STEP){
+		for(delay = 0; delay < 1; delay += 0.25){
+			checkCapture(start, delay);
+			checkDirectCorrelation();
+			fastQuadratureCorrelation(checkDownCos, checkDownSin, 2*N+2*M, fftCos, fftSin, 2*M);
+			lagsOff += checkAgainstDirect(fftCos, fftSin, &worst);
+			fastQuarterWaveCorrelation(checkRecbuf, 2*N+2*M, fftCos, fftSin, 2*M);		// USE_FUSED_DOWNMIX
+			lagsOff += checkAgainstDirect(fftCos, fftSin, &worst);
+			captures++;
+		}
+	}
+	printf("correlator: %d captures, worst corr_c/corr_s %.2e of the peak (tolerance %.0e), "
+			"corr_max_lag differs in %d\n", captures, worst, CHECK_CORR_REL, lagsOff);
+	return worst > CHECK_CORR_REL || lagsOff != 0;
+}
+
+static int checkFused(){
+	static float fusedCos[2*M], fusedSin[2*M];
+	short start, captures = 0, lagsOff = 0;
+	double delay, worst = 0;
+
+	for(start = 0; start < 2*M; start += CHECK_LAG_STEP){
+		for(delay = 0; delay < 1; delay += 0.25){
+			checkCapture(start, delay);
+			checkDirectCorrelation();
+			fusedQuarterWaveCorrelation(checkRecbuf, checkSincRef, 2*N+1, fusedCos, fusedSin, 2*M);
+			lagsOff += checkAgainstDirect(fusedCos, fusedSin, &worst);
+			captures++;
+		}
+	}
+	printf("fused: %d captures, worst corr_c/corr_s %.2e of the peak (tolerance %.0e), corr_max_lag differs in %d\n",
+			captures, worst, CHECK_CORR_REL, lagsOff);
+	return worst > CHECK_CORR_REL || lagsOff != 0;
+}
+
+static int checkFixed(){
+	static int fixedCos[2*M], fixedSin[2*M];
+	static float fixedCosF[2*M], fixedSinF[2*M];
+	short start, lag, tap, best, captures = 0, lagsOff = 0, inexact = 0;
+	long long sumCos, sumSin;
+	double delay, phaseErr, worst = 0, worstPhase = 0;
+
+	if(CBW != 0.25){
+		printf("fixed: the Q14 fused kernel is fs/4 only, CBW is %g\n", (double)CBW);
+		return 0;
+	}
+	for(start = 0; start < 2*M; start += CHECK_LAG_STEP){
+		for(delay = 0; delay < 1; delay += 0.25){
+			checkCapture(start, delay);
+			checkDirectCorrelation();
+			fusedQuarterWaveCorrelationQ14(checkRecbufQ15, checkSincRefQ14, 2*N+1, fixedCos, fixedSin, 2*M);
+			for(lag = 0; lag < 2*M; lag++){
+				// integer direct form on the downmix: the fs/4 values are +-1 and 0, so it is exact
+				sumCos = 0;
+				sumSin = 0;
+				for(tap = 0; tap < 2*N+1; tap++){
+					sumCos += checkSincRefQ14[tap]*(long long)checkDownCos[tap + lag];
+					sumSin += checkSincRefQ14[tap]*(long long)checkDownSin[tap + lag];
+				}
+				if(fixedCos[lag] != (int)(sumCos >> 14) || fixedSin[lag] != (int)(sumSin >> 14))
+					inexact++;
+				fixedCosF[lag] = (float)fixedCos[lag];
+				fixedSinF[lag] = (float)fixedSin[lag];
+			}
+			lagsOff += checkAgainstDirect(fixedCosF, fixedSinF, &worst);
+			best = checkPeakLag(checkMetric);
+			phaseErr = fabs(atan2(fixedSinF[best], fixedCosF[best]) - atan2(checkCorrSin[best], checkCorrCos[best]));
+			if(phaseErr > PI)
+				phaseErr = 2*PI - phaseErr;
+			if(phaseErr > worstPhase)
+				worstPhase = phaseErr;
+			captures++;
+		}
+	}
+	printf("fixed: %d captures, %d lags off the integer direct form, worst corr_c/corr_s %.2e of the peak "
+			"(tolerance %.0e), phase %.2e rad (tolerance %.0e), corr_max_lag differs in %d\n", captures, inexact,
+			worst, CHECK_FIXED_REL, worstPhase, CHECK_FIXED_PHASE, lagsOff);
+	return inexact != 0 || worst > CHECK_FIXED_REL || worstPhase > CHECK_FIXED_PHASE || lagsOff != 0;
+}
+
+/**
+ * A capture like the recording state leaves it in recbuf, with the modulated sinc pulse starting at start plus the
+ * delay, in noise of amplitude noise
+ */
+static void checkNodeCapture(long start, double delay, double noise){
+	long idx;
+
+	for(idx = 0; idx < 2*N+2*M; idx++)
+		checkNode.recbuf[idx] = (capture_t)(checkNoise(noise) + checkPulse(idx - start - N - delay));
+	checkNode.recbuf_start_clock = 0;
+#if (!USE_FUSED_DOWNMIX)
+	runReceivedPulseBufferDownmixing(&checkNode);
+#endif
+}
+
+static int checkSliding(){
+	static short frame[FRAME_CHANNELS];
+	long idx, length = CHECK_STREAM_PULSES*4L*N2, decisionsOff = 0, triggers = 0;
+	short tap, onCarrier;
+	capture_t sample;
+	double cosine, sine, metric, largest = 0, worst = 0;
+#if (USE_NCO_DOWNMIX)
+	double energy;
+#endif
+
+	for(idx = 0; idx < length; idx++){
+		// a pulse in every 4*N2 samples, each a quarter sample later than the one before
+		sample = (capture_t) floor(checkNoise(CHECK_QUIET_AMP)
+				+ checkPulse(idx % (4L*N2) - 2*N2 - 0.25*(idx/(4L*N2))) + 0.5);
+
+		frame[RECEIVE_SINC] = (short) sample;
+		frameIn = frame;
+		local_carrier_phase = (char)(idx & 3);
+		state = STATE_SEARCHING;
+#if (USE_NCO_DOWNMIX)
+		// the full sums over the last M baseband samples with the new one in, like the build without the sliding sums
+		cosine = 0;
+		sine = 0;
+		energy = 0;
+		for(tap = 0; tap < M; tap++){
+			if(tap == checkNode.bufindex){
+				cosine += sample*NCO_COS(checkNode.searchNco.phase);
+				sine += sample*NCO_SIN(checkNode.searchNco.phase);
+				energy += (double) sample*sample;
+			}
+			else {
+				cosine += checkNode.searchMixedCosine[tap];
+				sine += checkNode.searchMixedSine[tap];
+				energy += (double) checkNode.buf[tap]*checkNode.buf[tap];
+			}
+		}
+		metric = cosine*cosine + sine*sine;
+		onCarrier = metric >= NCO_COHERENCE*M*energy;	// any carrier phase, but only the own carrier
+		runSearchingStateCodeISR(&checkNode);
+#else
+		// the full dot product over buf with the new sample in, like the build without the sliding sums
+		cosine = 0;
+		sine = 0;
+		for(tap = 0; tap < M; tap++){
+			cosine += COEF_MUL(matchedFilterCosine[tap], (tap == checkNode.bufindex) ? sample : checkNode.buf[tap]);
+			sine += COEF_MUL(matchedFilterSine[tap], (tap == checkNode.bufindex) ? sample : checkNode.buf[tap]);
+		}
+		metric = cosine*cosine + sine*sine;
+		onCarrier = ((idx & 3) == 0);
+		runSearchingStateCodeISR(&checkNode);
+#endif
+		if(metric > largest)
+			largest = metric;
+		if(fabs(checkNode.corrSumIncoherent - metric) > worst)
+			worst = fabs(checkNode.corrSumIncoherent - metric);
+		if((state == STATE_RECORDING) != ((metric > T1) && onCarrier))
+			decisionsOff++;
+		if(state == STATE_RECORDING)
+			triggers++;
+	}
+	state = STATE_SEARCHING;
+	worst /= largest;
+	printf("sliding: %ld samples, worst corrSumIncoherent %.2e of the largest (tolerance %.0e), "
+			"%ld of %ld trigger decisions differ\n", length, worst, CHECK_CORR_REL, decisionsOff, triggers);
+	return worst > CHECK_CORR_REL || decisionsOff != 0;
+}
+
+static int checkEstimate(){
+	short start, captures = 0, coarseOff = 0, periodOff = 0;
+	double delay, fine, worst = 0;
+
+	for(start = 0; start < 2*M - 1; start += CHECK_LAG_STEP){
+		for(delay = 0; delay < 1; delay += 0.125){
+			checkNodeCapture(start, delay, CHECK_NOISE_AMP);
+			runReceviedSincPulseTimingAnalysis(&checkNode);
+			fine = checkNode.fine_delay_estimate[checkNode.fde_index] - (start + delay);
+			if(fabs(fine) > worst)
+				worst = fabs(fine);
+			if(abs(checkNode.coarse_delay_estimate[checkNode.cde_index] - start) > 1)
+				coarseOff++;
+			captures++;
+			// in more noise the integer lag can land a lag off, the estimate has to stay on the carrier period
+			checkNodeCapture(start, delay, CHECK_PERIOD_NOISE_AMP);
+			runReceviedSincPulseTimingAnalysis(&checkNode);
+			if(fabs(checkNode.fine_delay_estimate[checkNode.fde_index] - (start + delay)) > 2)
+				periodOff++;
+		}
+	}
+	printf("estimate: %d captures, worst fine_delay_estimate %.4f samples off (tolerance %.2f), "
+			"coarse_delay_estimate off by more than a lag in %d, a carrier period off in %d at noise %.0f\n",
+			captures, worst, CHECK_FINE_SAMPLES, coarseOff, periodOff, CHECK_PERIOD_NOISE_AMP);
+	return worst > CHECK_FINE_SAMPLES || coarseOff != 0 || periodOff != 0;
+}
+
+static int checkLagSearch(){
+#if (USE_FFT_CORRELATOR && !USE_FIXED_POINT)
+	printf("lagsearch: the FFT matched filter fills every lag, there is no lag search\n");
+	return 0;
+#else
+	short start, lag, best, captures = 0, lagsOff = 0;
+	double delay, worst = 0;
+	metric_t searched;
+
+	for(start = 0; start < 2*M; start += CHECK_LAG_STEP){
+		for(delay = 0; delay < 1; delay += 0.25){
+			checkNodeCapture(start, delay, CHECK_NOISE_AMP);
+			runReceviedSincPulseTimingAnalysis(&checkNode);
+			// the parabola needs a lag on either side of the peak, at the ends corr_peak_offset is 0
+			if(checkNode.corr_max_lag > 0 && checkNode.corr_max_lag < 2*M-1
+					&& fabs(checkNode.fine_peak_disagreement) > worst)
+				worst = fabs(checkNode.fine_peak_disagreement);
+			searched = checkNode.corr_max;
+			// every lag, like the build without the lag search
+			best = 0;
+			for(lag = 0; lag < 2*M; lag++){
+				correlateReceivedLag(&checkNode, lag);
+				if(checkNode.s[lag] > checkNode.s[best])
+					best = lag;
+			}
+			if(best != checkNode.corr_max_lag || checkNode.s[best] != searched)
+				lagsOff++;
+			captures++;
+		}
+	}
+	printf("lagsearch: %d captures, corr_max_lag or corr_max differs from the full scan in %d, "
+			"worst fine_peak_disagreement %.3f samples (tolerance %.1f)\n", captures, lagsOff, worst,
+			CHECK_PEAK_SAMPLES);
+	return lagsOff != 0 || worst > CHECK_PEAK_SAMPLES;
+#endif
+}
+
+static int checkAtan2(){
+	long point;
+	double angle, magnitude, diff, worst = 0, worstAngle = 0;
+
+	for(point = 0; point < CHECK_ATAN2_POINTS; point++){
+		angle = 2*PI*point/CHECK_ATAN2_POINTS - PI;
+		magnitude = pow(10.0, point % 10);		// the correlator outputs span many decades
+		diff = fastAtan2f((float)(magnitude*sin(angle)), (float)(magnitude*cos(angle)))
+				- atan2((float)(magnitude*sin(angle)), (float)(magnitude*cos(angle)));
+		if(diff > PI)		// -pi and pi are the same angle
+			diff -= 2*PI;
+		else if(diff < -PI)
+			diff += 2*PI;
+		if(fabs(diff) > worst){
+			worst = fabs(diff);
+			worstAngle = angle;
+		}
+	}
+	printf("atan2: %ld angles, worst %.3e rad at %.4f rad, %.1e samples at fs/4 (tolerance %.1e rad)\n",
+			CHECK_ATAN2_POINTS, worst, worstAngle, worst*2*INVPI, CHECK_ATAN2_RAD);
+	return worst > CHECK_ATAN2_RAD;
+}
+
+static int checkSynth(){
+	static short formula[2*N+1], whole[2*N+1], blocks[2*N+1];
+	PulseSynth synth;
+	short idx, delays;
+	int diff, worst = 0;
+	double delay;
+
+	for(delays = 0; delays < CHECK_SYNTH_DELAYS; delays++){
+		delay = (double)delays/CHECK_SYNTH_DELAYS;
+		setupTransmitBuffer(formula, N, BW, CBW, delay);
+		synthesizeDelayedPulse(whole, N, BW, CBW, delay);
+		startDelayedPulse(&synth, N, BW, CBW, delay);
+		for(idx = 0; idx < 2*N+1; idx += CHECK_SYNTH_BLOCK)
+			synthesizeDelayedPulseBlock(&synth, &blocks[idx], (2*N+1 - idx < CHECK_SYNTH_BLOCK) ? 2*N+1 - idx
+					: CHECK_SYNTH_BLOCK);
+		for(idx = 0; idx < 2*N+1; idx++){
+			diff = abs(whole[idx] - formula[idx]);
+			if(diff > worst)
+				worst = diff;
+			diff = abs(blocks[idx] - formula[idx]);
+			if(diff > worst)
+				worst = diff;
+		}
+	}
+	printf("synth: %d delays of %d samples, worst %d LSB (tolerance %d)\n", CHECK_SYNTH_DELAYS, 2*N+1, worst,
+			CHECK_SYNTH_LSB);
+	return worst > CHECK_SYNTH_LSB;
+}
+
+#if (SLAVE_ROLE)
+/**
+ * Schedules the slave's clock sinc for a tick error, mixes it out and compares it with the formula
+ * @return the largest difference in LSB, 32767 if it starts early
+ */
+static int checkClockSinc(short index){
+	static short formula[2*N+1], frames[OUTPUT_BUF_SIZE + 2*CLOCK_SINC_DELAY][FRAME_CHANNELS];
+	short idx, whole = CLOCK_SINC_DELAY;
+	int diff, worst = 0;
+
+	setupTransmitBuffer(formula, N, BW, carrier_freq, (double)index/MAXDELAY);
+	clock_tick_error = (float)index/MAXDELAY;
+	scheduleClockSincISR();
+	for(idx = 0; idx < OUTPUT_BUF_SIZE + 2*CLOCK_SINC_DELAY; idx++){
+		frames[idx][TRANSMIT_CLOCK] = 0;
+		pulseSchedulerMix(&pulse_scheduler, frames[idx]);
+	}
+	for(idx = 0; idx < whole; idx++){
+		if(frames[idx][TRANSMIT_CLOCK] != 0)
+			worst = 32767;
+	}
+	for(idx = 0; idx < 2*N+1; idx++){
+		diff = abs(frames[idx + whole][TRANSMIT_CLOCK] - formula[idx]);
+		if(diff > worst)
+			worst = diff;
+	}
+	return worst;
+}
+#endif
+
+static int checkBank(){
+#if (WAVEBANK_HALF_LEN == N && WAVEBANK_RESOLUTION == MAXDELAY)
+	static short row[WAVEBANK_ROW_INPUT_LEN], formula[2*N+1];
+	short idx;
+#endif
+#if (SLAVE_ROLE || (WAVEBANK_HALF_LEN == N && WAVEBANK_RESOLUTION == MAXDELAY))
+	short index;
+#endif
+	long misfits = 0, wrong = 0;
+#if (SLAVE_ROLE)
+	int diff, worst = 0, fromBank = 0;
+#endif
+
+#if (WAVEBANK_HALF_LEN == N && WAVEBANK_RESOLUTION == MAXDELAY)
+	for(index = 0; index < WAVEBANK_ROWS; index++){
+		setupTransmitBuffer(row, N+1, BW, CBW, (double)index/WAVEBANK_RESOLUTION);
+		misfits += storeDelayedWaveformRow(index, row);
+	}
+	for(index = 0; index < WAVEBANK_RESOLUTION; index++){
+		setupTransmitBuffer(formula, N, BW, CBW, (double)index/WAVEBANK_RESOLUTION);
+		for(idx = -N; idx <= N; idx++){
+			if(delayedWaveformSample(index, idx) != formula[idx + N])
+				wrong++;
+		}
+	}
+	printf("bank: %ld of %ld bytes, %ld misfits, %ld of %d samples read back wrong\n", (long)WAVEBANK_BYTES,
+			(long)WAVEBANK_FULL_TABLE_BYTES, misfits, wrong, WAVEBANK_RESOLUTION*(2*N+1));
+#else
+	printf("bank: WaveformBank.h is set up for N %d and MAXDELAY %d, not %d and %d\n", WAVEBANK_HALF_LEN,
+			WAVEBANK_RESOLUTION, N, MAXDELAY);
+#endif
+#if (SLAVE_ROLE)
+#if (!USE_PULSE_SYNTH)
+	fromBank = waveform_bank_misfits == 0;
+#endif
+	for(index = 0; index < MAXDELAY; index++){
+		diff = checkClockSinc(index);
+		if(diff > worst)
+			worst = diff;
+	}
+	printf("bank: clock sinc at %d delays from the %s, worst %d LSB off the formula (tolerance %d)\n", MAXDELAY,
+			fromBank ? "bank" : "synthesizer", worst, fromBank ? 0 : CHECK_CLOCK_SINC_LSB);
+	if(worst > (fromBank ? 0 : CHECK_CLOCK_SINC_LSB))
+		return 1;
+#endif
+	return (wrong == 0) != (misfits == 0);
+}
+
+static int checkProfiler(){
+	static const profile_tick_t ticks[] = {0, 1, 2, 3, 4, 7, 8, 1000, 1023, 1024, 65535, 65536, 3000000000u,
+			0xffffffffu};
+	unsigned long hist[PROFILE_HIST_BINS] = {0};
+	const ProfileRegion* r;
+	profile_tick_t min = 0xffffffffu, max = 0;
+	unsigned long long sum = 0;
+	short t, bin, region, wrong = 0;
+
+	profilerReset();
+	for(t = 0; t < (short)(sizeof(ticks)/sizeof(ticks[0])); t++){
+		profileRecord(PROFILE_TIMING_ANALYSIS, ticks[t]);
+		for(bin = 0; bin < PROFILE_HIST_BINS - 1 && (ticks[t] >> (bin + 1)) != 0; bin++)
+			;		// floor(log2), 0 for 0 and 1
+		hist[bin]++;
+		if(ticks[t] < min)
+			min = ticks[t];
+		if(ticks[t] > max)
+			max = ticks[t];
+		sum += ticks[t];
+	}
+	profileRecord(-1, 5);		// out of range, dropped
+	profileRecord(PROFILE_REGIONS, 5);
+	r = profilerRegion(PROFILE_TIMING_ANALYSIS);
+	for(bin = 0; bin < PROFILE_HIST_BINS; bin++)
+		wrong += r->hist[bin] != hist[bin];
+	for(region = 0; region < PROFILE_REGIONS; region++)
+		wrong += region != PROFILE_TIMING_ANALYSIS && profilerRegion(region)->count != 0;
+	printf("profiler: %d durations, count %lu min %u max %u, %d histogram bins or other regions wrong\n", t, r->count,
+			r->min, r->max, wrong);
+	return wrong != 0 || r->count != (unsigned long)t || r->min != min || r->max != max || r->sum != sum;
+}
+
+static int checkQueue(){
+	static EventQueue queue;
+	NodeEvent event;
+	long n, posted = 0, taken = 0, wrong = 0;
+	short k, full, dropped;
+
+	// full ring: EVENT_QUEUE_LEN events fit, the next ones are dropped and counted, the first ones come out in order
+	eventQueueInit(&queue);
+	for(k = 0; k < EVENT_QUEUE_LEN; k++)
+		wrong += eventQueuePost(&queue, EVENT_TICK_WRAPPED, k, k) != 1;
+	full = eventQueuePending(&queue);
+	wrong += eventQueuePost(&queue, EVENT_TICK_WRAPPED, 0, -1) != 0;
+	wrong += eventQueuePost(&queue, EVENT_TICK_WRAPPED, 0, -2) != 0;
+	for(k = 0; k < EVENT_QUEUE_LEN; k++)
+		wrong += !eventQueueTake(&queue, &event) || event.clock != k || event.value != k;
+	wrong += eventQueueTake(&queue, &event) != 0;
+	dropped = queue.dropped;
+	wrong += full != EVENT_QUEUE_LEN || dropped != 2;
+
+	// head and tail over several 16 bit wraps, at every fill level from empty to full
+	eventQueueInit(&queue);
+	for(n = 0; n < 4*65536L; n++){
+		if(eventQueuePost(&queue, EVENT_CAPTURE_READY, (short)posted, (int)posted))
+			posted++;
+		if(n % (EVENT_QUEUE_LEN + 1) == EVENT_QUEUE_LEN){
+			while(eventQueueTake(&queue, &event)){
+				wrong += event.type != EVENT_CAPTURE_READY || event.value != taken || event.clock != (short)taken;
+				taken++;
+			}
+		}
+		else if(n % 2 && eventQueueTake(&queue, &event)){
+			wrong += event.value != taken;
+			taken++;
+		}
+		wrong += eventQueuePending(&queue) != posted - taken;
+	}
+	printf("queue: %d of %d events taken from a full ring, %d dropped, %ld of %ld events over %ld index wraps, "
+			"%ld wrong\n", full, EVENT_QUEUE_LEN + 2, dropped, taken, posted, posted/65536, wrong);
+	return wrong != 0;
+}
+
+/**
+ * Sample of a scheduled pulse, the waveform is its context
+ */
+static short checkSchedSource(void* context, short offset){
+	return ((const short*) context)[offset];
+}
+
+/**
+ * The sample the mix adds for pulse k of checkScheduler() at offset into it, 0 outside it
+ */
+static long checkSchedExpected(short wave[][CHECK_SCHED_LENGTH], short k, long offset){
+	if(offset < 0 || offset >= CHECK_SCHED_LENGTH)
+		return 0;
+	return ((long) wave[k][offset]*((k & 2) ? PULSE_UNITY_GAIN/2 : PULSE_UNITY_GAIN))>>14;
+}
+
+static int checkScheduler(){
+	static PulseScheduler sched;
+	static short wave[PULSE_SLOTS+2][CHECK_SCHED_LENGTH];
+	short frame[FRAME_CHANNELS];
+	short k, slot, c, tap, taken = 0, wrong = 0, stillOn = 0;
+	long f, expect;
+
+	for(k = 0; k < PULSE_SLOTS+2; k++)
+		for(tap = 0; tap < CHECK_SCHED_LENGTH; tap++)
+			wave[k][tap] = (short)(1000*(k+1) + 37*tap - 300);
+
+	// overlapping pulses, every CHECK_SCHED_SPACING frames on alternate channels, half of them from a source at half
+	// gain: the first PULSE_SLOTS take a slot each, the rest are dropped
+	pulseSchedulerInit(&sched);
+	for(k = 0; k < PULSE_SLOTS+2; k++){
+		if(k & 1)
+			slot = pulseScheduleSource(&sched, k*CHECK_SCHED_SPACING, checkSchedSource, wave[k], CHECK_SCHED_LENGTH,
+					(k & 2) ? PULSE_UNITY_GAIN/2 : PULSE_UNITY_GAIN, (unsigned char)(k & 1));
+		else
+			slot = pulseSchedule(&sched, k*CHECK_SCHED_SPACING, wave[k], CHECK_SCHED_LENGTH,
+					(k & 2) ? PULSE_UNITY_GAIN/2 : PULSE_UNITY_GAIN, (unsigned char)(k & 1));
+		if(slot >= 0)
+			taken++;
+		wrong += slot != ((k < PULSE_SLOTS) ? k : -1);
+	}
+	for(f = 0; f < PULSE_SLOTS*CHECK_SCHED_SPACING + CHECK_SCHED_LENGTH; f++){
+		for(c = 0; c < FRAME_CHANNELS; c++)
+			frame[c] = 1;		// the pulses go on top of what is in the frame
+		pulseSchedulerMix(&sched, frame);
+		for(c = 0; c < 2; c++){
+			expect = 1;
+			for(k = c; k < PULSE_SLOTS; k += 2)
+				expect += checkSchedExpected(wave, k, f - k*CHECK_SCHED_SPACING);
+			wrong += frame[c] != expect;
+		}
+	}
+	for(slot = 0; slot < PULSE_SLOTS; slot++)
+		stillOn += sched.slot[slot].on;
+	wrong += sched.dropped != 2 || sched.late != 0;
+
+	// a start before now never comes round, it is rejected and counted; a start on now plays in the same frame, and a
+	// pulse plays on over the wrap of the frame counter
+	sched.now = (unsigned long) -3;
+	wrong += pulseSchedule(&sched, sched.now - 1, wave[0], CHECK_SCHED_LENGTH, PULSE_UNITY_GAIN, 0) != -1;
+	wrong += pulseScheduleSource(&sched, sched.now - CHECK_SCHED_LENGTH, checkSchedSource, wave[1], CHECK_SCHED_LENGTH,
+			PULSE_UNITY_GAIN, 1) != -1;
+	wrong += pulseSchedule(&sched, sched.now, wave[0], CHECK_SCHED_LENGTH, PULSE_UNITY_GAIN, 0) < 0;
+	wrong += pulseScheduleSource(&sched, sched.now + 2, checkSchedSource, wave[1], CHECK_SCHED_LENGTH,
+			PULSE_UNITY_GAIN, 1) < 0;
+	for(f = 0; f < CHECK_SCHED_LENGTH + 2; f++){
+		frame[0] = 0;
+		frame[1] = 0;
+		pulseSchedulerMix(&sched, frame);
+		wrong += frame[0] != checkSchedExpected(wave, 0, f) || frame[1] != checkSchedExpected(wave, 1, f - 2);
+	}
+	wrong += sched.late != 2 || sched.dropped != 2 || sched.now != CHECK_SCHED_LENGTH - 1;
+	for(slot = 0; slot < PULSE_SLOTS; slot++)
+		stillOn += sched.slot[slot].on;
+
+	printf("scheduler: %d of %d overlapping pulses taken, %lu dropped, %lu late starts rejected, %d slots left on, "
+			"%d wrong\n", taken, PULSE_SLOTS+2, sched.dropped, sched.late, stillOn, wrong);
+	return wrong != 0 || stillOn != 0;
+}
+
+static const struct {
+	const char* name;
+	CheckBody body;
+} checks[] = {
+	{"correlator", checkCorrelator},
+	{"fused", checkFused},
+	{"fixed", checkFixed},
+	{"sliding", checkSliding},
+	{"estimate", checkEstimate},
+	{"lagsearch", checkLagSearch},
+	{"atan2", checkAtan2},
+	{"synth", checkSynth},
+	{"bank", checkBank},
+	{"profiler", checkProfiler},
+	{"queue", checkQueue},
+	{"scheduler", checkScheduler}
+};
+
+int main(int argc, char** argv){
+	short c, ran = 0, failed = 0;
+
+	nodeInit();
+	nodeContextInit(&checkNode);
+	checkSetupReference();
+	for(c = 0; c < (short)(sizeof(checks)/sizeof(checks[0])); c++){
+		if(argc > 1 && strcmp(argv[1], checks[c].name) != 0)
+			continue;
+		ran++;
+		if(checks[c].body()){
+			printf("FAIL %s\n", checks[c].name);
+			failed++;
+		}
+		else
+			printf("PASS %s\n", checks[c].name);
+	}
+	if(ran == 0){
+		printf("usage: %s [correlator | fused | fixed | sliding | estimate | lagsearch | atan2 | synth | bank"
+				" | profiler | queue]\n", argv[0]);
+		return 1;
+	}
+	return failed != 0;
+}
@@ -0,0 +1,992 @@
+/**
+ * @file 	NetSim.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Closed-loop master/slave simulator: both nodes of time_stamper_master.c against a simulated channel
+ *
+ * NODE_TYPE is a compile time switch and the node keeps its state in globals, so each node is built as its own
+ * shared object and loaded with dlopen(RTLD_LOCAL), which gives the master and the slave their own copy of
+ * everything. With more than one slave each slave is loaded from its own temporary copy of the slave object, dlopen
+ * would hand out the same copy again for the same file. The simulator steps the nodes one frame at a time in
+ * reference time order, so the run is in virtual sample time and goes as fast as the host can process frames.
+ *
+ * Channel, the same between all nodes and both ways: the sender's TRANSMIT_SINC samples leave its DAC dacDelay
+ * samples late, travel for delay samples with the path gain, get AWGN, and reach the receiver's RECEIVE_SINC
+ * adcDelay samples after they hit its ADC. A node hears the sum of all the others, slaves hear each other too.
+ * Each node samples on its own drifting clock, the signal is carried between the clocks with a windowed sinc
+ * interpolator.
+ *
+ * Several slaves (-slaves) need master and slave builds with -DUSE_TDMA=1 (TdmaSchedule.c), slave k of the run gets
+ * slot k, or with -DUSE_FDM_BANK=1 (CorrelatorBank.c), slave k of the run gets channel k. The report then has a line
+ * per slave and the master's slot or channel table.
+ *
+ * A tree (-tree, with a RELAY_NODE build from -relay for the nodes with children) puts the nodes out of each other's
+ * range: a node only hears its parent, its children and its siblings. The master and each relay serve their children
+ * on a carrier of their own (SIM_CARRIERS), the simulator sets carrier_freq and relay_carrier before nodeInit(), so
+ * all builds need -DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0, and -DUSE_TDMA=1 once a parent has more than one child.
+ * It hands each parent's sync_error_budget down to its children as it goes, like a debugger would on the DSK. The
+ * report has a line per node with the offset to its parent and to the master, and the figures per depth.
+ *
+ * With -expect-lock, -expect-std and -expect-rate the run exits with 1 if a node locks too late, holds its offset too
+ * loosely or exchanges pulses too often, so host/checks.sh can run the simulator as a test.
+ *
+ * The offset is measured between the virtual clock ticks (vclock_counter wrapping, to 0 or to the skew compensated
+ * start of the slave tick) of the two nodes at their DAC outputs, which is where the scope sees the clock sinc pulses.
+ *
+ * Build from the project root:
+ *   gcc -O2 -shared -fPIC -DNODE_TYPE=1 -DSAMPLEIO_HOST_NO_MAIN -I. host/SampleIOHost.c time_stamper_master.c
+ *       CycleProfiler.c EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c CorrelatorBank.c
+ *       FastCorrelation.c PhaseEstimation.c PulseScheduler.c PulseSynthesis.c RelayDownlink.c StreamEstimator.c
+ *       TdmaSchedule.c WaveformBank.c -lm -o node_master.so
+ *   (same with -DNODE_TYPE=2 -o node_slave.so, and -DNODE_TYPE=3 -o node_relay.so for a tree)
+ *   gcc -O2 -I. host/NetSim.c CorrelatorBank.c CarrierNco.c TdmaSchedule.c -ldl -lm -o netsim
+ *   ./netsim node_master.so node_slave.so [options], run without arguments for the list
+ * Add -DUSE_TDMA=1 to both node builds for several slaves, or -DUSE_NCO_DOWNMIX=1 -DUSE_FDM_BANK=1 (and the same
+ * -DFDM_CHANNELS to the netsim build), and -DUSE_NCO_DOWNMIX=1 -DCBW=... for another carrier. With
+ * -DUSE_CFAR_THRESHOLD=1 the report ends with each node's trigger counters and noise floor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include "BlockProcessing.h"
+#include "CfarDetector.h"
+#include "CorrelatorBank.h"
+#include "NetSim.h"
+#include "RelayDownlink.h"
+#include "TdmaSchedule.h"
+
+#define SIM_PI 3.14159265358979323846
+
+//Growing list of event times
+typedef struct {
+	double* t;
+	size_t count;
+	size_t size;
+} SimEvents;
+
+//Sync figures of one slave
+typedef struct {
+	size_t count;			// slave ticks after its first correction
+	size_t first;			// first of them after the lock
+	double target;			// offset the slave should hold
+	double lockTime;		// reference time of the lock, -1 for none
+	double mean;
+	double std;
+	double minOffset;
+	double maxOffset;
+	double rms;				// to the target
+	double p95;				// 95th percentile of the distance to the target
+} SimSlaveReport;
+
+static unsigned long long noiseState;
+
+static void addSimEvent(SimEvents* events, double t){
+	if(events->count == events->size){
+		events->size = events->size ? 2*events->size : 256;
+		events->t = (double*) realloc(events->t, events->size*sizeof(double));
+		if(events->t == NULL){
+			printf("ERROR: out of memory\n");
+			exit(1);
+		}
+	}
+	events->t[events->count++] = t;
+}
+
+/**
+ * Gaussian noise sample, xorshift64* and Box-Muller so runs are the same on every host
+ */
+static double gaussianNoise(){
+	double u1, u2;
+
+	do {
+		noiseState ^= noiseState >> 12;
+		noiseState ^= noiseState << 25;
+		noiseState ^= noiseState >> 27;
+		u1 = (double)((noiseState * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+	} while(u1 <= 0.0);
+	noiseState ^= noiseState >> 12;
+	noiseState ^= noiseState << 25;
+	noiseState ^= noiseState >> 27;
+	u2 = (double)((noiseState * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+
+	return sqrt(-2.0*log(u1))*cos(2.0*SIM_PI*u2);
+}
+
+/**
+ * What the sender put on the air, at reference time t, seen through the channel (no noise yet)
+ * @param from	sending node
+ * @param t		reference time at the receiver's ADC input
+ */
+static double channelSample(const SimNode* from, const SimChannel* channel, double t){
+	double u = (t - channel->delay - channel->dacDelay*from->period - from->phase) / from->period;
+	long m0 = (long) floor(u);
+	long m;
+	double x, w, acc = 0.0;
+
+	if(from->lastLoud < m0 - SIM_INTERP_HALF + 1)
+		return 0.0;		// nothing but zeros under the interpolator, most of the time with several slaves
+	for(m = m0 - SIM_INTERP_HALF + 1; m <= m0 + SIM_INTERP_HALF; m++){
+		if(m < 0 || m >= from->n)
+			continue;		// nothing sent yet
+		x = u - m;
+		w = 0.42 + 0.5*cos(SIM_PI*x/SIM_INTERP_HALF) + 0.08*cos(2.0*SIM_PI*x/SIM_INTERP_HALF);	// Blackman
+		if(fabs(x) > 1e-9)
+			w *= sin(SIM_PI*x)/(SIM_PI*x);
+		acc += w*from->history[m & (SIM_HISTORY-1)];
+	}
+	return channel->gain*acc;
+}
+
+static int compareDouble(const void* a, const void* b){
+	double x = *(const double*) a;
+	double y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Copies a shared object to a temporary file, so dlopen loads it once more with its own globals
+ * @param copy	filled with the path of the copy, remove it once it is loaded
+ * @return 0 on success
+ */
+static int copySimLibrary(const char* path, char* copy, size_t size){
+	char buffer[65536];
+	size_t got;
+	FILE* in;
+	FILE* out;
+	int fd;
+
+	snprintf(copy, size, "/tmp/netsim_nodeXXXXXX");
+	fd = mkstemp(copy);
+	if(fd < 0){
+		printf("ERROR: cannot create a copy of %s\n", path);
+		return 1;
+	}
+	in = fopen(path, "rb");
+	out = fdopen(fd, "wb");
+	if(in == NULL || out == NULL){
+		printf("ERROR: cannot copy %s\n", path);
+		if(in != NULL)
+			fclose(in);
+		if(out != NULL)
+			fclose(out);
+		else
+			close(fd);
+		unlink(copy);
+		return 1;
+	}
+	while((got = fread(buffer, 1, sizeof(buffer), in)) > 0)
+		fwrite(buffer, 1, got, out);
+	fclose(in);
+	fclose(out);
+	return 0;
+}
+
+/**
+ * Loads a NODE_TYPE build of the node and looks up what the simulator drives and watches
+ * @param slave			1 for the SLAVE_NODE build, which also exports vclock_correction_pending
+ * @param privateCopy	1 to load from a temporary copy, for a second node of the same build
+ * @return 0 on success
+ */
+int loadSimNode(SimNode* node, const char* path, int slave, int privateCopy){
+	char local[1024];
+	char copy[64];
+
+	memset(node, 0, sizeof(SimNode));
+
+	//dlopen searches the library path for names without a slash
+	if(strchr(path, '/') == NULL){
+		snprintf(local, sizeof(local), "./%s", path);
+		path = local;
+	}
+	if(privateCopy){
+		if(copySimLibrary(path, copy, sizeof(copy)))
+			return 1;
+		node->lib = dlopen(copy, RTLD_NOW | RTLD_LOCAL);
+		unlink(copy);		// stays mapped
+	}
+	else
+		node->lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(node->lib == NULL){
+		printf("ERROR: %s\n", dlerror());
+		return 1;
+	}
+
+	*(void**)(&node->init) = dlsym(node->lib, "nodeInit");
+	*(void**)(&node->background) = dlsym(node->lib, "nodeBackgroundTask");
+	*(void**)(&node->process) = dlsym(node->lib, "process");
+	node->vclockCounter = (volatile short*) dlsym(node->lib, "vclock_counter");
+	node->state = (volatile int*) dlsym(node->lib, "state");
+	node->carrier = (double*) dlsym(node->lib, "carrier_freq");
+	if(slave){
+		node->correctionPending = (volatile short*) dlsym(node->lib, "vclock_correction_pending");
+		node->tdmaSlot = (short*) dlsym(node->lib, "tdma_slot");
+		node->fdmChannel = (short*) dlsym(node->lib, "fdm_channel");
+		node->relayCarrier = (double*) dlsym(node->lib, "relay_carrier");
+		node->upstreamBudget = (float*) dlsym(node->lib, "upstream_error_budget");
+		node->budget = (const float*) dlsym(node->lib, "sync_error_budget");
+		node->hopBudget = (const float*) dlsym(node->lib, "hop_error_budget");
+	}
+
+	if(node->init == NULL || node->background == NULL || node->process == NULL || node->vclockCounter == NULL
+			|| node->state == NULL || (slave && node->correctionPending == NULL)){
+		printf("ERROR: %s is not a %s build of the node\n", path, slave ? "SLAVE_NODE" : "MASTER_NODE");
+		return 1;
+	}
+	return 0;
+}
+
+void initSimChannel(SimChannel* channel){
+	channel->delay = 40.3;			// about 1.7 m at 343 m/s
+	channel->gain = 0.5;
+	channel->noise = 5.0;
+	channel->noiseTo = 5.0;
+	channel->noiseAt = -1.0;		// no step
+	channel->adcDelay = 18.0;		// a guess at the codec filter group delay, set it for the codec in use
+	channel->dacDelay = 18.0;
+	channel->ppmMaster = 0.0;
+	channel->ppmSlave = 50.0;
+	channel->ppmStep = -7.0;
+	channel->slavePhase = 1000.37;
+	channel->phaseStep = 37.1;		// 24 slaves still start within half a tick of the master
+}
+
+void initSimConfig(SimConfig* config){
+	int k;
+
+	config->seconds = 60.0;
+	config->blockFrames = 32;
+	config->lockTolerance = 2.0;
+	config->lockTarget = 0.0;
+	config->autoTarget = 1;
+	config->seed = 1;
+	config->tracePath = NULL;
+	config->slaves = 1;
+	config->expectLock = -1.0;
+	config->expectStd = -1.0;
+	config->expectRate = -1.0;
+	config->tree = 0;
+	for(k = 0; k < SIM_MAX_NODES; k++)
+		config->parent[k] = (k == SIM_MASTER) ? SIM_NO_PARENT : SIM_MASTER;
+	config->relayPath = NULL;
+}
+
+/**
+ * Whether node k hears node j: everyone hears everyone, except in a tree
+ */
+static int simHears(const SimConfig* config, int k, int j){
+	if(!config->tree)
+		return 1;
+	return config->parent[k] == j || config->parent[j] == k || config->parent[k] == config->parent[j];
+}
+
+/**
+ * A copy of a node's event times, analyseSimSlave() overwrites the slave's
+ */
+static void copySimEvents(SimEvents* copy, const SimEvents* events){
+	copy->count = 0;
+	copy->size = 0;
+	copy->t = NULL;
+	while(copy->count < events->count)
+		addSimEvent(copy, events->t[copy->count]);
+}
+
+/**
+ * Offsets of a slave's ticks to the nearest master tick, and its lock and residual offset figures
+ * @param slaveTicks	the slave's tick times, overwritten with the times of the offsets
+ * @param offsets		filled with report->count offsets
+ * @param errors		scratch, as long as offsets
+ */
+static void analyseSimSlave(const SimEvents* masterTicks, SimEvents* slaveTicks, const SimEvents* corrections,
+		const SimConfig* config, double* offsets, double* errors, SimSlaveReport* report){
+	double t, lastBad = -1.0, sum = 0.0, sumSq = 0.0, v;
+	size_t s, m = 0, count = 0, first = 0;
+
+	memset(report, 0, sizeof(SimSlaveReport));
+	report->lockTime = -1.0;
+
+	//offset of every slave tick after the first correction to the nearest master tick
+	for(s = 0; s < slaveTicks->count && corrections->count > 0 && masterTicks->count > 0; s++){
+		t = slaveTicks->t[s];
+		if(t <= corrections->t[0])
+			continue;
+		if(t > masterTicks->t[masterTicks->count-1])
+			break;	// the reference tick after it is past the end of the run, the nearest one is a period off
+		while(m + 1 < masterTicks->count && fabs(masterTicks->t[m+1] - t) <= fabs(masterTicks->t[m] - t))
+			m++;
+		offsets[count] = t - masterTicks->t[m];
+		slaveTicks->t[count] = t;	// keep the tick times of the offsets for the lock search and the trace
+		count++;
+	}
+	report->count = count;
+
+	//the offset the slave should hold, by default where it settles: the median over the second half of the run
+	report->target = config->lockTarget;
+	if(config->autoTarget && count > 0){
+		for(s = count/2; s < count; s++)
+			errors[s - count/2] = offsets[s];
+		qsort(errors, count - count/2, sizeof(double), compareDouble);
+		report->target = errors[(count - count/2)/2];
+	}
+
+	//locked from the first tick after which every tick stays within the tolerance of the target. Corrections are no
+	//use for this, the clock tracker hardly corrects once its skew is taken out between the exchanges.
+	for(s = 0; s < count; s++){
+		if(fabs(offsets[s] - report->target) > config->lockTolerance)
+			lastBad = slaveTicks->t[s];
+	}
+	for(s = 0; s < count; s++){
+		if(slaveTicks->t[s] > lastBad){
+			report->lockTime = slaveTicks->t[s];
+			break;
+		}
+	}
+	while(first < count && report->lockTime >= 0.0 && slaveTicks->t[first] < report->lockTime)
+		first++;
+	if(first == count){
+		report->lockTime = -1.0;	// no tick left to show the lock
+		first = 0;
+	}
+	report->first = first;
+
+	for(s = first; s < count; s++){
+		sum += offsets[s];
+		sumSq += (offsets[s] - report->target)*(offsets[s] - report->target);
+		if(s == first || offsets[s] < report->minOffset)
+			report->minOffset = offsets[s];
+		if(s == first || offsets[s] > report->maxOffset)
+			report->maxOffset = offsets[s];
+		errors[s - first] = fabs(offsets[s] - report->target);
+	}
+
+	count -= first;
+	if(count > 0){
+		qsort(errors, count, sizeof(double), compareDouble);
+		report->mean = sum/count;
+		v = sumSq/count - (report->mean - report->target)*(report->mean - report->target);
+		report->std = sqrt(v > 0.0 ? v : 0.0);
+		report->rms = sqrt(sumSq/count);
+		report->p95 = errors[(size_t)(0.95*(count-1))];
+	}
+}
+
+/**
+ * The master's slot table, when the master build has one
+ */
+static void printSimSlots(const SimNode* master, int slaves){
+	const TdmaSlot* slots = (const TdmaSlot*) dlsym(master->lib, "tdma_slots");
+	const unsigned short* offSlot = (const unsigned short*) dlsym(master->lib, "tdma_off_slot");
+	int slot;
+
+	if(slots == NULL)
+		return;
+	printf("master slots:        slot, pulses, replies, silent, arrival (newest), arrival spread (newest %d)\n",
+			TDMA_HISTORY/2);
+	for(slot = 0; slot < slaves; slot++)
+		printf("  %2d %8u %8u %7u %+12.2f %10.4f samples\n", slot, slots[slot].pulses, slots[slot].replies,
+				slots[slot].silent, slots[slot].historyCount ? slots[slot].arrival[slots[slot].historyIndex] : 0.0,
+				tdmaArrivalSpread(&slots[slot], TDMA_HISTORY/2));
+	if(offSlot != NULL)
+		printf("  pulses between slots: %u\n", *offSlot);
+}
+
+/**
+ * Holds a slave's or a tree node's figures against -expect-lock and -expect-std
+ * @param what	"slave" or "node", and
+ * @param index	its number in the report, for the message
+ * @return 1 if it missed one of them
+ */
+static int simMissesExpectations(const SimConfig* config, const char* what, int index, const SimSlaveReport* report){
+	if(config->expectLock >= 0.0 && (report->lockTime < 0.0 || report->lockTime/SIM_SAMPLE_FREQ > config->expectLock)){
+		printf("EXPECTED %s %d to lock within %.1f s\n", what, index, config->expectLock);
+		return 1;
+	}
+	if(config->expectStd >= 0.0 && (report->count <= report->first || report->std > config->expectStd)){
+		printf("EXPECTED %s %d to hold a std of %.4f samples or less\n", what, index, config->expectStd);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * The master's channel table, when the master build has the correlator bank
+ */
+static void printSimChannels(const SimNode* master, int slaves){
+	const FdmChannel* channels = (const FdmChannel*) dlsym(master->lib, "fdm_channels");
+	int ch;
+
+	if(channels == NULL)
+		return;
+	printf("master channels:     channel, pulses, replies, silent, late, arrival (newest), "
+			"arrival spread (newest %d)\n", FDM_HISTORY/2);
+	for(ch = 0; ch < slaves && ch < FDM_CHANNELS; ch++)
+		printf("  %2d %8u %8u %7u %5u %+12.2f %10.4f samples\n", ch, channels[ch].pulses, channels[ch].replies,
+				channels[ch].silent, channels[ch].late,
+				channels[ch].historyCount ? channels[ch].arrival[channels[ch].historyIndex] : 0.0,
+				fdmArrivalSpread(&channels[ch], FDM_HISTORY/2));
+}
+
+/**
+ * Trigger counters and noise floor of every node, when the node builds have the adaptive threshold
+ */
+static void printSimSearch(const SimNode nodes[], int nodeCount){
+	const CfarDetector* cfar;
+	int k;
+
+	if(dlsym(nodes[SIM_MASTER].lib, "search_cfar") == NULL)
+		return;
+	printf("search (CFAR):       node, triggers, validated, rejected, noise floor, threshold\n");
+	for(k = 0; k < nodeCount; k++){
+		cfar = (const CfarDetector*) dlsym(nodes[k].lib, "search_cfar");
+		if(cfar == NULL)
+			continue;
+		if(k == SIM_MASTER)
+			printf("  master   ");
+		else
+			printf("  slave %2d ", k - SIM_SLAVE);
+		printf("%8lu %8lu %8lu %12.0f %12.0f\n", cfar->triggers, cfar->validated, cfar->rejected, cfar->floor,
+				cfar->threshold);
+	}
+}
+
+/**
+ * Sync figures of every node of a tree against its parent and against the master, then per depth
+ * @param offsets	scratch, one more than the most ticks of any node
+ * @param errors	same
+ * @param trace		gets the offset of every tick to the master, or NULL
+ * @return nodes that missed -expect-lock or -expect-std against the master
+ */
+static int printSimTree(const SimNode nodes[], const SimEvents ticks[], const SimEvents corrections[],
+		const long transmits[], const SimChannel* channel, const SimConfig* config, double* offsets, double* errors,
+		FILE* trace){
+	SimEvents copy;
+	SimSlaveReport hop, root;
+	const RelayDownlink* downlink;
+	double lockSum[SIM_MAX_NODES], stdSum[SIM_MAX_NODES], budgetSum[SIM_MAX_NODES];
+	int members[SIM_MAX_NODES], locked[SIM_MAX_NODES];
+	int nodeCount = config->slaves + 1;
+	int k, d, maxDepth = 0, missed = 0;
+	size_t s;
+
+	memset(lockSum, 0, sizeof(lockSum));
+	memset(stdSum, 0, sizeof(stdSum));
+	memset(budgetSum, 0, sizeof(budgetSum));
+	memset(members, 0, sizeof(members));
+	memset(locked, 0, sizeof(locked));
+	for(k = SIM_SLAVE; k < nodeCount; k++){
+		if(nodes[k].depth > maxDepth)
+			maxDepth = nodes[k].depth;
+	}
+
+	printf("tree:                %d nodes below the master, depth %d, master carrier %.4f\n", config->slaves, maxDepth,
+			nodes[SIM_MASTER].downlink);
+	printf("node parent depth role     ppm  pulses  lock s  hop std  master std  master 95%%  budget  hop budget\n");
+	for(k = SIM_SLAVE; k < nodeCount; k++){
+		copySimEvents(&copy, &ticks[k]);
+		analyseSimSlave(&ticks[config->parent[k]], &copy, &corrections[k], config, offsets, errors, &hop);
+		free(copy.t);
+		copySimEvents(&copy, &ticks[k]);
+		analyseSimSlave(&ticks[SIM_MASTER], &copy, &corrections[k], config, offsets, errors, &root);
+		if(trace != NULL){
+			for(s = 0; s < root.count; s++)
+				fprintf(trace, "%d,%d,%.6f,%.4f,%.3f\n", k, nodes[k].depth, copy.t[s]/SIM_SAMPLE_FREQ, offsets[s],
+						offsets[s]*1e6/SIM_SAMPLE_FREQ);
+		}
+		free(copy.t);
+
+		printf("%4d %6d %5d %-5s %+6.1f %7ld ", k, config->parent[k], nodes[k].depth,
+				nodes[k].relayCarrier != NULL ? "relay" : "slave", channel->ppmSlave + (k - SIM_SLAVE)*channel->ppmStep,
+				transmits[k]);
+		if(root.lockTime >= 0.0)
+			printf("%7.1f ", root.lockTime/SIM_SAMPLE_FREQ);
+		else
+			printf("   none ");
+		printf("%8.4f %10.4f %11.4f ", hop.count > hop.first ? hop.std : 0.0, root.count > root.first ? root.std : 0.0,
+				root.count > root.first ? root.p95 : 0.0);
+		if(nodes[k].budget != NULL)
+			printf("%7.4f %11.4f\n", *nodes[k].budget, *nodes[k].hopBudget);
+		else
+			printf("      -           -\n");
+
+		d = nodes[k].depth;
+		members[d]++;
+		if(root.lockTime >= 0.0){
+			locked[d]++;
+			lockSum[d] += root.lockTime/SIM_SAMPLE_FREQ;
+			stdSum[d] += root.std;
+		}
+		if(nodes[k].budget != NULL)
+			budgetSum[d] += *nodes[k].budget;
+		missed += simMissesExpectations(config, "node", k, &root);
+	}
+
+	printf("per depth:           depth, nodes, locked, mean lock s, mean master std, mean budget (locked nodes)\n");
+	for(d = 1; d <= maxDepth; d++){
+		printf("  %2d %6d %7d ", d, members[d], locked[d]);
+		if(locked[d] > 0)
+			printf("%12.2f %16.4f %12.4f\n", lockSum[d]/locked[d], stdSum[d]/locked[d], budgetSum[d]/members[d]);
+		else
+			printf("        none\n");
+	}
+
+	printf("relay downlinks:     node, carrier, captures, replies, silent\n");
+	for(k = SIM_SLAVE; k < nodeCount; k++){
+		downlink = (const RelayDownlink*) dlsym(nodes[k].lib, "relay_downlink");
+		if(downlink != NULL && nodes[k].relayCarrier != NULL)
+			printf("  %2d %9.4f %9lu %8lu %7lu\n", k, *nodes[k].relayCarrier, downlink->captures, downlink->replies,
+					downlink->silent);
+	}
+	return missed;
+}
+
+/**
+ * Replies the master with the correlator bank sent, its node state never leaves searching
+ * @return -1 for a master without the bank
+ */
+static long countSimChannelReplies(const SimNode* master){
+	const FdmChannel* channels = (const FdmChannel*) dlsym(master->lib, "fdm_channels");
+	long replies = 0;
+	int ch;
+
+	if(channels == NULL)
+		return -1;
+	for(ch = 0; ch < FDM_CHANNELS; ch++)
+		replies += channels[ch].replies;
+	return replies;
+}
+
+/**
+ * Runs the master and config->slaves slaves against the channel and prints the sync report
+ * @param nodes		the master, then the slaves
+ * @return 0 on success, 1 if the nodes could not run or missed -expect-lock, -expect-std or -expect-rate
+ */
+int runNetSim(SimNode nodes[], const SimChannel* channel, const SimConfig* config){
+	SimEvents ticks[SIM_MAX_NODES];
+	SimEvents corrections[SIM_MAX_NODES];
+	SimSlaveReport report;
+	double* offsets;
+	double* errors;
+	double end = config->seconds*SIM_SAMPLE_FREQ;
+	double t, tNext, v;
+	short in[FRAME_CHANNELS];
+	short out[FRAME_CHANNELS];
+	short pending;
+	long slaveTransmits[SIM_MAX_NODES];
+	long masterReplies = 0;
+	long channelReplies;
+	int nodeCount = config->slaves + 1;
+	int missed = 0;
+	int k, j;
+	size_t s, longest = 0;
+	clock_t wallStart;
+	double wall;
+	FILE* trace = NULL;
+
+	memset(ticks, 0, sizeof(ticks));
+	memset(corrections, 0, sizeof(corrections));
+	memset(slaveTransmits, 0, sizeof(slaveTransmits));
+	noiseState = 0x9E3779B97F4A7C15ULL ^ config->seed;
+
+	if(channel->delay + channel->adcDelay + channel->dacDelay < SIM_INTERP_HALF + 1){
+		printf("ERROR: the path delay must be at least %d samples for the interpolator\n", SIM_INTERP_HALF + 1);
+		return 1;
+	}
+
+	for(k = 0; k < nodeCount; k++){
+		if(k == SIM_MASTER){
+			nodes[k].period = 1.0/(1.0 + channel->ppmMaster*1e-6);
+			nodes[k].phase = 0.0;
+		}
+		else {
+			nodes[k].period = 1.0/(1.0 + (channel->ppmSlave + (k - SIM_SLAVE)*channel->ppmStep)*1e-6);
+			nodes[k].phase = channel->slavePhase + (k - SIM_SLAVE)*channel->phaseStep;
+			if(nodes[k].tdmaSlot != NULL)
+				*nodes[k].tdmaSlot = (short)(k - SIM_SLAVE);
+			if(nodes[k].fdmChannel != NULL)
+				*nodes[k].fdmChannel = (short)(k - SIM_SLAVE);
+		}
+		if(config->tree){
+			//the slot among the siblings, the carrier of the hop up, and for a relay the one down
+			if(nodes[k].tdmaSlot != NULL){
+				*nodes[k].tdmaSlot = 0;
+				for(j = SIM_SLAVE; j < k; j++)
+					*nodes[k].tdmaSlot += (config->parent[j] == config->parent[k]);
+			}
+			*nodes[k].carrier = nodes[k == SIM_MASTER ? SIM_MASTER : config->parent[k]].downlink;
+			if(nodes[k].relayCarrier != NULL)
+				*nodes[k].relayCarrier = nodes[k].downlink;
+		}
+		nodes[k].n = 0;
+		nodes[k].lastLoud = -1;
+		nodes[k].init();
+		nodes[k].lastState = *nodes[k].state;
+		nodes[k].lastClock = *nodes[k].vclockCounter;
+		if(k != SIM_MASTER)
+			slaveTransmits[k] = (nodes[k].lastState == SIM_STATE_TRANSMIT);
+	}
+
+	wallStart = clock();
+	while(1){
+		//step whichever node samples next
+		k = SIM_MASTER;
+		t = nodes[SIM_MASTER].phase + nodes[SIM_MASTER].n*nodes[SIM_MASTER].period;
+		for(j = SIM_SLAVE; j < nodeCount; j++){
+			tNext = nodes[j].phase + nodes[j].n*nodes[j].period;
+			if(tNext < t){
+				k = j;
+				t = tNext;
+			}
+		}
+		if(t >= end)
+			break;
+
+		v = 0.0;
+		for(j = 0; j < nodeCount; j++){
+			if(j != k && simHears(config, k, j))
+				v += channelSample(&nodes[j], channel, t - channel->adcDelay*nodes[k].period);
+		}
+		if(channel->noiseAt >= 0.0 && t >= channel->noiseAt*SIM_SAMPLE_FREQ)
+			v += channel->noiseTo*gaussianNoise();
+		else
+			v += channel->noise*gaussianNoise();
+		v = floor(v + 0.5);
+		if(v > 32767.0)
+			v = 32767.0;
+		else if(v < -32768.0)
+			v = -32768.0;
+		memset(in, 0, sizeof(in));
+		in[SIM_SINC_CHANNEL] = (short) v;
+
+		pending = nodes[k].correctionPending ? *nodes[k].correctionPending : 0;
+		nodes[k].process(in, out, 1);
+		nodes[k].history[nodes[k].n & (SIM_HISTORY-1)] = out[SIM_SINC_CHANNEL];
+		if(out[SIM_SINC_CHANNEL] != 0)
+			nodes[k].lastLoud = nodes[k].n;
+		nodes[k].n++;
+
+		if(*nodes[k].vclockCounter < nodes[k].lastClock)
+			addSimEvent(&ticks[k], t + channel->dacDelay*nodes[k].period);
+		nodes[k].lastClock = *nodes[k].vclockCounter;
+		if(pending && !*nodes[k].correctionPending)
+			addSimEvent(&corrections[k], t);
+		if(*nodes[k].state != nodes[k].lastState){
+			if(k != SIM_MASTER && *nodes[k].state == SIM_STATE_TRANSMIT)
+				slaveTransmits[k]++;
+			if(k == SIM_MASTER && *nodes[k].state == SIM_STATE_SENDSINC)
+				masterReplies++;
+			nodes[k].lastState = *nodes[k].state;
+		}
+
+		if(nodes[k].n % config->blockFrames == 0){
+			nodes[k].background();
+			j = config->parent[k];
+			if(config->tree && j != SIM_MASTER && j != SIM_NO_PARENT && nodes[k].upstreamBudget != NULL
+					&& nodes[j].budget != NULL)
+				*nodes[k].upstreamBudget = *nodes[j].budget;
+		}
+	}
+	wall = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+	channelReplies = countSimChannelReplies(&nodes[SIM_MASTER]);
+	if(channelReplies >= 0)
+		masterReplies = channelReplies;
+
+	for(k = SIM_SLAVE; k < nodeCount; k++){
+		if(ticks[k].count > longest)
+			longest = ticks[k].count;
+	}
+	offsets = (double*) malloc((longest + 1)*sizeof(double));
+	errors = (double*) malloc((longest + 1)*sizeof(double));
+	if(offsets == NULL || errors == NULL){
+		printf("ERROR: out of memory\n");
+		return 1;
+	}
+
+	if(config->tracePath != NULL){
+		trace = fopen(config->tracePath, "w");
+		if(trace == NULL)
+			printf("ERROR: cannot open %s\n", config->tracePath);
+		else if(config->tree)
+			fprintf(trace, "node,depth,time_s,offset_samples,offset_us\n");
+		else if(config->slaves > 1)
+			fprintf(trace, "slave,time_s,offset_samples,offset_us\n");
+		else
+			fprintf(trace, "time_s,offset_samples,offset_us\n");
+	}
+
+	printf("simulated:           %.1f s in %.2f s wall (%.0fx real time)\n", config->seconds, wall,
+			wall > 0.0 ? config->seconds/wall : 0.0);
+	printf("channel:             delay %.2f, adc %.2f, dac %.2f samples, gain %.3f, noise %.1f LSB\n",
+			channel->delay, channel->adcDelay, channel->dacDelay, channel->gain, channel->noise);
+	if(channel->noiseAt >= 0.0)
+		printf("                     noise %.1f LSB from %.1f s on\n", channel->noiseTo, channel->noiseAt);
+	printf("clocks:              master %+.1f ppm, slave %+.1f ppm, slave starts at %.2f samples\n",
+			channel->ppmMaster, channel->ppmSlave, channel->slavePhase);
+	if(config->slaves > 1)
+		printf("                     each further slave %+.1f ppm and %.2f samples later\n", channel->ppmStep,
+				channel->phaseStep);
+	if(config->tree)
+		missed = printSimTree(nodes, ticks, corrections, slaveTransmits, channel, config, offsets, errors, trace);
+	else if(config->slaves > 1){
+		printf("slaves:              %d, slave k in %s k\n", config->slaves,
+				nodes[SIM_SLAVE].fdmChannel != NULL ? "FDM channel" : "TDMA slot");
+		printf("master replies:      %ld\n", masterReplies);
+		printf("exchanges per s:     %.3f (%.3f per slave)\n", masterReplies/config->seconds,
+				masterReplies/config->seconds/config->slaves);
+		printf("slave   ppm  pulses  lock s  ticks       mean      std      95%%      max to target\n");
+	}
+
+	for(k = SIM_SLAVE; k < nodeCount && !config->tree; k++){
+		analyseSimSlave(&ticks[SIM_MASTER], &ticks[k], &corrections[k], config, offsets, errors, &report);
+
+		if(trace != NULL){
+			for(s = 0; s < report.count; s++){
+				if(config->slaves > 1)
+					fprintf(trace, "%d,", k - SIM_SLAVE);
+				fprintf(trace, "%.6f,%.4f,%.3f\n", ticks[k].t[s]/SIM_SAMPLE_FREQ, offsets[s],
+						offsets[s]*1e6/SIM_SAMPLE_FREQ);
+			}
+		}
+
+		if(config->slaves > 1){
+			printf("%5d %+6.1f %6ld ", k - SIM_SLAVE, channel->ppmSlave + (k - SIM_SLAVE)*channel->ppmStep,
+					slaveTransmits[k]);
+			if(report.lockTime >= 0.0)
+				printf("%7.1f ", report.lockTime/SIM_SAMPLE_FREQ);
+			else
+				printf("   none ");
+			if(report.count > report.first)
+				printf("%6lu %+10.4f %8.4f %8.4f %8.4f\n", (unsigned long)(report.count - report.first), report.mean,
+						report.std, report.p95, fabs(report.maxOffset - report.target) > fabs(report.minOffset - report.target)
+						? fabs(report.maxOffset - report.target) : fabs(report.minOffset - report.target));
+			else
+				printf("     0\n");
+			missed += simMissesExpectations(config, "slave", k - SIM_SLAVE, &report);
+			continue;
+		}
+
+		printf("slave pulses sent:   %ld\n", slaveTransmits[k]);
+		printf("master replies:      %ld\n", masterReplies);
+		printf("slave corrections:   %lu\n", (unsigned long) corrections[k].count);
+		printf("exchanges per s:     %.3f\n", masterReplies/config->seconds);
+		printf("lock target:         %+.4f samples (%s)\n", report.target,
+				config->autoTarget ? "where the offset settles" : "-target");
+		if(report.lockTime >= 0.0)
+			printf("time to lock:        %.3f s (within %.2f samples of the target from then on)\n",
+					report.lockTime/SIM_SAMPLE_FREQ, config->lockTolerance);
+		else
+			printf("time to lock:        no lock (within %.2f samples of the target)\n", config->lockTolerance);
+
+		if(report.count > report.first){
+			printf("residual offset:     %lu ticks %s\n", (unsigned long)(report.count - report.first),
+					report.lockTime >= 0.0 ? "after lock" : "after the first correction");
+			printf("  mean               %+.4f samples (%+.3f us)\n", report.mean, report.mean*1e6/SIM_SAMPLE_FREQ);
+			printf("  std                %.4f samples (%.3f us)\n", report.std, report.std*1e6/SIM_SAMPLE_FREQ);
+			printf("  min / max          %+.4f / %+.4f samples\n", report.minOffset, report.maxOffset);
+			printf("  rms to target      %.4f samples (%.3f us)\n", report.rms, report.rms*1e6/SIM_SAMPLE_FREQ);
+			printf("  95%% to target      %.4f samples (%.3f us)\n", report.p95, report.p95*1e6/SIM_SAMPLE_FREQ);
+		}
+		else {
+			printf("residual offset:     no slave ticks after a correction\n");
+		}
+		missed += simMissesExpectations(config, "slave", k - SIM_SLAVE, &report);
+	}
+	if(config->expectRate >= 0.0 && masterReplies/config->seconds/config->slaves > config->expectRate){
+		printf("EXPECTED %.3f exchanges per s and slave or less\n", config->expectRate);
+		missed++;
+	}
+	if(config->slaves > 1 && !config->tree){
+		printSimSlots(&nodes[SIM_MASTER], config->slaves);
+		printSimChannels(&nodes[SIM_MASTER], config->slaves);
+	}
+	printSimSearch(nodes, nodeCount);
+
+	if(trace != NULL)
+		fclose(trace);
+	free(offsets);
+	free(errors);
+	for(k = 0; k < nodeCount; k++){
+		free(ticks[k].t);
+		free(corrections[k].t);
+	}
+	return missed != 0;
+}
+
+static void printUsage(const char* name){
+	printf("usage: %s master.so slave.so [options]\n", name);
+	printf("  -seconds s     simulated time (60)\n");
+	printf("  -delay d       propagation delay in samples (40.3)\n");
+	printf("  -gain g        path gain (0.5)\n");
+	printf("  -noise n       AWGN standard deviation in LSB (5)\n");
+	printf("  -noise-to n    AWGN standard deviation from -noise-at on (5)\n");
+	printf("  -noise-at s    time of the noise step in seconds (none)\n");
+	printf("  -adc d         codec ADC filter delay in samples (18)\n");
+	printf("  -dac d         codec DAC filter delay in samples (18)\n");
+	printf("  -ppm-master p  master clock drift in ppm (0)\n");
+	printf("  -ppm-slave p   slave clock drift in ppm (50)\n");
+	printf("  -phase t       slave start time in samples (1000.37)\n");
+	printf("  -block n       frames between background tasks (32)\n");
+	printf("  -tol t         lock tolerance in samples (2)\n");
+	printf("  -target o      offset the slave should hold in samples (default: where it settles)\n");
+	printf("  -seed n        noise seed (1)\n");
+	printf("  -trace file    write the offset of every slave tick as csv\n");
+	printf("  -slaves n      number of slaves, 1 to %d, more than one needs USE_TDMA or USE_FDM_BANK\n"
+			"                 builds (1)\n", SIM_MAX_SLAVES);
+	printf("  -ppm-step p    drift of each further slave against the one before (-7)\n");
+	printf("  -phase-step t  start of each further slave after the one before, in samples (37.1)\n");
+	printf("  -expect-lock s exit with 1 if a slave locks later than s seconds or not at all (no check)\n");
+	printf("  -expect-std o  exit with 1 if a slave's std after lock is above o samples (no check)\n");
+	printf("  -expect-rate r exit with 1 above r exchanges per s and slave (no check)\n");
+	printf("  -tree p,p,...  parent of node 1, 2, ... (0 is the master, a parent before its children), nodes with\n"
+			"                 children are relays. Replaces -slaves.\n");
+	printf("  -relay r.so    RELAY_NODE build for the relays of the tree\n");
+}
+
+/**
+ * Reads the parent list of -tree into config, nodes only ever hang from an earlier node
+ * @return 0 on success
+ */
+static int parseSimTree(SimConfig* config, const char* list){
+	const char* p = list;
+	char* end;
+	long parent;
+	int k = SIM_SLAVE;
+
+	while(*p != '\0'){
+		parent = strtol(p, &end, 10);
+		if(end == p || k >= SIM_MAX_NODES || parent < SIM_MASTER || parent >= k)
+			return 1;
+		config->parent[k++] = (int) parent;
+		p = (*end == ',') ? end + 1 : end;
+		if(*end != ',' && *end != '\0')
+			return 1;
+	}
+	config->slaves = k - SIM_SLAVE;
+	config->tree = 1;
+	return config->slaves < 1;
+}
+
+int main(int argc, char** argv){
+	static const double carriers[SIM_CARRIER_COUNT] = SIM_CARRIERS;
+	SimNode* nodes;
+	SimChannel channel;
+	SimConfig config;
+	int a, k, relays;
+	int result;
+
+	if(argc < 3){
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	initSimChannel(&channel);
+	initSimConfig(&config);
+	for(a = 3; a + 1 < argc; a += 2){
+		if(strcmp(argv[a], "-seconds") == 0)			config.seconds = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-delay") == 0)		channel.delay = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-gain") == 0)			channel.gain = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-noise") == 0)		channel.noise = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-noise-to") == 0)		channel.noiseTo = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-noise-at") == 0)		channel.noiseAt = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-adc") == 0)			channel.adcDelay = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-dac") == 0)			channel.dacDelay = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-ppm-master") == 0)	channel.ppmMaster = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-ppm-slave") == 0)	channel.ppmSlave = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-phase") == 0)		channel.slavePhase = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-block") == 0)		config.blockFrames = (size_t) atoi(argv[a+1]);
+		else if(strcmp(argv[a], "-tol") == 0)			config.lockTolerance = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-target") == 0){
+			config.lockTarget = atof(argv[a+1]);
+			config.autoTarget = 0;
+		}
+		else if(strcmp(argv[a], "-seed") == 0)			config.seed = strtoul(argv[a+1], NULL, 10);
+		else if(strcmp(argv[a], "-trace") == 0)		config.tracePath = argv[a+1];
+		else if(strcmp(argv[a], "-slaves") == 0)		config.slaves = atoi(argv[a+1]);
+		else if(strcmp(argv[a], "-ppm-step") == 0)		channel.ppmStep = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-phase-step") == 0)	channel.phaseStep = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-expect-lock") == 0)	config.expectLock = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-expect-std") == 0)	config.expectStd = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-expect-rate") == 0)	config.expectRate = atof(argv[a+1]);
+		else if(strcmp(argv[a], "-relay") == 0)		config.relayPath = argv[a+1];
+		else if(strcmp(argv[a], "-tree") == 0){
+			if(parseSimTree(&config, argv[a+1])){
+				printUsage(argv[0]);
+				return 1;
+			}
+		}
+		else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+	if(a < argc || config.slaves < 1 || config.slaves > SIM_MAX_SLAVES){
+		printUsage(argv[0]);
+		return 1;
+	}
+	if(config.blockFrames == 0)
+		config.blockFrames = 1;
+
+	nodes = (SimNode*) calloc(config.slaves + 1, sizeof(SimNode));
+	if(nodes == NULL)
+		return 1;
+	if(loadSimNode(&nodes[SIM_MASTER], argv[1], 0, 0))
+		return 1;
+	relays = 0;
+	nodes[SIM_MASTER].downlink = carriers[relays++];
+	for(k = SIM_SLAVE; k <= config.slaves && config.tree; k++){
+		for(a = k + 1; a <= config.slaves && config.parent[a] != k; a++)
+			;
+		if(a <= config.slaves && config.relayPath == NULL){
+			printf("ERROR: node %d has children, give a RELAY_NODE build with -relay\n", k);
+			return 1;
+		}
+		if(loadSimNode(&nodes[k], a <= config.slaves ? config.relayPath : argv[2], 1, 1))
+			return 1;
+		nodes[k].depth = nodes[config.parent[k]].depth + 1;
+		if(a <= config.slaves && nodes[k].relayCarrier == NULL){
+			printf("ERROR: %s is not a RELAY_NODE build of the node\n", config.relayPath);
+			return 1;
+		}
+		if(a <= config.slaves && relays == SIM_CARRIER_COUNT){
+			printf("ERROR: more than %d relays, there are no carriers left\n", SIM_CARRIER_COUNT - 1);
+			return 1;
+		}
+		if(a <= config.slaves)
+			nodes[k].downlink = carriers[relays++];
+		if(dlsym(nodes[k].lib, "nco_downmix") == NULL || dlsym(nodes[SIM_MASTER].lib, "nco_downmix") == NULL){
+			printf("ERROR: the hops of a tree are on different carriers, build the nodes with -DUSE_NCO_DOWNMIX=1 "
+					"-DUSE_FUSED_DOWNMIX=0\n");
+			return 1;
+		}
+		for(a = SIM_SLAVE; a < k && config.parent[a] != config.parent[k]; a++)
+			;
+		if(a < k && (nodes[k].tdmaSlot == NULL || nodes[k].fdmChannel != NULL)){
+			printf("ERROR: node %d has siblings, build the slaves and relays with -DUSE_TDMA=1\n", k);
+			return 1;
+		}
+	}
+	for(k = SIM_SLAVE; k <= config.slaves && !config.tree; k++){
+		if(loadSimNode(&nodes[k], argv[2], 1, k > SIM_SLAVE))
+			return 1;
+		if(config.slaves > 1 && nodes[k].tdmaSlot == NULL && nodes[k].fdmChannel == NULL){
+			printf("ERROR: %s has no slots or channels, build the nodes with -DUSE_TDMA=1 or -DUSE_FDM_BANK=1 for "
+					"several slaves\n", argv[2]);
+			return 1;
+		}
+		if(nodes[k].fdmChannel != NULL && config.slaves > FDM_CHANNELS){
+			printf("ERROR: %d slaves but only %d FDM channels\n", config.slaves, FDM_CHANNELS);
+			return 1;
+		}
+	}
+
+	result = runNetSim(nodes, &channel, &config);
+
+	for(k = 0; k <= config.slaves; k++)
+		dlclose(nodes[k].lib);
+	free(nodes);
+	return result;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file 	NetSim.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the closed-loop master/slave simulator in NetSim.c
+ *
+ * Times are in nominal sample periods (1/8000 s) of a reference clock that neither node has. Node 0 is the master,
+ * nodes 1 on are the slaves. In a tree (-tree) nodes 1 on have a parent each, and the ones with children are relays.
+ */
+
+#ifndef NETSIM_H_
+#define NETSIM_H_
+
+#include <stddef.h>
+
+#define SIM_SAMPLE_FREQ		8000.0
+#define SIM_MAX_SLAVES		24
+#define SIM_MAX_NODES		(SIM_MAX_SLAVES+1)
+#define SIM_MASTER			0
+#define SIM_SLAVE			1			// the first slave
+
+#define SIM_HISTORY			(1<<14)		// output samples kept per node for the channel, must cover the path delay
+#define SIM_INTERP_HALF		16			// half length of the windowed sinc that resamples between the node clocks
+
+//same values as the state definitions in time_stamper_master.c
+#define SIM_STATE_TRANSMIT	3
+#define SIM_STATE_SENDSINC	4
+
+//TRANSMIT_SINC and RECEIVE_SINC in time_stamper_master.c, the channel carried over the air
+#define SIM_SINC_CHANNEL	0
+
+//Tree of relays: the master serves its children on the first carrier and each relay on the next one, so no node
+//hears two parents on the same carrier. 0.06 apart, far enough for NCO_COHERENCE.
+#define SIM_NO_PARENT		(-1)
+#define SIM_CARRIERS		{0.25, 0.13, 0.37, 0.19, 0.31, 0.07, 0.43}
+#define SIM_CARRIER_COUNT	7
+
+//Acoustic channel, the same between every pair of nodes and in both directions
+typedef struct {
+	double delay;			// propagation delay in samples
+	double gain;			// path gain
+	double noise;			// AWGN standard deviation in LSB
+	double noiseTo;			// AWGN from noiseAt on, a machine starting up
+	double noiseAt;			// time of the step in seconds, negative for none
+	double adcDelay;		// codec ADC filter delay in samples of the receiving node
+	double dacDelay;		// codec DAC filter delay in samples of the sending node
+	double ppmMaster;		// clock drift in ppm, positive is fast
+	double ppmSlave;		// drift of the first slave
+	double ppmStep;			// drift of each further slave against the one before
+	double slavePhase;		// reference time at which the first slave takes its first sample
+	double phaseStep;		// start of each further slave after the one before
+} SimChannel;
+
+//Simulation and report settings
+typedef struct {
+	double seconds;			// simulated time
+	size_t blockFrames;		// nodeBackgroundTask() runs after this many frames, like HOST_BLOCK_FRAMES
+	double lockTolerance;	// the slave is locked while the offset stays within this many samples of the target
+	double lockTarget;		// offset the slave should hold, in samples
+	int autoTarget;			// take the target from where the offset settles instead of lockTarget
+	unsigned long seed;		// noise seed, runs are reproducible
+	const char* tracePath;	// per slave clock tick offsets (csv), NULL for none
+	int slaves;				// 1 to SIM_MAX_SLAVES, more than one needs USE_TDMA or USE_FDM_BANK builds
+	double expectLock;		// the run fails if a slave locks later than this many seconds or never, negative for none
+	double expectStd;		// the run fails if a slave's std after lock is above this many samples, negative for none
+	double expectRate;		// the run fails above this many exchanges per second and slave, negative for none
+	int tree;				// nodes only hear their parent, their children and their siblings
+	int parent[SIM_MAX_NODES];	// parent of each node in a tree, SIM_NO_PARENT for the master
+	const char* relayPath;	// RELAY_NODE build for the nodes with children
+} SimConfig;
+
+//One loaded node (a NODE_TYPE build of time_stamper_master.c as a shared object)
+typedef struct {
+	void* lib;
+	void (*init)();
+	void (*background)();
+	void (*process)(const short* in, short* out, size_t frames);
+	volatile short* vclockCounter;
+	volatile int* state;
+	volatile short* correctionPending;	// slave only
+	short* tdmaSlot;					// slave with USE_TDMA only
+	short* fdmChannel;					// slave with USE_FDM_BANK only
+	double* carrier;					// carrier_freq, set before nodeInit() in a tree
+	double* relayCarrier;				// relay only, relay_carrier
+	float* upstreamBudget;				// slave or relay with USE_CLOCK_TRACKER only, the parent's budget goes here
+	const float* budget;				// sync_error_budget, same builds
+	const float* hopBudget;				// hop_error_budget
+	int depth;							// hops from the master
+	double downlink;					// carrier the node serves its children on, master and relays
+
+	double period;			// sample period in reference samples
+	double phase;			// reference time of sample 0
+	long n;					// samples run so far
+	short history[SIM_HISTORY];	// what the node sent on TRANSMIT_SINC
+	long lastLoud;			// newest sample in history that is not 0, -1 for none
+	int lastState;
+	short lastClock;		// vclock_counter after the previous sample, a drop is a tick
+} SimNode;
+
+//Setup Functions
+int loadSimNode(SimNode* node, const char* path, int slave, int privateCopy);
+void initSimChannel(SimChannel* channel);
+void initSimConfig(SimConfig* config);
+
+//Simulation
+int runNetSim(SimNode nodes[], const SimChannel* channel, const SimConfig* config);
+
+
+#endif /* NETSIM_H_ */
@@ -0,0 +1,148 @@
+/**
+ * @file 	SampleIOHost.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Linux sample I/O backend: runs the node over memory buffers or raw stereo files
+ *
+ * Files are headerless interleaved 16 bit stereo at 8 kHz (sox -t raw -r 8000 -e signed -b 16 -c 2), frame layout
+ * as in BlockProcessing.h. The node is processed block by block, and nodeBackgroundTask() runs
+ * after each block the way the main loop runs between interrupts on the DSK.
+ *
+ * Build from the project root, NODE_TYPE 1 for the master and 2 for the slave (3 for a relay, with RelayDownlink.c
+ * and -DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0):
+ *   gcc -O2 -DNODE_TYPE=1 -I. host/SampleIOHost.c time_stamper_master.c CycleProfiler.c EventQueue.c ClockTracker.c
+ *       CarrierNco.c CfarDetector.c CorrelatorBank.c FastCorrelation.c PhaseEstimation.c PulseScheduler.c
+ *       PulseSynthesis.c StreamEstimator.c TdmaSchedule.c WaveformBank.c -lm -o node_master
+ *   ./node_master in.raw out.raw [block frames]
+ * With -DUSE_CYCLE_PROFILER=1 the profiler table (CycleProfiler.c) is printed after the run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "BlockProcessing.h"
+#include "CycleProfiler.h"
+#include "SampleIOHost.h"
+
+/**
+ * Runs the node over a whole recording in memory
+ * @param in			frames into the node
+ * @param out			frames out of the node, same length as in
+ * @param frames		number of frames
+ * @param blockFrames	frames handed to process() at a time
+ */
+void runMemoryBackend(const short* in, short* out, size_t frames, size_t blockFrames){
+	size_t done = 0;
+	size_t block;
+
+	while(done < frames){
+		block = frames - done;
+		if(block > blockFrames)
+			block = blockFrames;
+		process(in + done*FRAME_CHANNELS, out + done*FRAME_CHANNELS, block);
+		nodeBackgroundTask();
+		done += block;
+	}
+}
+
+/**
+ * Reads a raw stereo recording, runs the node over it and writes what the node sent to the codec
+ * @return 0 on success
+ */
+int runFileBackend(const char* inPath, const char* outPath, size_t blockFrames){
+	FILE* fin;
+	FILE* fout;
+	long bytes;
+	size_t frames;
+	short* in;
+	short* out;
+
+	fin = fopen(inPath, "rb");
+	if(fin == NULL){
+		printf("ERROR: cannot open %s\n", inPath);
+		return 1;
+	}
+	fseek(fin, 0, SEEK_END);
+	bytes = ftell(fin);
+	fseek(fin, 0, SEEK_SET);
+	frames = (size_t) bytes / (FRAME_CHANNELS*sizeof(short));
+
+	in = (short*) malloc(frames*FRAME_CHANNELS*sizeof(short) + 1);
+	out = (short*) malloc(frames*FRAME_CHANNELS*sizeof(short) + 1);
+	if(in == NULL || out == NULL || fread(in, FRAME_CHANNELS*sizeof(short), frames, fin) != frames){
+		printf("ERROR: cannot read %s\n", inPath);
+		fclose(fin);
+		free(in);
+		free(out);
+		return 1;
+	}
+	fclose(fin);
+
+	runMemoryBackend(in, out, frames, blockFrames);
+
+	fout = fopen(outPath, "wb");
+	if(fout == NULL){
+		printf("ERROR: cannot open %s\n", outPath);
+		free(in);
+		free(out);
+		return 1;
+	}
+	fwrite(out, FRAME_CHANNELS*sizeof(short), frames, fout);
+	fclose(fout);
+
+	free(in);
+	free(out);
+	return 0;
+}
+
+/**
+ * No LEDs or debug pins on the host
+ */
+void indicatorLedOn(short led){
+	(void) led;
+}
+
+void indicatorLedOff(short led){
+	(void) led;
+}
+
+void ToggleDebugGPIO(short IONum){
+	(void) IONum;
+}
+
+/**
+ * Profiler time base, the monotonic clock in ns
+ */
+profile_tick_t profilerTimerRead(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (profile_tick_t)(ts.tv_sec*1000000000ull + ts.tv_nsec);
+}
+
+unsigned long profilerTimerHz(){
+	return 1000000000ul;
+}
+
+#ifndef SAMPLEIO_HOST_NO_MAIN
+int main(int argc, char** argv){
+	size_t blockFrames = HOST_BLOCK_FRAMES;
+
+	if(argc < 3){
+		printf("usage: %s in.raw out.raw [block frames]\n", argv[0]);
+		return 1;
+	}
+	if(argc > 3)
+		blockFrames = (size_t) atoi(argv[3]);
+	if(blockFrames == 0)
+		blockFrames = 1;
+
+	nodeInit();
+	if(runFileBackend(argv[1], argv[2], blockFrames))
+		return 1;
+#if (USE_CYCLE_PROFILER)
+	profilerReport();
+#endif
+	return 0;
+}
+#endif
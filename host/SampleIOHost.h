@@ -0,0 +1,22 @@
+/**
+ * @file 	SampleIOHost.h
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	header for the memory and file backed sample I/O in SampleIOHost.c
+ */
+
+#ifndef SAMPLEIOHOST_H_
+#define SAMPLEIOHOST_H_
+
+#include <stddef.h>
+
+#define HOST_BLOCK_FRAMES 32	// default block size, same as DMA_BLOCK_FRAMES on the DSK
+
+//Memory backend
+void runMemoryBackend(const short* in, short* out, size_t frames, size_t blockFrames);
+
+//File backend
+int runFileBackend(const char* inPath, const char* outPath, size_t blockFrames);
+
+
+#endif /* SAMPLEIOHOST_H_ */
@@ -0,0 +1,308 @@
+/**
+ * @file 	TableGen.c
+ * @author 	spinlab
+ * @date	OCT 17, 2026
+ * @brief 	Host generator for the node's pulse and filter tables, PulseTables.h and WaveformBankTable.h
+ *
+ * The node source is compiled into this file, like into host/KernelBench.c, so the tables come from the same formulas
+ * (setupTransmitBuffer(), the Setup functions and storeDelayedWaveformRow()) with the same N, M, BW, CBW, MAXDELAY and
+ * switches as the node build. Those are the keys written into the headers; nodeInit() only uses tables that fit.
+ *   tables PulseTables.h		transmit pulses, matched filters and the baseband reference (USE_GENERATED_TABLES)
+ *   bank WaveformBankTable.h	the compressed delayed pulse bank (WAVEBANK_PREBUILT, for USE_PULSE_SYNTH 0)
+ *   check						compares the tables this binary was built with to the formulas, entry by entry
+ *
+ * Build and run from the project root with the node's flags, for example:
+ *   gcc -O2 -DUSE_GENERATED_TABLES=0 -DSAMPLEIO_HOST_NO_MAIN -I. host/TableGen.c host/SampleIOHost.c CycleProfiler.c
+ *       EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c CorrelatorBank.c FastCorrelation.c PhaseEstimation.c
+ *       PulseScheduler.c PulseSynthesis.c TdmaSchedule.c WaveformBank.c -lm -o tablegen
+ *       && ./tablegen tables PulseTables.h && ./tablegen bank WaveformBankTable.h
+ * then again without -DUSE_GENERATED_TABLES=0 and with -DWAVEBANK_PREBUILT=1, and ./tablegen check. It exits with 1
+ * if a table differs from its formula or does not fit the build.
+ */
+
+#include "time_stamper_master.c"
+
+#include <string.h>
+
+#define GEN_STR(x)		#x
+#define GEN_KEY(x)		GEN_STR(x)		// BW and CBW as they are spelled, so the keys compare equal to them
+#define GEN_PER_LINE	12				// table entries per line
+#if (USE_FIXED_POINT)
+#define GEN_COEFS_PER_LINE	GEN_PER_LINE
+#else
+#define GEN_COEFS_PER_LINE	6				// floats are longer
+#endif
+
+#if (!WAVEBANK_PREBUILT)
+static short genRow[WAVEBANK_ROW_INPUT_LEN];	// one padded bank row
+#endif
+#if (WAVEBANK_PREBUILT && WAVEBANK_HALF_LEN == N && WAVEBANK_RESOLUTION == MAXDELAY)
+static short genCheckRow[N2];					// formula pulse for the bank check
+#endif
+
+/**
+ * Writes a float so that it reads back as the same float
+ */
+static void genFloat(FILE* out, float value){
+	char text[32];
+
+	sprintf(text, "%.9g", value);
+	if(strpbrk(text, ".en") == NULL)
+		strcat(text, ".0");
+	fprintf(out, "%sf", text);
+}
+
+/**
+ * Writes the entries of a table, GEN_PER_LINE to a line
+ * @param decl	declaration the initializer belongs to
+ */
+static void genShorts(FILE* out, const char* decl, const short* table, long len){
+	long idx;
+
+	fprintf(out, "%s = {", decl);
+	for(idx = 0; idx < len; idx++)
+		fprintf(out, "%s%d,", (idx % GEN_PER_LINE) ? " " : "\n\t", table[idx]);
+	fprintf(out, "\n};\n\n");
+}
+
+static void genCoefs(FILE* out, const char* decl, const coef_t* table, long len){
+	long idx;
+
+	fprintf(out, "%s = {", decl);
+	for(idx = 0; idx < len; idx++){
+		fprintf(out, "%s", (idx % GEN_COEFS_PER_LINE) ? " " : "\n\t");
+#if (USE_FIXED_POINT)
+		fprintf(out, "%d", table[idx]);
+#else
+		genFloat(out, table[idx]);
+#endif
+		fprintf(out, ",");
+	}
+	fprintf(out, "\n};\n\n");
+}
+
+/**
+ * Sets the tables up from the formulas, as nodeInit() does without PulseTables.h
+ */
+static void genRuntimeTables(){
+	setupTransmitBuffer(standardWaveformBuffer, N, BW, carrier_freq, 0.0);
+	setupTransmitBuffer(delayedWaveformBuffer, N, BW, carrier_freq, 0.0);
+	SetupReceiveTrigonometricMatchedFilters();
+	SetupReceiveBasebandSincPulseBuffer();
+	SetupTransmitModulatedSincPulseBuffer();
+	SetupTransmitModulatedSincPulseBufferDelayed();
+}
+
+static int genPulseTables(const char* path){
+	FILE* out;
+
+	out = fopen(path, "w");
+	if(out == NULL){
+		printf("ERROR: cannot open %s\n", path);
+		return 1;
+	}
+	genRuntimeTables();
+
+	fprintf(out, "/**\n * @file \tPulseTables.h\n");
+	fprintf(out, " * @brief \tPulse and filter tables for N %d, M %d, BW %s, CBW %s, generated by host/TableGen.c\n",
+			N, M, GEN_KEY(BW), GEN_KEY(CBW));
+	fprintf(out, " *\n * Do not edit, generate it again. Included once, by time_stamper_master.c. nodeInit() only uses the "
+			"tables if the\n * keys below fit the build and the carrier, it computes them otherwise.\n */\n\n");
+	fprintf(out, "#ifndef PULSETABLES_H_\n#define PULSETABLES_H_\n\n");
+	fprintf(out, "#define PULSE_TABLES_N %d\n", N);
+	fprintf(out, "#define PULSE_TABLES_M %d\n", M);
+	fprintf(out, "#define PULSE_TABLES_BW %s\n", GEN_KEY(BW));
+	fprintf(out, "#define PULSE_TABLES_CBW %s\n", GEN_KEY(CBW));
+	fprintf(out, "#define PULSE_TABLES_FIXED_POINT %d\n", USE_FIXED_POINT);
+	fprintf(out, "#define PULSE_TABLES_PEAK %d\n", MODULATED_SINC_PEAK);
+	fprintf(out, "#define PULSE_TABLES_N2 (2*PULSE_TABLES_N + 1)\n\n");
+
+	fprintf(out, "//setupTransmitBuffer() at delay 0, standardWaveformBuffer and delayedWaveformBuffer\n");
+	genShorts(out, "const short pulseTableStandard[PULSE_TABLES_N2]", standardWaveformBuffer, N2);
+	fprintf(out, "//tModulatedSincPulse\n");
+	genShorts(out, "const short pulseTableModulatedSinc[PULSE_TABLES_N2]", tModulatedSincPulse, N2);
+	fprintf(out, "//tModulatedSincPulse_delayed\n");
+	genShorts(out, "const short pulseTableModulatedSincDelayed[PULSE_TABLES_N2]", tModulatedSincPulse_delayed, N2);
+	fprintf(out, "//basebandSincRef and basebandSincEnergy\n");
+	genCoefs(out, "const coef_t pulseTableBasebandSinc[PULSE_TABLES_N2]", basebandSincRef, 2*N+1);
+	fprintf(out, "const float pulseTableBasebandSincEnergy = ");
+	genFloat(out, basebandSincEnergy);
+	fprintf(out, ";\n\n");
+	fprintf(out, "//matchedFilterCosine and matchedFilterSine\n");
+	genCoefs(out, "const coef_t pulseTableMatchedCosine[PULSE_TABLES_M]", matchedFilterCosine, M);
+	genCoefs(out, "const coef_t pulseTableMatchedSine[PULSE_TABLES_M]", matchedFilterSine, M);
+	fprintf(out, "\n#endif /* PULSETABLES_H_ */\n");
+
+	fclose(out);
+	printf("%s: N %d, M %d, BW %s, CBW %s\n", path, N, M, GEN_KEY(BW), GEN_KEY(CBW));
+	return 0;
+}
+
+static int genWaveformBank(const char* path){
+#if (WAVEBANK_PREBUILT)
+	printf("ERROR: built with WAVEBANK_PREBUILT, the bank is only filled at run time without it\n");
+	return 1;
+#elif (WAVEBANK_HALF_LEN != N || WAVEBANK_RESOLUTION != MAXDELAY)
+	printf("ERROR: WaveformBank.h is set up for a different N or MAXDELAY\n");
+	return 1;
+#else
+	FILE* out;
+	short row, idx;
+	int misfits = 0;
+
+	for(row = 0; row < WAVEBANK_ROWS; row++){
+		setupTransmitBuffer(genRow, N+1, BW, carrier_freq, ((double) row) / MAXDELAY);
+		misfits += storeDelayedWaveformRow(row, genRow);
+	}
+	if(misfits != 0){
+		printf("ERROR: %d samples do not fit the bank format, it needs the fs/4 carrier\n", misfits);
+		return 1;
+	}
+
+	out = fopen(path, "w");
+	if(out == NULL){
+		printf("ERROR: cannot open %s\n", path);
+		return 1;
+	}
+	fprintf(out, "/**\n * @file \tWaveformBankTable.h\n");
+	fprintf(out, " * @brief \tDelayed pulse bank for N %d, MAXDELAY %d, BW %s, CBW %s, generated by host/TableGen.c\n",
+			N, MAXDELAY, GEN_KEY(BW), GEN_KEY(CBW));
+	fprintf(out, " *\n * Do not edit, generate it again. Included by WaveformBank.c with WAVEBANK_PREBUILT, in the "
+			"format\n * storeDelayedWaveformRow() fills the bank in.\n */\n\n");
+	fprintf(out, "#ifndef WAVEFORMBANKTABLE_H_\n#define WAVEFORMBANKTABLE_H_\n\n");
+	fprintf(out, "#define WAVEBANK_TABLE_HALF_LEN %d\n", N);
+	fprintf(out, "#define WAVEBANK_TABLE_RESOLUTION %d\n", MAXDELAY);
+	fprintf(out, "#define WAVEBANK_TABLE_BW %s\n", GEN_KEY(BW));
+	fprintf(out, "#define WAVEBANK_TABLE_CBW %s\n\n", GEN_KEY(CBW));
+
+	//read back through delayedWaveformSample(), rows up to WAVEBANK_RESOLUTION/2 are not mirrored
+	fprintf(out, "static const BANK_FAR short bankRight[WAVEBANK_ROWS][WAVEBANK_HALF_LEN + 2] = {\n");
+	for(row = 0; row < WAVEBANK_ROWS; row++){
+		fprintf(out, "{");
+		for(idx = 0; idx <= N + 1; idx++)
+			fprintf(out, "%s%d,", (idx % GEN_PER_LINE) ? " " : "\n\t", delayedWaveformSample(row, idx));
+		fprintf(out, "\n},\n");
+	}
+	fprintf(out, "};\n\n");
+	fprintf(out, "static const BANK_FAR short bankCore[WAVEBANK_ROWS][WAVEBANK_CORE_LEN] = {\n");
+	for(row = 0; row < WAVEBANK_ROWS; row++){
+		fprintf(out, "{");
+		for(idx = 1; idx <= WAVEBANK_CORE_LEN; idx++)
+			fprintf(out, "%s%d,", ((idx - 1) % GEN_PER_LINE) ? " " : "\n\t", delayedWaveformSample(row, -idx));
+		fprintf(out, "\n},\n");
+	}
+	fprintf(out, "};\n\n");
+	fprintf(out, "static const BANK_FAR signed char bankTail[WAVEBANK_ROWS][WAVEBANK_TAIL_LEN] = {\n");
+	for(row = 0; row < WAVEBANK_ROWS; row++){
+		fprintf(out, "{");
+		for(idx = WAVEBANK_CORE_LEN + 1; idx <= N; idx++)
+			fprintf(out, "%s%d,", ((idx - WAVEBANK_CORE_LEN - 1) % GEN_PER_LINE) ? " " : "\n\t",
+					(idx & 1) ? delayedWaveformSample(row, -idx) + delayedWaveformSample(row, idx)
+							: delayedWaveformSample(row, -idx) - delayedWaveformSample(row, idx));
+		fprintf(out, "\n},\n");
+	}
+	fprintf(out, "};\n\n#endif /* WAVEFORMBANKTABLE_H_ */\n");
+
+	fclose(out);
+	printf("%s: N %d, MAXDELAY %d, BW %s, CBW %s\n", path, N, MAXDELAY, GEN_KEY(BW), GEN_KEY(CBW));
+	return 0;
+#endif
+}
+
+#if (PULSE_TABLES_FIT)
+/**
+ * Counts the entries of a generated table that differ from the formula
+ */
+static long genDiffShorts(const char* name, const short* table, const short* formula, long len){
+	long idx, differ = 0;
+
+	for(idx = 0; idx < len; idx++)
+		if(table[idx] != formula[idx])
+			differ++;
+	printf("  %-32s %5ld entries, %ld differ\n", name, len, differ);
+	return differ;
+}
+
+static long genDiffCoefs(const char* name, const coef_t* table, const coef_t* formula, long len){
+	long idx, differ = 0;
+
+	for(idx = 0; idx < len; idx++)
+		if(table[idx] != formula[idx])
+			differ++;
+	printf("  %-32s %5ld entries, %ld differ\n", name, len, differ);
+	return differ;
+}
+#endif
+
+static int genCheck(){
+	long differ = 0;
+	short checked = 0;
+#if (WAVEBANK_PREBUILT && WAVEBANK_HALF_LEN == N && WAVEBANK_RESOLUTION == MAXDELAY)
+	short index, i;
+	long bankDiffer = 0;
+#endif
+
+#if (PULSE_TABLES_FIT)
+	nodeInit();
+	if(!pulse_tables_used){
+		printf("PulseTables.h is for BW %s and CBW %s, not this node's pulse\n", GEN_KEY(PULSE_TABLES_BW),
+				GEN_KEY(PULSE_TABLES_CBW));
+		return 1;
+	}
+	genRuntimeTables();
+	printf("PulseTables.h against the formulas:\n");
+	differ += genDiffShorts("standardWaveformBuffer", pulseTableStandard, standardWaveformBuffer, N2);
+	differ += genDiffShorts("delayedWaveformBuffer", pulseTableStandard, delayedWaveformBuffer, N2);
+	differ += genDiffShorts("tModulatedSincPulse", pulseTableModulatedSinc, tModulatedSincPulse, N2);
+	differ += genDiffShorts("tModulatedSincPulse_delayed", pulseTableModulatedSincDelayed, tModulatedSincPulse_delayed,
+			N2);
+	differ += genDiffCoefs("basebandSincRef", pulseTableBasebandSinc, basebandSincRef, 2*N+1);
+	printf("  %-32s %5d entries, %d differ\n", "basebandSincEnergy", 1,
+			pulseTableBasebandSincEnergy != basebandSincEnergy);
+	differ += (pulseTableBasebandSincEnergy != basebandSincEnergy);
+	differ += genDiffCoefs("matchedFilterCosine", pulseTableMatchedCosine, matchedFilterCosine, M);
+	differ += genDiffCoefs("matchedFilterSine", pulseTableMatchedSine, matchedFilterSine, M);
+	checked++;
+#elif (USE_GENERATED_TABLES)
+	printf("PulseTables.h is for N %d, M %d, USE_FIXED_POINT %d, peak %d, not this build\n", PULSE_TABLES_N,
+			PULSE_TABLES_M, PULSE_TABLES_FIXED_POINT, PULSE_TABLES_PEAK);
+	return 1;
+#endif
+
+#if (WAVEBANK_PREBUILT && WAVEBANK_HALF_LEN == N && WAVEBANK_RESOLUTION == MAXDELAY)
+	if(prebuiltWaveformBankMisfits(BW, CBW) != 0){
+		printf("WaveformBankTable.h is for BW %s and CBW %s, not this node's pulse\n", GEN_KEY(WAVEBANK_TABLE_BW),
+				GEN_KEY(WAVEBANK_TABLE_CBW));
+		return 1;
+	}
+	//every delay the node reads, also the mirrored ones, against the row of the old allMyDelayedWaveforms table
+	for(index = 0; index < MAXDELAY; index++){
+		setupTransmitBuffer(genCheckRow, N, BW, CBW, ((double) index) / MAXDELAY);
+		for(i = -N; i <= N; i++)
+			if(delayedWaveformSample(index, i) != genCheckRow[i + N])
+				bankDiffer++;
+	}
+	printf("WaveformBankTable.h against the formula:\n  %-32s %5ld entries, %ld differ\n", "delayedWaveformSample",
+			(long) MAXDELAY*N2, bankDiffer);
+	differ += bankDiffer;
+	checked++;
+#endif
+
+	if(!checked){
+		printf("built without USE_GENERATED_TABLES and WAVEBANK_PREBUILT, nothing to check\n");
+		return 1;
+	}
+	return differ != 0;
+}
+
+int main(int argc, char** argv){
+	if(argc == 3 && strcmp(argv[1], "tables") == 0)
+		return genPulseTables(argv[2]);
+	if(argc == 3 && strcmp(argv[1], "bank") == 0)
+		return genWaveformBank(argv[2]);
+	if(argc == 2 && strcmp(argv[1], "check") == 0)
+		return genCheck();
+
+	printf("usage: %s tables PulseTables.h | bank WaveformBankTable.h | check\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,43 @@
+#!/bin/sh
+# Builds host/KernelBench.c for each benchmark configuration and appends its rows to a csv file, from the project
+# root: sh host/bench.sh [results.csv] [shortest timed run in ms]
+# Compare the rows of a configuration with an earlier run of the same file to spot a regression.
+
+CSV=${1:-bench.csv}
+MS=${2:-20}
+OUT=${TMPDIR:-/tmp}/node-bench
+SRCS="host/SampleIOHost.c CycleProfiler.c EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c
+	CorrelatorBank.c FastCorrelation.c PhaseEstimation.c PulseScheduler.c PulseSynthesis.c TdmaSchedule.c WaveformBank.c"
+FAILED=0
+mkdir -p $OUT
+
+# kernelbench results.csv [node flags]: host/KernelBench.c, every kernel
+kernelbench(){
+	RESULTS=$1
+	shift
+	echo "== kernelbench $*"
+	gcc -O2 "$@" -DSAMPLEIO_HOST_NO_MAIN -I. host/KernelBench.c $SRCS -lm -o $OUT/kernelbench \
+		&& $OUT/kernelbench $RESULTS $MS || FAILED=$((FAILED+1))
+}
+
+kernelbench $CSV -DN=256 -DM=32
+kernelbench $CSV -DN=512 -DM=60
+kernelbench $CSV -DN=1024 -DM=120
+kernelbench $CSV -DN=512 -DM=60 -DUSE_FUSED_DOWNMIX=0
+kernelbench $CSV -DN=512 -DM=60 -DUSE_NCO_DOWNMIX=1 -DCBW=0.1875
+kernelbench $CSV -DN=512 -DM=60 -DUSE_FIXED_POINT=1
+kernelbench $CSV -DN=512 -DM=60 -DUSE_PULSE_SYNTH=0
+
+# the frequency division bank at 1 to 16 channels, and its cost per channel: the least squares slope of the
+# fdm_search_bank row over the channel count
+rm -f $OUT/fdm.csv
+for k in 1 2 4 8 16; do
+	kernelbench $OUT/fdm.csv -DN=512 -DM=60 -DFDM_CHANNELS=$k
+done
+awk -F, '$1 == "fdm_search_bank" { n++; x += $18; y += $13; xx += $18*$18; xy += $18*$13 }
+	END { if (n > 1) printf "fdm_search_bank: %.2f ns per sample and channel\n", (n*xy - x*y)/(n*xx - x*x) }' \
+	$OUT/fdm.csv
+if [ -s $CSV ]; then tail -n +2 $OUT/fdm.csv >> $CSV; else cp $OUT/fdm.csv $CSV; fi
+
+echo "$FAILED failed, rows in $CSV"
+[ $FAILED -eq 0 ]
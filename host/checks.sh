@@ -0,0 +1,122 @@
+#!/bin/sh
+# Builds and runs the host checks of the node, from the project root: sh host/checks.sh
+# Each check and NetSim run is built with the switches it is about and exits with 1 on a failure, the script counts
+# the failures and exits with 1 if there were any. The binaries go to $TMPDIR/node-checks.
+
+OUT=${TMPDIR:-/tmp}/node-checks
+SRCS="host/SampleIOHost.c CycleProfiler.c EventQueue.c ClockTracker.c CarrierNco.c CfarDetector.c
+	CorrelatorBank.c FastCorrelation.c PhaseEstimation.c PulseScheduler.c PulseSynthesis.c TdmaSchedule.c WaveformBank.c"
+NODE_SRCS="time_stamper_master.c $SRCS RelayDownlink.c StreamEstimator.c"
+FAILED=0
+mkdir -p $OUT
+gcc -O2 -I. host/NetSim.c CorrelatorBank.c CarrierNco.c TdmaSchedule.c -ldl -lm -o $OUT/netsim || FAILED=$((FAILED+1))
+
+# kernelcheck [node flags]: host/KernelCheck.c, every check, built as a slave
+kernelcheck(){
+	echo "== kernelcheck $*"
+	gcc -O2 -DNODE_TYPE=2 "$@" -DSAMPLEIO_HOST_NO_MAIN -I. host/KernelCheck.c $SRCS -lm -o $OUT/kernelcheck \
+		&& $OUT/kernelcheck || FAILED=$((FAILED+1))
+}
+
+# blocks: host/SampleIOHost.c runs a slave over 20 s of silence, a master over what the slave sent and the slave over
+# the master's replies, in blocks of 1, 7 and 32 frames. The block size must not change a sample of the output.
+blocks(){
+	echo "== blocks"
+	gcc -O2 -DNODE_TYPE=1 -I. $NODE_SRCS -lm -o $OUT/node_master \
+		&& gcc -O2 -DNODE_TYPE=2 -I. $NODE_SRCS -lm -o $OUT/node_slave \
+		&& head -c $((20*8000*4)) /dev/zero > $OUT/silence.raw || { FAILED=$((FAILED+1)); return; }
+	for b in 1 7 32; do
+		$OUT/node_slave $OUT/silence.raw $OUT/slave$b.raw $b \
+			&& $OUT/node_master $OUT/slave1.raw $OUT/master$b.raw $b \
+			&& $OUT/node_slave $OUT/master1.raw $OUT/reply$b.raw $b \
+			&& cmp $OUT/slave1.raw $OUT/slave$b.raw && cmp $OUT/master1.raw $OUT/master$b.raw \
+			&& cmp $OUT/reply1.raw $OUT/reply$b.raw || { echo "FAILED: blocks $b"; FAILED=$((FAILED+1)); }
+	done
+}
+
+# pipeline: a master over the slave's first pulse (a), the same pulse 2048 frames later (b) and both (ab), where the
+# second one arrives while the master is still busy with the first. It has to answer both, each as it answers it alone.
+pipeline(){
+	echo "== pipeline"
+	F=4		# bytes per frame
+	head -c $((16000*F)) $OUT/slave1.raw > $OUT/a.raw \
+		&& head -c $((2048*F)) $OUT/silence.raw >> $OUT/a.raw \
+		&& { head -c $((2048*F)) $OUT/silence.raw; head -c $((16000*F)) $OUT/slave1.raw; } > $OUT/b.raw \
+		&& { head -c $((3000*F)) $OUT/a.raw; tail -c +$((3000*F+1)) $OUT/b.raw; } > $OUT/ab.raw \
+		&& $OUT/node_master $OUT/a.raw $OUT/master_a.raw \
+		&& $OUT/node_master $OUT/b.raw $OUT/master_b.raw \
+		&& $OUT/node_master $OUT/ab.raw $OUT/master_ab.raw \
+		&& { head -c $((9000*F)) $OUT/master_a.raw; tail -c +$((9000*F+1)) $OUT/master_b.raw; } > $OUT/expect_ab.raw \
+		&& cmp $OUT/expect_ab.raw $OUT/master_ab.raw || { echo "FAILED: pipeline"; FAILED=$((FAILED+1)); }
+}
+
+# tablegen: host/TableGen.c generates the waveform bank, then checks it and the PulseTables.h in the tree against the
+# formulas
+tablegen(){
+	echo "== tablegen"
+	gcc -O2 -DUSE_GENERATED_TABLES=0 -DSAMPLEIO_HOST_NO_MAIN -I. host/TableGen.c $SRCS -lm -o $OUT/tablegen \
+		&& $OUT/tablegen bank $OUT/WaveformBankTable.h \
+		&& gcc -O2 -DWAVEBANK_PREBUILT=1 -DSAMPLEIO_HOST_NO_MAIN -I$OUT -I. host/TableGen.c $SRCS -lm -o $OUT/tablegen \
+		&& $OUT/tablegen check || FAILED=$((FAILED+1))
+}
+
+# capanalyze: host/CaptureAnalyzer.c on what a slave sends over 600 s of silence, one pulse per clock period with no
+# reply, 293 of them on the same clock. A single chunk and 7 s chunks on 4 threads have to find the same pulses.
+capanalyze(){
+	echo "== capanalyze"
+	gcc -O2 -DNODE_TYPE=2 -I. $NODE_SRCS -lm -o $OUT/node_slave \
+		&& gcc -O2 -pthread -DSAMPLEIO_HOST_NO_MAIN -I. host/CaptureAnalyzer.c $SRCS -lm -o $OUT/capanalyze \
+		&& head -c $((600*8000*4)) /dev/zero > $OUT/silence.raw \
+		&& $OUT/node_slave $OUT/silence.raw $OUT/slave.raw \
+		&& $OUT/capanalyze $OUT/slave.raw $OUT/pulses1.csv -chunk 0 \
+		&& $OUT/capanalyze $OUT/slave.raw $OUT/pulses.csv -chunk 7 -threads 4 \
+		&& cmp $OUT/pulses1.csv $OUT/pulses.csv \
+		&& awk -F, 'NR > 1 { n++; v += $9; c[$7] } END { for (k in c) d++; exit !(n == 293 && v == n && d == 1) }' \
+			$OUT/pulses.csv || { echo "FAILED: capanalyze"; FAILED=$((FAILED+1)); }
+}
+
+# netsim "node flags" [netsim options]: host/NetSim.c on a master and a slave build, and a relay build for -tree. The
+# options should hold the run to -expect-lock and -expect-std.
+netsim(){
+	FLAGS=$1
+	shift
+	echo "== netsim $FLAGS $*"
+	TYPES="1 2"
+	RELAY=
+	case " $* " in *" -tree "*) TYPES="1 2 3"; RELAY="-relay $OUT/node3.so";; esac
+	for t in $TYPES; do
+		gcc -O2 -shared -fPIC -DNODE_TYPE=$t $FLAGS -DSAMPLEIO_HOST_NO_MAIN -I. $NODE_SRCS -lm -o $OUT/node$t.so \
+			|| { FAILED=$((FAILED+1)); return; }
+	done
+	$OUT/netsim $OUT/node1.so $OUT/node2.so $RELAY "$@" || FAILED=$((FAILED+1))
+}
+
+kernelcheck
+kernelcheck -DUSE_FUSED_DOWNMIX=0
+kernelcheck -DUSE_PULSE_SYNTH=0
+kernelcheck -DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0 -DCBW=0.1875
+kernelcheck -DUSE_PULSE_SYNTH=0 -DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0 -DCBW=0.1875
+kernelcheck -DUSE_FIXED_POINT=1
+kernelcheck -DN=256 -DM=32
+kernelcheck -fsanitize=address,undefined -fno-sanitize-recover=all
+blocks
+pipeline
+tablegen
+capanalyze
+
+netsim "" -seconds 300 -expect-lock 2 -expect-std 0.45 -expect-rate 0.1
+netsim "" -seconds 300 -noise 12 -expect-lock 2 -expect-std 0.45
+netsim -DUSE_CLOCK_TRACKER=0 -seconds 300 -expect-lock 2 -expect-std 0.5
+netsim -DUSE_CLOCK_TRACKER=0 -seconds 300 -noise 12 -expect-lock 260 -expect-std 0.5
+netsim -DUSE_TDMA=1 -slaves 8 -seconds 300 -expect-lock 45 -expect-std 0.7
+netsim -DUSE_STREAM_ESTIMATOR=1 -seconds 300 -expect-lock 2 -expect-std 0.45
+netsim "-DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0 -DCBW=0.13" -seconds 300 -expect-lock 2 -expect-std 0.4
+netsim "-DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0 -DCBW=0.37" -seconds 300 -expect-lock 2 -expect-std 0.4
+netsim "-DUSE_NCO_DOWNMIX=1 -DUSE_FDM_BANK=1" -slaves 4 -seconds 120 -expect-lock 30 -expect-std 0.6
+netsim -DUSE_CFAR_THRESHOLD=1 -seconds 300 -noise 80 -expect-lock 2 -expect-std 0.45
+netsim -DUSE_CFAR_THRESHOLD=1 -seconds 300 -noise 5 -noise-to 80 -noise-at 30 -expect-lock 2 -expect-std 0.6
+netsim "-DUSE_NCO_DOWNMIX=1 -DUSE_FUSED_DOWNMIX=0 -DUSE_TDMA=1" -tree 0,0,1,1,2,2 -seconds 300 -expect-lock 120 \
+	-expect-std 0.7
+
+echo "$FAILED failed"
+[ $FAILED -eq 0 ]
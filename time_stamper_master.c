@@ -24,15 +24,18 @@
 //Board node definitions
 #define MASTER_NODE 1
 #define SLAVE_NODE 	2
+#define RELAY_NODE	3		// a slave to its parent on CBW and a master to its children on RELAY_CBW (RelayDownlink.c)
 
 //Node type - This changes whether setting
+#ifndef NODE_TYPE
 #define NODE_TYPE MASTER_NODE
-
-//Audio codec sample frequency
-#define DSK_SAMPLE_FREQ DSK6713_AIC23_FREQ_8KHZ
+#endif
+#define SLAVE_ROLE (NODE_TYPE == SLAVE_NODE || NODE_TYPE == RELAY_NODE)	// keeps its clock against a parent
 
 // length of searching window in samples
+#ifndef M
 #define M 60
+#endif
 
 // threshold value for searching window
 #define T1 100000
@@ -42,7 +45,9 @@
 //#define BW 0.0250
 
 // 2*N+1 is the number of samples in the sinc function
+#ifndef N
 #define N (1<<9) //512
+#endif
 #define N2 ((N<<1)+1) //1025
 
 #define CALC_TIME	384		// measured on the scope
@@ -52,7 +57,7 @@
 // virtual clock counter maximum
 #if (NODE_TYPE == MASTER_NODE)
 #define VCLK_MAX (1<<12)	//4096
-#elif (NODE_TYPE == SLAVE_NODE)
+#elif (SLAVE_ROLE)
 #define VCLK_MAX (1<<12) //4096
 #endif
 
@@ -60,7 +65,6 @@
 //#define SLAVE_PULSE_COUNTER_MAX (VCLK_MAX*2)
 
 #define CLOCK_WRAP(i) ((i)&(VCLK_MAX-1)) // index wrapping macro
-#define INDEX_WRAP(x) ((x)&((VCLK_MAX*BUF_SIZE)-1))
 
 // max lag for computing correlations
 #define MAXLAG 200
@@ -71,7 +75,6 @@
 
 //Response buffer size in samples
 #define OUTPUT_BUF_SIZE (2*N+1)
-#define BUF_SIZE		4
 // maximum sample value
 #define MAXSAMP 32767;
 
@@ -95,111 +98,276 @@
 #define PI 3.14159265358979323846
 #define INVPI 0.318309886183791
 
-//gpio registers
-#define GPIO_ENABLE_ADDRESS		0x01B00000
-#define GPIO_DIRECTION_ADDRESS	0x01B00004
-#define GPIO_VALUE_ADDRESS		0x01B00008
-
 #define MAXDELAY 100	// this should be renamed to RESOLUTION_OF_FINE_DELAY_ESTIMATE
+
+//N, M and the USE_ switches below can be overridden from the compiler command line (host builds, host/KernelBench.c)
+
+//If synthesize delayed pulses on the fly (PulseSynthesis.c) instead of the delayed waveform bank (WaveformBank.c)
+#ifndef USE_PULSE_SYNTH
+#define USE_PULSE_SYNTH 1
+#endif
+
+//If use the FFT matched filter instead of the direct form correlation
+#ifndef USE_FFT_CORRELATOR
+#define USE_FFT_CORRELATOR 0
+#endif
+
+//If mix down with the table oscillator (CarrierNco.c) so CBW can be any carrier. Without it the downmix, the search
+//and the fine estimate are the fs/4 special cases and CBW has to stay 0.25.
+#ifndef USE_NCO_DOWNMIX
+#define USE_NCO_DOWNMIX 0
+#endif
+
+//If correlate straight from recbuf using the fs/4 mixing pattern (no downMixedCosine/downMixedSine buffers)
+#ifndef USE_FUSED_DOWNMIX
+#define USE_FUSED_DOWNMIX (!USE_NCO_DOWNMIX)
+#endif
+
+//If update the searching correlation incrementally instead of the full M tap dot product every sample
+#ifndef USE_SLIDING_DETECTOR
+#define USE_SLIDING_DETECTOR 1
+#endif
+
+//If run the capture, search and matched filter path in integer arithmetic (formats in FixedPoint.h)
+#ifndef USE_FIXED_POINT
+#define USE_FIXED_POINT 0
+#endif
+
+//If the direct form matched filter searches a coarse lag grid first and then refines around the best lag
+#ifndef USE_HIERARCHICAL_LAG_SEARCH
+#define USE_HIERARCHICAL_LAG_SEARCH 1
+#endif
+#define LAG_SEARCH_STEP 8
+
+//If use the single precision polynomial atan2 for the carrier phase (PhaseEstimation.c) instead of libm
+#ifndef USE_FAST_ATAN2
+#define USE_FAST_ATAN2 1
+#endif
+
+//If keep searching and recording into a second capture slot while the previous capture is being processed
+#ifndef USE_PIPELINED_CAPTURE
+#define USE_PIPELINED_CAPTURE 1
+#endif
+#define CAPTURE_SLOTS 2
+
+//If the slave filters its clock offset and skew over all exchanges (ClockTracker.c) instead of stepping to the newest
+#ifndef USE_CLOCK_TRACKER
+#define USE_CLOCK_TRACKER 1
+#endif
+
+//Slave virtual clock ticks from one sync pulse to the next, also the timeout for a missing reply. The clock tracker
+//spaces them out up to 10 times further, as far as its prediction holds up (clockTrackerHorizon()).
+#ifndef SYNC_EXCHANGE_TICKS
+#if (USE_CLOCK_TRACKER)
+#define SYNC_EXCHANGE_TICKS 40
+#else
+#define SYNC_EXCHANGE_TICKS 4
+#endif
+#endif
+#define SYNC_ACQUIRE_TICKS 4		// closest exchange spacing, while the clock tracker has no track yet
+#define CLOCK_STEP_MAX 8			// tracker corrections up to this are made by starting a tick early or late
+
+//If the master serves several slaves in time slots (TdmaSchedule.c). Every slave sends once per superframe
+//(TDMA_SUPERFRAME_TICKS, which replaces SYNC_EXCHANGE_TICKS), in the slot of its tdma_slot.
+#ifndef USE_TDMA
+#define USE_TDMA 0
+#endif
+#ifndef TDMA_SLOT
+#define TDMA_SLOT 0			// slave: default tdma_slot
+#endif
+
+//If the master serves several slaves at once on different carriers (CorrelatorBank.c). The master searches all
+//FDM_CHANNELS carriers around CBW and captures, estimates and replies on each of them on its own, slave k sends on
+//channel fdm_channel. Needs USE_NCO_DOWNMIX.
+#ifndef USE_FDM_BANK
+#define USE_FDM_BANK 0
+#endif
+#ifndef FDM_CHANNEL
+#define FDM_CHANNEL 0		// slave: default fdm_channel
+#endif
+#if (USE_FDM_BANK)
+//the onset of any pulse splashes over all channels while it is in the search window, so a channel has to hold its hit
+//for longer than that. The captures reach back that much further, the pulse onset stays at position M.
+#define FDM_CONFIRM		(M>>1)
+#define CAPTURE_LEAD	(M + FDM_CONFIRM)
+#define FDM_PULSE_PEAK	(32767/FDM_CHANNELS)	// slave pulses and master replies, all channels can be on the air at once
+#define MODULATED_SINC_PEAK	FDM_PULSE_PEAK
+#else
+#define CAPTURE_LEAD	M			// samples before the trigger at the start of a capture
+#define MODULATED_SINC_PEAK	32767		// amplitude of tModulatedSincPulse
+#endif
+
+//If the search threshold follows the noise floor of the metric (CfarDetector.c) instead of the fixed T1. The main
+//loop then checks every capture with the matched filter, and the frame code drops the ones without a pulse instead
+//of calculating or replying.
+#ifndef USE_CFAR_THRESHOLD
+#define USE_CFAR_THRESHOLD 0
+#endif
+
+//If copy the pulse and filter tables from PulseTables.h (generated by host/TableGen.c) instead of computing them at
+//boot. nodeInit() only takes them if they were generated for this N, M, BW, carrier and coefficient format, and falls
+//back to the formulas otherwise.
+#ifndef USE_GENERATED_TABLES
+#define USE_GENERATED_TABLES 1
+#endif
+
+//If the slave runs the matched filter over every received sample in the main loop (StreamEstimator.c) instead of
+//searching, recording and then analysing one capture. Each pulse is estimated a fixed number of samples after it
+//ends and none is missed while another is analysed; the first one after the slave's own pulse is the reply. The
+//master still needs its captures to mirror them and does not use it.
+#ifndef USE_STREAM_ESTIMATOR
+#define USE_STREAM_ESTIMATOR 0
+#endif
+
 #define BW 0.0125 	//100Hz@8k Fs baseband sinc frequency
+#ifndef CBW
 #define CBW 0.25 	//2kHz@8k Fs  carrier frequency
-
-#include <stdio.h>
-#include <c6x.h>
-#include <csl.h>
-#include <csl_mcbsp.h>
-#include <csl_irq.h>
-#include <csl_gpio.h>
-#include <math.h>
+#endif
+#ifndef RELAY_CBW
+#define RELAY_CBW 0.13		//relay: carrier of its children, default relay_carrier. Not CBW, the two links share the air.
+#endif
 
 #include <stdio.h>					//For printf
-#include <c6x.h>					//generic include
-#include <csl.h>					//generic csl include
-#include <csl_gpio.h>
-#include <csl_mcbsp.h>				//for codec support
-#include <csl_irq.h>				//interrupt support
 #include <math.h>					//duh
+#include <stdlib.h>					//abs, prototype needed for the float capture samples
+
+//no CSL/BSL past this point, the DSK specific code is in SampleIODsk.c
+#include "BlockProcessing.h"
+#include "CarrierNco.h"
+#include "CfarDetector.h"
+#include "ClockTracker.h"
+#include "CorrelatorBank.h"
+#include "CycleProfiler.h"
+#include "EventQueue.h"
+#include "FastCorrelation.h"
+#include "FixedPoint.h"
+#include "NodeContext.h"
+#include "PhaseEstimation.h"
+#include "PulseScheduler.h"
+#include "PulseSynthesis.h"
+#include "RelayDownlink.h"
+#include "StreamEstimator.h"
+#include "TdmaSchedule.h"
+#include "WaveformBank.h"
+#if (USE_GENERATED_TABLES)
+#include "PulseTables.h"
+#endif
+
+#if (USE_GENERATED_TABLES && PULSE_TABLES_N == N && PULSE_TABLES_M == M && PULSE_TABLES_FIXED_POINT == USE_FIXED_POINT \
+		&& PULSE_TABLES_PEAK == MODULATED_SINC_PEAK)
+#define PULSE_TABLES_FIT 1		// PulseTables.h is for this build, nodeInit() still checks BW and the carrier
+#else
+#define PULSE_TABLES_FIT 0
+#endif
+
+#if (USE_SLIDING_DETECTOR && !USE_NCO_DOWNMIX && (M & 3))
+#error "the sliding detector needs M to be a whole number of fs/4 carrier periods (multiple of 4)"
+#endif
+#if (USE_NCO_DOWNMIX && USE_FUSED_DOWNMIX)
+#error "the fused downmix is the fs/4 mixing pattern, USE_NCO_DOWNMIX needs USE_FUSED_DOWNMIX 0"
+#endif
+#if (USE_FDM_BANK && !USE_NCO_DOWNMIX)
+#error "the channels are off fs/4, USE_FDM_BANK needs USE_NCO_DOWNMIX"
+#endif
+#if (USE_FDM_BANK && USE_TDMA)
+#error "USE_FDM_BANK and USE_TDMA are two ways of serving several slaves, pick one"
+#endif
+#if (NODE_TYPE == RELAY_NODE && !USE_NCO_DOWNMIX)
+#error "a relay's two links are on different carriers, only the USE_NCO_DOWNMIX detector tells them apart"
+#endif
+#if (NODE_TYPE == RELAY_NODE && USE_FDM_BANK)
+#error "a relay serves its children with one mirror, it has no correlator bank"
+#endif
+#if (USE_FFT_CORRELATOR && (FFT_CORR_LEN < 2*N+2*M))
+#error "FFT_CORR_LEN in FastCorrelation.h is too short for this N and M"
+#endif
+#if (2*N+1 > VCLK_MAX)
+#error "the sinc pulse must fit in one virtual clock period"
+#endif
 
-#include "dsk6713.h"
-#include "dsk6713_aic23.h"
-#include "dsk6713_led.h"
+#define STREAM_RECEIVER (USE_STREAM_ESTIMATOR && SLAVE_ROLE)
+#if (STREAM_RECEIVER)
+#if (STREAM_RING < 2*(2*N+2*M))
+#error "STREAM_RING in StreamEstimator.h is too short for this N and M"
+#endif
+#if (USE_HIERARCHICAL_LAG_SEARCH && !USE_FFT_CORRELATOR)
+#define STREAM_LAG_STEP	LAG_SEARCH_STEP		// the coarse lags, the others are only refined in some blocks
+#else
+#define STREAM_LAG_STEP	1
+#endif
+//lags without a higher metric that confirm a peak: the main lobe of the metric reaches 1/BW to either side, and the
+//window centred on the pulse (M samples on either side) has to be in by then
+#define STREAM_PEAK_GUARD	((1/BW) > M ? (unsigned long)(1/BW) : (unsigned long) M)
+#endif
 
 // ------------------------------------------
 // start of variables
 // ------------------------------------------
 
 //Calculation Variables
-float buf[M];       	// search buffer
-float matchedFilterCosine[M];			// in-phase correlation buffer
-float matchedFilterSine[M];       	// quadrature correlation buffer
-float corr_max, corr_max_s, corr_max_c; // correlation variables
-float corr_c[2*M];
-float corr_s[2*M];
-float s[2*M];
-short corr_max_lag;
-short bufindex = 0;
-float corrSumCosine,corrSumSine,corrSumIncoherent;
-short i,j,k;				// Indices
-double t,x,y;				// More Indices
-float tf,xf,yf;				// More Indices
-float basebandSincRef[2*N+1];   		// baseband sinc pulse buffer
-float recbuf[2*N+2*M]; 		// recording buffer
-float downMixedCosine[2*N+2*M];     		// in-phase downmixed buffer
-float downMixedSine[2*N+2*M];     		// quadrature downmixed buffer
-volatile short recbufindex = 0;		//
+NodeContext node_context;				// search, capture and timing analysis state, see NodeContext.h
+coef_t matchedFilterCosine[M];			// in-phase correlation buffer
+coef_t matchedFilterSine[M];       	// quadrature correlation buffer
+coef_t basebandSincRef[2*N+1];   		// baseband sinc pulse buffer
+float basebandSincEnergy;				// sum of the squared reference, for the capture SNR
+#if (USE_PIPELINED_CAPTURE)
+volatile short late_captures = 0;		// master: spare captures dropped because their reply time had passed
+#endif
+double carrier_freq = CBW;			// carrier the node sends on and mixes down with, an FDM slave's is its channel's
+short pulse_tables_used = 0;		// 1 if nodeInit() copied the tables from PulseTables.h instead of computing them
+#if (USE_NCO_DOWNMIX)
+const short nco_downmix = 1;		// the searching correlation tells carriers apart, for the host simulator
+#endif
 
 #if (NODE_TYPE == MASTER_NODE)//if master, listen to slave first and then send the sinc back
-volatile int state = STATE_SEARCHING;
-#elif (NODE_TYPE == SLAVE_NODE)//if slave, send sinc and then wait for master's response
-volatile int state = STATE_TRANSMIT;
+int state = STATE_SEARCHING;
+#elif (SLAVE_ROLE)//if slave, send sinc and then wait for master's response
+int state = STATE_TRANSMIT;
 #endif
 
-volatile short vclock_counter = 0;	// virtual clock counter
+short vclock_counter = 0;	// virtual clock counter
 volatile short vclock_complement = 0;	// VCLK_MAX - vclock_counter
-volatile short max_recbuf = 0;
-volatile short playback_scale = 1;
-volatile short wait_count = 0;
+short playback_scale = 1;
+short wait_count = 0;
 volatile int myage = 0;
 volatile short dedicated_clk = 0;	// make decision at fixed time after sinc peak center
 
-volatile short recbuf_start_clock = 0; // virtual clock counter for first sample in recording buffer
-short coarse_delay_estimate[MAX_STORED_DELAYS_COARSE];
-float fine_delay_estimate[MAX_STORED_DELAYS_FINE];
-short cde_index = 0;
-short fde_index = 0;
-volatile char local_carrier_phase = 0;
-char r = 0;
-double phase_correction_factor;
+char local_carrier_phase = 0;
 short max_samp = 0;
 
-#if (NODE_TYPE == MASTER_NODE)
-//volatile short ML[VCLK_MAX*BUF_SIZE];
-//volatile short MR[VCLK_MAX*BUF_SIZE];
-volatile short ML[VCLK_MAX*BUF_SIZE];//master response sinc
-volatile short MR[VCLK_MAX*BUF_SIZE];//jus for debug
-#elif (NODE_TYPE == SLAVE_NODE)
-//volatile short SL[VCLK_MAX*BUF_SIZE];
-//volatile short SR[VCLK_MAX*BUF_SIZE];
-volatile short SR[VCLK_MAX];		//slave clock
-volatile short SL[VCLK_MAX*BUF_SIZE];		//static outgoing-sinc from slave
+//pulses on the output channels: the clock sinc, and the slave's pulse to the master
+PulseScheduler pulse_scheduler;
+unsigned long response_end;		// pulse_scheduler frame of the last sample of the slave's pulse
+#if (SLAVE_ROLE)
+//the slave's clock sinc starts CLOCK_SINC_DELAY samples after its tick, plus the tick's error on the master's tick
+#define CLOCK_SINC_DELAY	1		// samples, room for a tick that is up to a sample late
+float clock_tick_error = 0;		// master tick minus slave tick in samples, for the tick that starts
+short clockSincNext = 0;		// of the two below: a corrected tick can start before the last clock sinc is over
+PulseSynth clockSincSynth[2];
+#if (!USE_PULSE_SYNTH)
+short clockSincRow[2];			// waveform bank row of each clock sinc
+#endif
 #endif
-
-
-
-volatile unsigned short run_head = 0;
-volatile unsigned short run_head_sl = 0;
-volatile unsigned short calc_head = 0;
 
 //Master sinc response variables
 volatile short vir_clock_start;
-volatile short CurTime = 0;
+short CurTime = 0;
 short halfSinc;
 
 //Output waveform buffers for clock and sync channels
 short standardWaveformBuffer[N2];
 short delayedWaveformBuffer[N2];
-#pragma DATA_SECTION(allMyDelayedWaveforms,".mydata")
-far short allMyDelayedWaveforms[MAXDELAY][N2];
+#if (!USE_PULSE_SYNTH && SLAVE_ROLE)
+#if (WAVEBANK_HALF_LEN != N || WAVEBANK_RESOLUTION != MAXDELAY)
+#error "WaveformBank.h is set up for a different N or MAXDELAY"
+#endif
+#if (!WAVEBANK_PREBUILT)
+short bankRowBuffer[WAVEBANK_ROW_INPUT_LEN];	// one padded row while the bank is filled
+#endif
+//the bank is only exact for the fs/4 carrier, on any other the clock sinc falls back to the synthesizer
+short waveform_bank_misfits = 0;				// samples that do not read back exactly, the bank is used if 0
+long waveform_bank_bytes = WAVEBANK_BYTES;		// vs WAVEBANK_FULL_TABLE_BYTES for allMyDelayedWaveforms
+#endif
 
 short tModulatedSincPulse[OUTPUT_BUF_SIZE];
 //#pragma DATA_SECTION(tModulatedSincPulse_delayed,".mydata")
@@ -208,23 +376,17 @@ far short tModulatedSincPulse_delayed[OUTPUT_BUF_SIZE];	//must be extern far acc
 																//not sure but all variable might be "far" by default
 volatile short even = 1;
 volatile short response_done = 0; 						//not done var for response state
-volatile short response_buf_idx = 0; 					//index for output buffer
-volatile short response_buf_idx_clk = 0; 					//another index for output buffer
 volatile short response_buf_idx_max = OUTPUT_BUF_SIZE;
-volatile short amSending = 0;			//control var for starting the sending of the response from master
+short amSending = 0;			//control var for starting the sending of the response from master
 volatile short amWaiting = 0;			//control var for starting the waiting process before master's response
-volatile short sinc_launch = 0;
+short sinc_launch = 0;
 volatile short sinc_roundtrip_time ;
 volatile short vclock_offset ;
 volatile short ClockPulse = 0;							//Used for generating the master clock pulse output value
-volatile short calculation_done = 0;		//debug
 volatile short v_clk[3];					//debug
-volatile short clk_flag = 0;
 
 #define HISTORY	20
 volatile short debug_history[4][HISTORY];
-int index_history[4][HISTORY];
-volatile float float_history[4][HISTORY];
 //volatile short debug_history2[HISTORY];
 //volatile short debug_history3[HISTORY];
 int age=0;
@@ -232,26 +394,107 @@ int age=0;
 //Slave transmit variables
 //short pulse_counter = SLAVE_PULSE_COUNTER_MIN;
 
-// ISR combos
-union {Uint32 combo; short channel[2];} tempOutput;
-union {Uint32 combo; short channel[2];} tempInput;
-//union {Uint32 combo; short channel[2];} debugOutput;
+// current codec frame, channel order of the codec word (see BlockProcessing.h)
+const short* frameIn;
+short* frameOut;
+
+//slave clock correction, applied by the frame code once the clock reaches vclock_offset. A request from the main loop
+//to the frame code, the other way than node_events, that stays pending for many frames, so a flag and not an event
+volatile short vclock_correction_pending = 0;
+#if (!USE_CLOCK_TRACKER)
+volatile float vclock_offset_error = 0;		// master tick minus the corrected tick in samples, for the clock sinc
+#endif
+
+#if (USE_CLOCK_TRACKER)
+//slave clock tracking, the frame code takes vclock_skew_per_tick (Q16 samples) and small steps out of the clock at
+//the wraps. Like vclock_correction_pending, vclock_step_pending is set by the main loop and cleared by the frame code.
+ClockTracker slave_clock;
+volatile int vclock_skew_per_tick = 0;
+volatile short vclock_step = 0;
+volatile short vclock_step_pending = 0;
+volatile short sync_exchange_ticks = SYNC_ACQUIRE_TICKS;
+int vclock_skew_phase = 0;				// skew and steps not taken out yet, Q16 samples, frame code only
+unsigned short ticks_since_capture = 0;	// clock wraps since the last analysed capture, main loop only
+short last_capture_clock = 0;
+#endif
+
+#if (USE_TDMA)
+#if (NODE_TYPE == MASTER_NODE)
+//slot table, the frame code counts the superframe ticks and tags each capture with the tick the pulse is centred on
+TdmaSlot tdma_slots[TDMA_SLOTS];
+volatile short tdma_tick = 0;				// ticks into the superframe
+volatile unsigned short tdma_superframe = 0;
+short capture_tick = 0;						// superframe tick of the pulse in recbuf, frame code only
+#if (USE_PIPELINED_CAPTURE)
+short spareTick = 0;						// same for the spare slot
+#endif
+short tdma_reply_slot = TDMA_OFF_SLOT;		// slot of the newest capture, the next reply is its, main loop only
+unsigned short tdma_off_slot = 0;			// pulses between two slots, not attributed
+#elif (SLAVE_ROLE)
+short tdma_slot = TDMA_SLOT;				// 0 to TDMA_SLOTS-1, set before nodeInit() (the host simulator sets each slave's)
+#endif
+#endif
+
+#if (USE_FDM_BANK)
+FdmSearchBank fdm_bank;						// the searching correlation on all channels
+float fdmMixedCosine[M*FDM_CHANNELS];		// its windows of mixed samples
+float fdmMixedSine[M*FDM_CHANNELS];
+#if (NODE_TYPE == MASTER_NODE)
+//each channel records into its own capture and replies from its own buffer, buf holds the capture lead for all
+FdmChannel fdm_channels[FDM_CHANNELS];
+capture_t fdm_capture[FDM_CHANNELS][2*N+2*M];
+short fdm_reply[FDM_CHANNELS][2*N+2*M];		// the reply in capture order, played backwards like recbuf
+#elif (SLAVE_ROLE)
+short fdm_channel = FDM_CHANNEL;			// 0 to FDM_CHANNELS-1, set before nodeInit() (the host simulator sets each slave's)
+#endif
+#endif
+
+#if (USE_CFAR_THRESHOLD || STREAM_RECEIVER)
+//the frame code counts the triggers, the main loop the validated and rejected captures. The stream's detector is the
+//same, but all in the main loop: its triggers are the confirmed peaks.
+CfarDetector search_cfar;
+#endif
+#if (USE_CFAR_THRESHOLD)
+volatile short capture_rejected = 0;		// set by the main loop for a capture without a pulse, frame code clears it
+#endif
+
+#if (STREAM_RECEIVER)
+StreamEstimator receive_stream;				// every received sample, the frame code writes, the main loop searches
+#endif
+
+#if (NODE_TYPE == RELAY_NODE)
+//the downlink mirror, the frame code runs it on every sample beside the slave states
+RelayDownlink relay_downlink;
+double relay_carrier = RELAY_CBW;			// set before nodeInit() (the host simulator sets each relay's)
+float relayMixedCosine[M];					// its search window
+float relayMixedSine[M];
+short relayLead[M];
+short relayCapture[2*N+2*M];
+short relay_tick = 0;						// the clock wrapped on this frame, frame code only
+#if (USE_CFAR_THRESHOLD)
+CfarDetector relay_cfar;					// the downlink's own noise floor, its triggers are never validated
+#endif
+#endif
 
-DSK6713_AIC23_CodecHandle hCodec;							// Codec handle
-DSK6713_AIC23_Config config = DSK6713_AIC23_DEFAULTCONFIG;  // Codec configuration with default settings
+#if (SLAVE_ROLE && USE_CLOCK_TRACKER)
+//error budget against the root master, standard deviations in samples, main loop. The budget can not travel over the
+//timestamp-free link, so the parent's figure is handed down from outside (the debugger or the host simulator).
+float upstream_error_budget = 0;			// the parent's sync_error_budget, 0 under the master
+float hop_error_budget = 0;					// this hop's share
+float sync_error_budget = 0;				// both together
+#endif
 
-GPIO_Handle    hGpio; /* GPIO handle */
+//frame code to main loop events, the main loop learns about captures, ticks and transmits only through these
+EventQueue node_events;
+unsigned long background_captures = 0;		// events seen by the main loop, for the debugger
+unsigned long background_ticks = 0;
+unsigned long background_transmits = 0;
 
-GPIO_Handle gpio_handle;
-GPIO_Config gpio_config = {
-    0x00000000, // gpgc = global control
-    0x0000FFFF, // gpen = enable 0-15
-    0x00000000, // gdir = all inputs
-    0x00000000, // gpval = n/a
-    0x00000000, // gphm all interrupts disabled for io pins
-    0x00000000, // gplm all interrupts to cpu or edma disabled
-    0x00000000  // gppol -- default state */
-};
+#if (USE_CYCLE_PROFILER)
+profile_tick_t profile_frame_start;		// processFrame() entry
+profile_tick_t profile_part_start;		// entry of the part of processFrame() being timed
+int profile_state;						// state the state machine was entered in
+#endif
 
 // ------------------------------------------
 // end of variables
@@ -263,131 +506,305 @@ double cos(double);
 double atan2(double,double);
 //float sumFloatArray(float*, short numElmts);
 
-interrupt void serialPortRcvISR(void);
+void processFrame();
 
 //Helper function prototypes
 void SetupTransmitModulatedSincPulseBuffer();
 void SetupTransmitModulatedSincPulseBufferDelayed();
-void SetupTransmitModulatedSincPulseBufferDelayedFine(float fineDelay);
+void scheduleClockSincISR();
+short clockSincSynthSample(void* synth, short offset);
+short clockSincBankSample(void* row, short offset);
 void setupTransmitBuffer(short tBuffer[], short halfBufLen, double sincBandwidth, double carrierFreq, double delay);
 void SetupReceiveBasebandSincPulseBuffer();
 void SetupReceiveTrigonometricMatchedFilters();
-void runReceivedPulseBufferDownmixing();
+short loadPulseTables();
+void nodeContextInit(NodeContext* node);
+void runReceivedPulseBufferDownmixing(NodeContext* node);
 //void runSlaveSincPulseTimingUpdateCalcs();
-void ToggleDebugGPIO(short IONum);
 short isSincInSameWindowHuh(short curClock, short delayEstimate);
 
 
 
 //State functions run during ISR
-void runSearchingStateCodeISR();
-void runRecordingStateCodeISR();
-void playRecordingStateCodeISR();
+void runSearchingStateCodeISR(NodeContext* node);
+short runSearchDetectorISR(NodeContext* node);
+short runSearchCorrelator(NodeContext* node, capture_t sample, char carrierPhase);
+void startRecordingISR(NodeContext* node, capture_t* slot);
+void takeSearchWindow(NodeContext* node, capture_t* slot);
+void finishRecordingISR(NodeContext* node);
+void runBackgroundCaptureISR(NodeContext* node);
+void resumeSearchingISR(NodeContext* node);
+void runRecordingStateCodeISR(NodeContext* node);
+void playRecordingStateCodeISR(NodeContext* node);
 void runCalculationStateCodeISR();
-void runResponseStateCodeISR();
+void runResponseStateCodeISR(NodeContext* node);
 
-void runResponseClkSinc();
+#if (USE_CLOCK_TRACKER)
+void runSkewCompensationISR(NodeContext* node);
+#endif
+#if (USE_CFAR_THRESHOLD)
+void dropRejectedCaptureISR(NodeContext* node);
+#endif
 
 
 //State functions run during while() loop
 void runMasterResponseSincPulseTimingControl();
-void runReceviedSincPulseTimingAnalysis();
-
-//debug gpio function
-void gpioInit();
-void gpioToggle();
+void runReceivedMatchedFilter(NodeContext* node);
+void runReceviedSincPulseTimingAnalysis(NodeContext* node);
+void correlateReceivedLag(NodeContext* node, short lag);
+float estimateCaptureSnr(NodeContext* node);
+#if (USE_CLOCK_TRACKER)
+void runSlaveClockTracking(NodeContext* node, short launch, short clock, unsigned short ticks);
+#endif
+#if (USE_TDMA && NODE_TYPE == MASTER_NODE)
+short tdmaCaptureTickISR();
+void runMasterSlotAnalysis(NodeContext* node, short tick);
+#endif
+#if (USE_FDM_BANK && NODE_TYPE == MASTER_NODE)
+void runFdmBankISR(NodeContext* node);
+void clearFdmChannelISR(short ch);
+void runMasterChannelAnalysis(NodeContext* node, short ch);
+#endif
+#if (USE_CFAR_THRESHOLD && NODE_TYPE == MASTER_NODE && !USE_TDMA && !USE_FDM_BANK)
+void runMasterCaptureValidation(NodeContext* node);
+#endif
+#if (SLAVE_ROLE)
+void runSlaveDelayUpdate(NodeContext* node, short launch, short clock, unsigned short ticks);
+#endif
+#if (STREAM_RECEIVER)
+void runSlaveStreamAnalysis(NodeContext* node);
+void runSlaveStreamPulse(NodeContext* node, unsigned long position);
+void copyStreamWindow(NodeContext* node, unsigned long first);
+#endif
 
-int led_prev=0;//not sure how to check led state so just keep local copy
-void toggle_LED(int led)
+/**
+ * Sets up the pulse, filter and response buffers, call once before the sample I/O starts
+ */
+void nodeInit()
 {
-	if(led_prev){
-		DSK6713_LED_off(led);
-		led_prev = 0;
-	}else{
-		DSK6713_LED_on(led);
-		led_prev=1;
+#if (!USE_PULSE_SYNTH && SLAVE_ROLE && !WAVEBANK_PREBUILT)
+	short i;
+#endif
+
+#if (USE_FDM_BANK && SLAVE_ROLE)
+	carrier_freq = fdmChannelCarrier(CBW, fdm_channel);	// the slave sends and listens on its own channel only
+#endif
+
+	// the pulse and filter tables, unless PulseTables.h has them for this pulse and carrier
+	pulse_tables_used = loadPulseTables();
+	if(!pulse_tables_used){
+		setupTransmitBuffer(standardWaveformBuffer, N, BW, carrier_freq, 0.0);
+		setupTransmitBuffer(delayedWaveformBuffer, N, BW, carrier_freq, 0.0);
+		// set up the cosine and sin matched filters for searching
+		SetupReceiveTrigonometricMatchedFilters();
+		SetupReceiveBasebandSincPulseBuffer();
+		SetupTransmitModulatedSincPulseBuffer();
+		SetupTransmitModulatedSincPulseBufferDelayed();
+	}
+
+#if (!USE_PULSE_SYNTH && SLAVE_ROLE && WAVEBANK_PREBUILT)
+	waveform_bank_misfits = prebuiltWaveformBankMisfits(BW, carrier_freq);	// the bank is generated for one pulse
+#elif (!USE_PULSE_SYNTH && SLAVE_ROLE)
+	//only delays 0 to 0.5 are stored, WaveformBank.c mirrors them for the rest
+	for(i = 0; i < WAVEBANK_ROWS; i++){
+		setupTransmitBuffer(bankRowBuffer, N+1, BW, carrier_freq, ((double) i) / MAXDELAY);
+		waveform_bank_misfits += storeDelayedWaveformRow(i, bankRowBuffer);
+	}
+#endif
+
+
+	// empty search buffer and capture slots, reset coarse and fine delay estimate buffers
+	nodeContextInit(&node_context);
+
+	pulseSchedulerInit(&pulse_scheduler);
+	eventQueueInit(&node_events);
+#if (USE_CLOCK_TRACKER)
+	clockTrackerInit(&slave_clock);
+#endif
+#if (USE_CFAR_THRESHOLD || STREAM_RECEIVER)
+	cfarInit(&search_cfar, CFAR_FALSE_ALARM, M);
+#endif
+#if (STREAM_RECEIVER)
+	streamInit(&receive_stream, STREAM_PEAK_GUARD, 2*N);
+#endif
+#if (NODE_TYPE == RELAY_NODE && USE_CFAR_THRESHOLD)
+	cfarInit(&relay_cfar, CFAR_FALSE_ALARM, M);
+	relayDownlinkInit(&relay_downlink, relay_carrier, relayMixedCosine, relayMixedSine, relayLead, relayCapture, M,
+			2*N+2*M, T1, &relay_cfar);
+#elif (NODE_TYPE == RELAY_NODE)
+	relayDownlinkInit(&relay_downlink, relay_carrier, relayMixedCosine, relayMixedSine, relayLead, relayCapture, M,
+			2*N+2*M, T1, NULL);
+#endif
+#if (USE_FDM_BANK)
+	fdmSearchInit(&fdm_bank, CBW, fdmMixedCosine, fdmMixedSine, M, FDM_CONFIRM);
+#if (NODE_TYPE == MASTER_NODE)
+	fdmChannelInit(fdm_channels);
+#endif
+#endif
+#if (USE_TDMA && NODE_TYPE == MASTER_NODE)
+	tdmaInit(tdma_slots);
+#elif (USE_TDMA && SLAVE_ROLE)
+	// wait for the own slot before the first pulse. The slots only line up with the master's superframe if the
+	// nodes start within about half a tick of each other, the master has no way to move a slave to another slot.
+	if(tdmaSlotTick(tdma_slot) > 0){
+		sinc_launch = TDMA_SUPERFRAME_TICKS - tdmaSlotTick(tdma_slot);
+		state = STATE_CALCULATION;
 	}
+#endif
 }
 
-void main()
+/**
+ * Puts a node's signal path in its starting state: searching with an empty window, nothing captured, no estimates
+ * yet, and the oscillators on carrier_freq. nodeInit() does this for node_context.
+ */
+void nodeContextInit(NodeContext* node)
 {
+	short i;
+
+	for (i=0;i<CAPTURE_LEAD;i++)
+		node->buf[i] = 0;
+	node->bufindex = 0;
+	node->corrSumCosine = 0;
+	node->corrSumSine = 0;
+	node->corrSumIncoherent = 0;
+	node->corrFreshCosine = 0;
+	node->corrFreshSine = 0;
+#if (USE_NCO_DOWNMIX)
+	node->corrSumEnergy = 0;
+	node->corrFreshEnergy = 0;
+	for (i=0;i<M;i++){
+		node->searchMixedCosine[i] = 0;
+		node->searchMixedSine[i] = 0;
+	}
+	ncoInit(&node->receiveNco, carrier_freq);
+	ncoInit(&node->searchNco, carrier_freq);
+#endif
 
-	setupTransmitBuffer(standardWaveformBuffer, N, BW, CBW, 0.0);
-	setupTransmitBuffer(delayedWaveformBuffer, N, BW, CBW, 0.0);
+#if (USE_PIPELINED_CAPTURE)
+	node->recbuf = node->recbufSlots[0];
+	node->spareSlot = 1;
+	node->spareIndex = 0;
+	node->spareStartClock = 0;
+	node->spareStartLaunch = 0;
+	node->spareWaitCount = 0;
+	node->spareWrapped = 0;
+#endif
+	node->recbufindex = 0;
+	node->max_recbuf = 0;
+	node->recbuf_start_clock = 0;
+	node->recbuf_start_launch = 0;
 
-	for(i = 0; i < MAXDELAY; i++){
-		setupTransmitBuffer(&(allMyDelayedWaveforms[i][0]), N, BW, CBW, ((double) i) / MAXDELAY);
+	for (i=0;i<MAX_STORED_DELAYS_COARSE;i++)
+		node->coarse_delay_estimate[i] = 0;
+	for (i=0;i<MAX_STORED_DELAYS_FINE;i++){
+		node->fine_delay_estimate[i] = 0.0;
+		node->fine_delay_snr[i] = 0.0;
 	}
+	node->cde_index = 0;
+	node->fde_index = 0;
+}
 
+/**
+ * Background (main loop) part of the node, the DSK and host backends call it over and over between blocks.
+ * It must not wait on the frame code, everything that has to happen on a given clock tick is left to processFrame().
+ */
+void nodeBackgroundTask()
+{
+#if (SLAVE_ROLE || USE_TDMA || USE_FDM_BANK || USE_CFAR_THRESHOLD)		// the plain master only mirrors
+	NodeContext* node = &node_context;
+#endif
+	NodeEvent event;
+	short captureReady = 0;
+#if (SLAVE_ROLE && !STREAM_RECEIVER)
+	short captureClock = 0;		// vclock_counter when the capture completed
+#endif
+#if ((SLAVE_ROLE && !STREAM_RECEIVER) || (USE_TDMA && NODE_TYPE == MASTER_NODE))
+	short captureLaunch = 0;	// sinc_launch when the capture started (slave), master with USE_TDMA: tick of the pulse
+#endif
+#if (USE_CLOCK_TRACKER && SLAVE_ROLE && !STREAM_RECEIVER)
+	unsigned short captureTicks = 0;	// clock wraps from the last analysed capture to this one
+#endif
+#if (USE_CLOCK_TRACKER)
+	unsigned short ticksAfter = 0;		// clock wraps after this one
+#endif
+#if (USE_TDMA && NODE_TYPE == MASTER_NODE)
+	short ticksFromSlot;
+#endif
+#if (USE_FDM_BANK && NODE_TYPE == MASTER_NODE)
+	unsigned int fdmCaptures = 0;	// channels with a new capture
+	short ch;
+#endif
 
-	// reset coarse and fine delay estimate buffers
-	for (i=0;i<MAX_STORED_DELAYS_COARSE;i++)
-		coarse_delay_estimate[i] = 0;
-		fine_delay_estimate[i] = 0.0;
+	// only the newest capture is in recbuf, so older capture events just get counted
+	while(eventQueueTake(&node_events, &event)){
+		if(event.type==EVENT_CAPTURE_READY){
+			captureReady = 1;
+#if (SLAVE_ROLE && !STREAM_RECEIVER)
+			captureClock = event.clock;
+#endif
+#if ((SLAVE_ROLE && !STREAM_RECEIVER) || (USE_TDMA && NODE_TYPE == MASTER_NODE))
+			captureLaunch = (short) event.value;
+#endif
+			background_captures++;
+#if (USE_FDM_BANK && NODE_TYPE == MASTER_NODE)
+			fdmCaptures |= 1u<<event.value;		// but every channel has a capture of its own
+#endif
+#if (USE_TDMA && NODE_TYPE == MASTER_NODE)
+			tdma_reply_slot = tdmaSlotOfTick(captureLaunch, &ticksFromSlot);
+			if(tdma_reply_slot == TDMA_OFF_SLOT)
+				tdma_off_slot++;
+#endif
+#if (USE_CLOCK_TRACKER && SLAVE_ROLE && !STREAM_RECEIVER)
+			captureTicks = ticks_since_capture;
+#endif
+#if (USE_CLOCK_TRACKER)
+			ticksAfter = 0;
+#endif
+		}
+		else if(event.type==EVENT_TICK_WRAPPED){
+			background_ticks++;
+#if (USE_CLOCK_TRACKER)
+			ticks_since_capture++;
+			ticksAfter++;
+#endif
+		}
+		else if(event.type==EVENT_TRANSMIT_DONE){
+			background_transmits++;
+#if (USE_TDMA && NODE_TYPE == MASTER_NODE)
+			if(tdma_reply_slot != TDMA_OFF_SLOT)
+				tdmaRecordReply(&tdma_slots[tdma_reply_slot], (short) event.value);
+#endif
+#if (USE_FDM_BANK && NODE_TYPE == MASTER_NODE)
+			fdm_channels[event.value].replies++;
+#endif
+		}
+	}
+#if (USE_CLOCK_TRACKER)
+	if(captureReady)
+		ticks_since_capture = ticksAfter;
+#endif
 
-#if (NODE_TYPE == MASTER_NODE)
-	for(i=0;i<VCLK_MAX*BUF_SIZE;++i)
-		ML[i] = 0;
-	for(i=0;i<VCLK_MAX*BUF_SIZE;++i)
-		MR[i] = 0;
-#elif (NODE_TYPE == SLAVE_NODE)
-	for(i=0;i<VCLK_MAX;++i)
-		SR[i] = 0;
-	for(i=0;i<VCLK_MAX*BUF_SIZE;++i)
-		SL[i] = 0;
-	//populate SL with zero-delayed sinc
-	for (i=-N;i<=N;i++)
-		SL[INDEX_WRAP(i + N + (VCLK_MAX>>1))] =  allMyDelayedWaveforms[0][i + N];
-#endif
-
-	// set up the cosine and sin matched filters for searching
-	// also initialize searching buffer
-	SetupReceiveTrigonometricMatchedFilters();
-	SetupReceiveBasebandSincPulseBuffer();
-	SetupTransmitModulatedSincPulseBuffer();
-	SetupTransmitModulatedSincPulseBufferDelayed();
-	// -------- DSK Hardware Setup --------
-
-	DSK6713_init();		// Initialize the board support library, must be called first
-	DSK6713_LED_init(); // initialize LEDs
-    hCodec = DSK6713_AIC23_openCodec(0, &config);	// open codec and get handle
-
-	// Configure buffered serial ports for 32 bit operation
-	// This allows transfer of both right and left channels in one read/write
-	MCBSP_FSETS(SPCR1, RINTM, FRM);
-	MCBSP_FSETS(SPCR1, XINTM, FRM);
-	MCBSP_FSETS(RCR1, RWDLEN1, 32BIT);
-	MCBSP_FSETS(XCR1, XWDLEN1, 32BIT);
-
-	// set codec sampling frequency
-	DSK6713_AIC23_setFreq(hCodec, DSK_SAMPLE_FREQ);
-
-	//Example taken from TI forums
-	//Setup GPIO
-	gpioInit();
-
-	//NOTE inf loop
-	//gpioToggle();
-
-	// interrupt setup
-	IRQ_globalDisable();			// Globally disables interrupts
-	IRQ_nmiEnable();				// Enables the NMI interrupt
-	IRQ_map(IRQ_EVT_RINT1,15);		// Maps an event to a physical interrupt
-	IRQ_enable(IRQ_EVT_RINT1);		// Enables the event
-	IRQ_globalEnable();				// Globally enables interrupts
-
-	// -------- End DSK Hardware Setup --------
-
-	while(1)						// main loop
-	{
-		#if (NODE_TYPE==MASTER_NODE) //Master control loop code
-			if (state != STATE_CALCULATION) {
-				//Do nothing
-				//Maybe calculate the question to 42 if we have time
+	#if (NODE_TYPE==MASTER_NODE) //Master control loop code
+		if (!captureReady) {
+			//Do nothing
+			//Maybe calculate the question to 42 if we have time
+		}
+		else {
+#if (USE_TDMA)
+			// the reply is the frame code's, the main loop only estimates where the slot's slave is
+			if(tdma_reply_slot != TDMA_OFF_SLOT)
+				runMasterSlotAnalysis(node, captureLaunch);
+#elif (USE_FDM_BANK)
+			// the replies are the main loop's here, the frame code only plays them
+			for(ch=0;ch<FDM_CHANNELS;ch++){
+				if(fdmCaptures & (1u<<ch))
+					runMasterChannelAnalysis(node, ch);
 			}
-			else if (state==STATE_CALCULATION) {
-				//printf wrecks the real-time operation
-				//printf("Buffer recorded: %d %f.\n",recbuf_start_clock,corrSumIncoherent);
+#elif (USE_CFAR_THRESHOLD)
+			runMasterCaptureValidation(node);	// the mirror needs no estimate, only to know there is a pulse
+#endif
+			//printf wrecks the real-time operation
+			//printf("Buffer recorded: %d %f.\n",recbuf_start_clock,corrSumIncoherent);
 //				corrSumIncoherent = 0;  // clear correlation sum
 //				// -----------------------------------------------
 //				// this is where we estimate the time of arrival
@@ -395,8 +812,8 @@ void main()
 //				runReceivedPulseBufferDownmixing();
 //				runReceviedSincPulseTimingAnalysis();
 //
-////				tempOutput.channel[TRANSMIT_SINC] = 15000;
-////				tempOutput.channel[1] = 0;
+////				frameOut[TRANSMIT_SINC] = 15000;
+////				frameOut[1] = 0;
 ////				MCBSP_write(DSK6713_AIC23_DATAHANDLE, tempOutput.combo);
 //
 //				// alternative way - portable code
@@ -486,32 +903,72 @@ void main()
 //
 //				// no transmit state anymore, when done calculating jusmp to searchiong state
 //				state=STATE_SEARCHING;
-//				DSK6713_LED_off(STATE_CALCULATION);
-//				DSK6713_LED_on(STATE_SEARCHING);
+//				indicatorLedOff(STATE_CALCULATION);
+//				indicatorLedOn(STATE_SEARCHING);
 //
 ////				state = STATE_TRANSMIT; //set to response for the ISR to pick the appropriate path
 ////				ToggleDebugGPIO(STATE_TRANSMIT);
 ////				while(state == STATE_TRANSMIT) ; //Loop and wait here until the responding output code works
 
 
+		}
+	#elif (STREAM_RECEIVER)
+		runSlaveStreamAnalysis(node);	// the stream has no captures, the main loop finds the pulses in it
+	#elif (SLAVE_ROLE)
+		//Do nothing, we're the slave. All real calculations occur during the ISR
+		if(!captureReady){
+			//Still do nothing
+		}
+		else {
+			//printf wrecks the real-time operation
+			//printf("Buffer recorded: %d %f.\n",recbuf_start_clock,corrSumIncoherent);
+			node->corrSumIncoherent = 0;  // clear correlation sum
+			// -----------------------------------------------
+			// this is where we estimate the time of arrival
+			// -----------------------------------------------
+#if (USE_CYCLE_PROFILER)
+			profile_tick_t analysisStart = profilerTimerRead();
+#endif
+#if (!USE_FUSED_DOWNMIX)
+			runReceivedPulseBufferDownmixing(node);
+#endif
+			runReceviedSincPulseTimingAnalysis(node);
+			PROFILE_STOP(PROFILE_TIMING_ANALYSIS, analysisStart);
+#if (USE_CLOCK_TRACKER || USE_CFAR_THRESHOLD)
+			node->fine_delay_snr[node->fde_index] = estimateCaptureSnr(node);
+#endif
+#if (USE_CFAR_THRESHOLD)
+			if(!cfarValidate(&search_cfar, node->fine_delay_snr[node->fde_index])){
+				capture_rejected = 1;	// a false trigger, the frame code goes back to listening for the reply
+				return;
 			}
-		#elif (NODE_TYPE==SLAVE_NODE)
-			//Do nothing, we're the slave. All real calculations occur during the ISR
-			if(state!=STATE_CALCULATION){
-				//Still do nothing
-			}
-			else if (state==STATE_CALCULATION){
-				//printf wrecks the real-time operation
-				//printf("Buffer recorded: %d %f.\n",recbuf_start_clock,corrSumIncoherent);
-				corrSumIncoherent = 0;  // clear correlation sum
-				// -----------------------------------------------
-				// this is where we estimate the time of arrival
-				// -----------------------------------------------
-				runReceivedPulseBufferDownmixing();
-				runReceviedSincPulseTimingAnalysis();
-				// --- Prepare for Response State ---
-
-				//Now we calculate the new center clock
+#endif
+#if (USE_CLOCK_TRACKER)
+			runSlaveDelayUpdate(node, captureLaunch, captureClock, captureTicks);
+#else
+			runSlaveDelayUpdate(node, captureLaunch, captureClock, 0);
+#endif
+
+			// done, after 3 vitual clock overflows, ISR will timeout and go to STATE_TRANSMITTING
+
+		}
+
+	#endif
+
+}
+
+#if (SLAVE_ROLE)
+/**
+ * Takes the newest fine delay estimate, the master's reply to the slave's pulse, into the slave clock and the next
+ * pulse's delay
+ * @param launch	sinc_launch when the reply came in (recbuf_start_launch), the fine estimate counts from that tick
+ * @param clock		vclock_counter when the reply was complete
+ * @param ticks		clock wraps since the previous reply, for the clock tracker
+ */
+void runSlaveDelayUpdate(NodeContext* node, short launch, short clock, unsigned short ticks){
+	// --- Prepare for Response State ---
+
+	//Now we calculate the new center clock
 
 //				//								whole # of clock overflows + delay_estimate
 //				//		NOTE: delay_estimate needs to be wraped in some cases!
@@ -519,143 +976,259 @@ void main()
 //				//sinc_roundtrip_time = sinc_launch;
 //				vclock_offset = sinc_roundtrip_time / 2;					// divide by two
 
-				// alternative way - portable code
-				volatile short tick_variable = vclock_counter;//variable tick
-				volatile short tick_center_point = CLOCK_WRAP((short)(fine_delay_estimate[fde_index]));//this does not need to be an array
+	// alternative way - portable code
+	volatile short tick_variable = clock;//variable tick
+	volatile short tick_center_point = CLOCK_WRAP((short)(node->fine_delay_estimate[node->fde_index]));//this does not need to be an array
 
-				//patch for error when tick_center_point=0 once in a while
-				//if(tick_center_point!=0)
-				{
+	//patch for error when tick_center_point=0 once in a while
+	//if(tick_center_point!=0)
+	{
 
-				volatile short sinc_roundtrip_time;
+	volatile short sinc_roundtrip_time;
 
-				//if(tick_center_point < tick_variable)
-					sinc_roundtrip_time = (sinc_launch)*VCLK_MAX + tick_center_point - (VCLK_MAX>>1);
-				//else
-				//	sinc_roundtrip_time = (sinc_launch-1)*VCLK_MAX + tick_center_point ;//- (VCLK_MAX>>1);
+	//if(tick_center_point < tick_variable)
+		sinc_roundtrip_time = (launch)*VCLK_MAX + (short)(node->fine_delay_estimate[node->fde_index])
+				- (VCLK_MAX>>1);
+	//else
+	//	sinc_roundtrip_time = (sinc_launch-1)*VCLK_MAX + tick_center_point ;//- (VCLK_MAX>>1);
 
-				//if(sinc_launch==0)
-				//	sinc_launch=0;
+	//if(sinc_launch==0)
+	//	sinc_launch=0;
 
 
-				//if(tick_variable<tick_center_point)
-				//	sinc_roundtrip_time -= VCLK_MAX;
+	//if(tick_variable<tick_center_point)
+	//	sinc_roundtrip_time -= VCLK_MAX;
 
-				debug_history[0][age]=tick_center_point;
-				debug_history[1][age]=tick_variable;
-				debug_history[2][age]=sinc_launch;
-				debug_history[3][age]=sinc_roundtrip_time;
-				age++;
-				if(age==HISTORY)
-					age=0;
+	debug_history[0][age]=tick_center_point;
+	debug_history[1][age]=tick_variable;
+	debug_history[2][age]=launch;
+	debug_history[3][age]=sinc_roundtrip_time;
+	age++;
+	if(age==HISTORY)
+		age=0;
 
 
-				vclock_offset = sinc_roundtrip_time>>1;//divide by 2
-				vclock_offset = CLOCK_WRAP(vclock_offset-1); //Actually offsets properly
-				//vclock_offset = CLOCK_WRAP(vclock_offset);
+#if (USE_CLOCK_TRACKER)
+	runSlaveClockTracking(node, launch, clock, ticks);
+#else
+	vclock_offset = sinc_roundtrip_time>>1;//divide by 2
+	vclock_offset = CLOCK_WRAP(vclock_offset-1); //Actually offsets properly
+	//vclock_offset = CLOCK_WRAP(vclock_offset);
 
-				SetupTransmitModulatedSincPulseBufferDelayedFine(fine_delay_estimate[fde_index]);
+	//what the whole sample correction leaves: the odd sample of the round trip and the fraction of the fine delay
+	vclock_offset_error = 0.5f*(sinc_roundtrip_time & 1) + 0.5f*(node->fine_delay_estimate[node->fde_index]
+			- (short)(node->fine_delay_estimate[node->fde_index]));
 
-				while (vclock_counter != vclock_offset) ;//wait for master zero
-				vclock_counter = VCLK_MAX; //correct the vclock
+	//wait for master zero: processFrame() corrects the vclock on the vclock_offset tick, a block based
+	//backend would step over that tick if it was polled from here
+	vclock_correction_pending = 1;
+#endif
 
-				}
+	}
+}
+#endif
 
-				while(state == STATE_CALCULATION){//wait for ISR to timeout and switch state
-//					debugOutput.channel[TRANSMIT_SINC] = sinc_roundtrip_time;
-//					debugOutput.channel[0] = 0;
-//					MCBSP_write(DSK6713_AIC23_DATAHANDLE, debugOutput.combo);
-//					debugOutput.channel[TRANSMIT_SINC] = 0;
-//					//printf("recorded: %d \n",sinc_launch);
-//					MCBSP_write(DSK6713_AIC23_DATAHANDLE, debugOutput.combo);
-				}
-				// done, after 3 vitual clock overflows, ISR will timeout and go to STATE_TRANSMITTING
+#if (STREAM_RECEIVER)
+/**
+ * Runs the matched filter over the received stream a block of 2M lags at a time, each block is the 2N+2M samples from
+ * its first lag on in recbuf (overlap-save), and has the peak tracker confirm the pulses in it. A confirmed pulse is
+ * estimated in a window centred on it. The main loop keeps up as long as it gets a block of samples done in the time
+ * of one, like the frame code does with a sample.
+ */
+void runSlaveStreamAnalysis(NodeContext* node){
+	unsigned long first;
+	short lag, confirmed;
+
+	while(streamBlockReady(&receive_stream, 2*N+2*M)){
+		first = receive_stream.next;
+		copyStreamWindow(node, first);
+#if (!USE_FUSED_DOWNMIX)
+		runReceivedPulseBufferDownmixing(node);
+#endif
+		runReceivedMatchedFilter(node);
+		confirmed = 0;
+		for(lag=0;lag<2*M;lag+=STREAM_LAG_STEP){
+			confirmed |= streamPeakUpdate(&receive_stream, first+lag, (float) node->s[lag],
+					cfarTest(&search_cfar, (float) node->s[lag]));
+		}
+		receive_stream.next = first + 2*M;
+		if(confirmed)
+			runSlaveStreamPulse(node, receive_stream.peakPosition);	// the mask keeps it to one per block
+	}
+}
 
-			}
+/**
+ * Estimates a confirmed pulse like a capture, with the pulse start at lag M (to M+3) of recbuf, and hands it to the
+ * slave clock if it is the reply to the slave's pulse
+ * @param position	stream position of the pulse start at the peak
+ */
+void runSlaveStreamPulse(NodeContext* node, unsigned long position){
+	unsigned long first, latency;
+	StreamStamp start, end;
+	float snr;
+
+	search_cfar.triggers++;
+	if(position < M+3)
+		return;		// at the very start
+	// the clock of the pulse start, and counted back from there: a slip or a wrap inside the window does not move it
+	start = receive_stream.stamp[STREAM_INDEX(position)];
+	// a capture ends its first M samples on the trigger at carrier phase 0, and the fs/4 phase of the fine estimate
+	// counts from there: the window starts up to 3 samples early to be on the same phase
+	first = position - M - ((start.clock-1) & 3);
+	if(!streamHolds(&receive_stream, first, 2*N+2*M))
+		return;		// overwritten while the main loop was behind
+	latency = streamWritten(&receive_stream) - position;
+	if(latency > receive_stream.latencyMax)
+		receive_stream.latencyMax = latency;
+
+#if (USE_CYCLE_PROFILER)
+	profile_tick_t analysisStart = profilerTimerRead();
+#endif
+	copyStreamWindow(node, first);
+	end = receive_stream.stamp[STREAM_INDEX(first + 2*N+2*M-1)];
+	node->recbuf_start_clock = start.clock - (short)(position - first);
+	node->recbuf_start_launch = start.launch;
+#if (!USE_FUSED_DOWNMIX)
+	runReceivedPulseBufferDownmixing(node);
+#endif
+	runReceviedSincPulseTimingAnalysis(node);
+	PROFILE_STOP(PROFILE_TIMING_ANALYSIS, analysisStart);
+	snr = estimateCaptureSnr(node);
+	node->fine_delay_snr[node->fde_index] = snr;
+	if(!cfarValidate(&search_cfar, snr))
+		return;		// a false trigger
+	if(!streamTakeReply(&receive_stream, position))
+		return;		// heard, but not the reply: another node's pulse, or a second one in the exchange
+
+	runSlaveDelayUpdate(node, start.launch, end.clock+1, end.ticks - receive_stream.lastTicks);
+	receive_stream.lastTicks = end.ticks;
+}
 
-		#endif
+/**
+ * Copies 2N+2M samples of the stream into recbuf
+ * @param first	stream position of recbuf[0]
+ */
+void copyStreamWindow(NodeContext* node, unsigned long first){
+	short tap;
+
+	for(tap=0;tap<(2*N+2*M);tap++)
+		node->recbuf[tap] = (capture_t) receive_stream.ring[STREAM_INDEX(first + tap)];
+}
+#endif
 
+/**
+ * Runs the node over a block of codec frames. Each frame is one sample of both channels, in the order of the
+ * 32 bit codec word, so in[2*f + RECEIVE_SINC] is the received sample of frame f.
+ * @param in		frames from the codec
+ * @param out		frames to the codec, fully written
+ * @param frames	number of frames in the block
+ */
+void process(const short* in, short* out, size_t frames){
+	size_t f;
 
+	for(f = 0; f < frames; f++){
+		frameIn = in + f*FRAME_CHANNELS;
+		frameOut = out + f*FRAME_CHANNELS;
+		processFrame();
 	}
 }
 
-interrupt void serialPortRcvISR()
+/**
+ * The per sample node state machine (formerly the McBSP receive ISR), works on frameIn and frameOut
+ */
+void processFrame()
 {
+	NodeContext* node = &node_context;
 
-	tempInput.combo = MCBSP_read(DSK6713_AIC23_DATAHANDLE);
-	tempOutput.combo = 0; //Set to zero now for missed sets.
-	// Note that right channel is in temp.channel[0]
-	// Note that left channel is in temp.channel[1]
+	PROFILE_START(profile_frame_start);
 
-	//run_head = INDEX_WRAP(++run_head);
+	frameOut[CHANNEL_LEFT] = 0; //Set to zero now for missed sets.
+	frameOut[CHANNEL_RIGHT] = 0;
+	// Note that right channel is in frameIn[0]
+	// Note that left channel is in frameIn[1]
 
 	vclock_counter++; //Note! --- Not sure of the effects of moving the increment to the top
 	//Clock counter wrap
 	#if (NODE_TYPE==MASTER_NODE)
 
-		run_head = INDEX_WRAP(++run_head);
-
 		if (vclock_counter>=(VCLK_MAX)) {
 			vclock_counter = 0; // wrap
 			if(state == STATE_CALCULATION)
 				state = STATE_TRANSMIT;
-			//tempOutput.channel[TRANSMIT_CLOCK] = 32000; //Left channel for debug, doesn't really do anything
-			//clk_flag = 1;
+#if (USE_TDMA)
+			tdma_tick++;
+			if(tdma_tick >= TDMA_SUPERFRAME_TICKS){
+				tdma_tick = 0;
+				tdma_superframe++;
+			}
+#endif
+			eventQueuePost(&node_events, EVENT_TICK_WRAPPED, 0, wait_count);
+			//frameOut[TRANSMIT_CLOCK] = 32000; //Left channel for debug, doesn't really do anything
 		}
 		else{
-			tempOutput.channel[TRANSMIT_CLOCK] = 0; //Left channel for debug, doesn't really do anything
+			frameOut[TRANSMIT_CLOCK] = 0; //Left channel for debug, doesn't really do anything
 		}
 
-		if(vclock_counter == (4096-512))
-			clk_flag = 1;
-
-//		tempOutput.channel[TRANSMIT_SINC] = ML[INDEX_WRAP(run_head)];
-//		ML[INDEX_WRAP(run_head)] = 0;	// zero the buffer after we use it
-//
-//		//just for debug output zero-delayed clock sinc along with master's response sinc
-//		tempOutput.channel[TRANSMIT_CLOCK] = MR[INDEX_WRAP(run_head)];
-//		MR[INDEX_WRAP(run_head)] = 0;	// zero the buffer after we use it
-
-		if(clk_flag)
-			runResponseClkSinc();
+		if(vclock_counter == (4096-512)){
+			PROFILE_START(profile_part_start);
+			pulseSchedule(&pulse_scheduler, pulse_scheduler.now, tModulatedSincPulse, OUTPUT_BUF_SIZE,
+					PULSE_UNITY_GAIN, TRANSMIT_CLOCK);
+			PROFILE_STOP(PROFILE_CLK_SINC, profile_part_start);
+		}
 
-	#elif(NODE_TYPE==SLAVE_NODE)
+	#elif(SLAVE_ROLE)
 
-		run_head = CLOCK_WRAP(++run_head);
-		//run_head_sl = INDEX_WRAP(++run_head_sl);
+#if (NODE_TYPE==RELAY_NODE)
+		relay_tick = 0;
+#endif
 
 		if (vclock_counter>=(VCLK_MAX)){ //runs at 1/2x rate of master for clock pulses, might want to switch variables?
 			vclock_counter = 0;
-			//tempOutput.channel[TRANSMIT_CLOCK] = 32000;
-			clk_flag = 1;
+#if (NODE_TYPE==RELAY_NODE)
+			relay_tick = 1;		// the skew compensation may start the tick off 0, the children's tick is this wrap
+#endif
+			//frameOut[TRANSMIT_CLOCK] = 32000;
+#if (USE_CLOCK_TRACKER)
+			// the tracked offset and the skew not slipped out yet, with the step a correction left pending
+			clock_tick_error = slave_clock.offset + vclock_skew_phase/65536.0f
+					+ (vclock_step_pending ? vclock_step : 0);
+#endif
+			PROFILE_START(profile_part_start);
+			scheduleClockSincISR();
+			PROFILE_STOP(PROFILE_CLK_SINC, profile_part_start);
 			sinc_launch++;
+#if (STREAM_RECEIVER)
+			receive_stream.ticks++;
+#endif
+#if (USE_CLOCK_TRACKER)
+			runSkewCompensationISR(node);
+#endif
+			eventQueuePost(&node_events, EVENT_TICK_WRAPPED, 0, sinc_launch);
 		}
 		else{
-			//tempOutput.channel[TRANSMIT_CLOCK] = 0;
+			//frameOut[TRANSMIT_CLOCK] = 0;
 		}
 
-		// dynamicly delayed clock tick (sinc)
-		//tempOutput.channel[TRANSMIT_CLOCK] = SR[CLOCK_WRAP(vclock_counter)];
-		//SR[CLOCK_WRAP(vclock_counter)] = 0;	// zero the clock buffer after
-
-		// incomming sinc from slave
-		//tempOutput.channel[TRANSMIT_SINC] = SL[INDEX_WRAP(run_head_sl)];
-
 		// update sinc start virtual clock
 
-		if (sinc_launch>=4) {//x*VCLK_MAX, x dictates the timeout, 3 should be enough
+#if (USE_TDMA)
+		if (sinc_launch>=TDMA_SUPERFRAME_TICKS) {//once per superframe, always in the same slot
+#elif (USE_CLOCK_TRACKER)
+		if (sinc_launch>=sync_exchange_ticks) {//x*VCLK_MAX, x dictates the timeout, 3 should be enough
+#else
+		if (sinc_launch>=SYNC_EXCHANGE_TICKS) {//x*VCLK_MAX, x dictates the timeout, 3 should be enough
+#endif
 			sinc_launch = 0; //
+#if (USE_PIPELINED_CAPTURE)
+			node->spareIndex = 0;	// anything caught before the new pulse cannot be its reply
+#endif
 			state=STATE_TRANSMIT;//timeout reached, no sinc reflected from master, send sinc again
 			//state=STATE_SEARCHING;
-			DSK6713_LED_off(STATE_CALCULATION);
-			DSK6713_LED_on(STATE_TRANSMIT);
+			indicatorLedOff(STATE_CALCULATION);
+			indicatorLedOn(STATE_TRANSMIT);
 			ToggleDebugGPIO(STATE_TRANSMIT);
 		}
 
-		if(clk_flag)
-			runResponseClkSinc();
-
-
 	#endif
 //		if(coarse_delay_estimate[cde_index] == vclock_counter)
 //			//ToggleDebugGPIO(0);
@@ -664,38 +1237,54 @@ interrupt void serialPortRcvISR()
 
 
 
+#if (USE_PIPELINED_CAPTURE && !(USE_FDM_BANK && NODE_TYPE==MASTER_NODE) && !STREAM_RECEIVER)	// nor does the stream
+	// the node is busy with recbuf (master: until its reply is sent, slave: while calculating), so keep the
+	// detector and the spare slot going
+	#if (NODE_TYPE==MASTER_NODE)
+	if(state>=STATE_CALCULATION || node->spareIndex>0)
+	#elif (SLAVE_ROLE)
+	if(state==STATE_CALCULATION || node->spareIndex>0)
+	#endif
+	{
+		PROFILE_START(profile_part_start);
+		runBackgroundCaptureISR(node);
+		PROFILE_STOP(PROFILE_BACKGROUND_CAPTURE, profile_part_start);
+	}
+#endif
+
+#if (USE_CYCLE_PROFILER)
+	profile_state = state;		// the handler is timed under the state it was entered in
+#endif
+	PROFILE_START(profile_part_start);
+
 	//Run all interrupt routine logic for the master node here
 	#if (NODE_TYPE==MASTER_NODE)
+#if (USE_FDM_BANK)
+		runFdmBankISR(node);	// each channel runs its own copy of the states below
+#else
+#if (USE_CFAR_THRESHOLD)
+		if (capture_rejected && (state==STATE_CALCULATION || state==STATE_TRANSMIT))
+			dropRejectedCaptureISR(node);	// no reply to a false trigger
+#endif
 		if (state==STATE_SEARCHING) {
-			runSearchingStateCodeISR();
+			runSearchingStateCodeISR(node);
 		}
 		else if (state==STATE_RECORDING) {
 			//runRecordingStateCodeISR();
-			recbuf[recbufindex] = (float) tempInput.channel[RECEIVE_SINC];  // right channel
-			if (abs(recbuf[recbufindex])>max_recbuf) {
+			node->recbuf[node->recbufindex] = (capture_t) frameIn[RECEIVE_SINC];  // right channel
+			if (CAPTURE_ABS(node->recbuf[node->recbufindex])>node->max_recbuf) {
 
-				max_recbuf = abs(recbuf[recbufindex]); // keep track of largest sample
+				node->max_recbuf = CAPTURE_ABS(node->recbuf[node->recbufindex]); // keep track of largest sample
 
 			}
-			recbufindex++;
-			if (recbufindex==(2*N+2*M)) {
+			node->recbufindex++;
+			if (node->recbufindex==(2*N+2*M)) {
 				//CurTime = vclock_counter;
 				//recbufindex--;
-				state = STATE_CALCULATION;  // buffer is full (stop recording)
-				DSK6713_LED_off(STATE_RECORDING);
-				DSK6713_LED_on(STATE_CALCULATION);
-				ToggleDebugGPIO(STATE_CALCULATION);
-				//recbufindex = 0; // shouldn't be necessary
-				if (max_recbuf<2048)
-					playback_scale = 0;  // don't send response (signal was too weak)
-				else if (max_recbuf<4096)
-					playback_scale = 8;  // reply and scale by 8
-				else if (max_recbuf<8192)
-					playback_scale = 4;  // reply and scale by 4
-				else if (max_recbuf<16384)
-					playback_scale = 2;  // reply and scale by 2
-				else
-					playback_scale = 1;  // no scaling
+#if (USE_TDMA)
+				capture_tick = tdmaCaptureTickISR();
+#endif
+				finishRecordingISR(node);  // buffer is full (stop recording)
 			}
 
 			//vclock_complement = VCLK_MAX - vclock_counter;
@@ -711,8 +1300,8 @@ interrupt void serialPortRcvISR()
 //				if (vclock_counter == vclock_complement)	// wait for complement
 //				{
 //					state=STATE_TRANSMIT;//
-//					DSK6713_LED_off(STATE_CALCULATION);
-//					DSK6713_LED_on(STATE_TRANSMIT);
+//					indicatorLedOff(STATE_CALCULATION);
+//					indicatorLedOn(STATE_TRANSMIT);
 //					amWaiting = 0;
 //				}
 			wait_count++;//on overflow state changes
@@ -724,28 +1313,46 @@ interrupt void serialPortRcvISR()
 			wait_count--;
 			if(wait_count==0){
 				state = STATE_SENDSINC;
-				recbufindex=(2*N+2*M);
+				node->recbufindex=(2*N+2*M);
 			}
 		}else if(state==STATE_SENDSINC){
-			recbufindex--;
-			if (recbufindex>=0) {
-				tempOutput.channel[TRANSMIT_SINC] = playback_scale*recbuf[recbufindex];
+			node->recbufindex--;
+			if (node->recbufindex>=0) {
+				frameOut[TRANSMIT_SINC] = playback_scale*node->recbuf[node->recbufindex];
 			}
 			else
 			{
+				eventQueuePost(&node_events, EVENT_TRANSMIT_DONE, vclock_counter, playback_scale);
+#if (USE_PIPELINED_CAPTURE)
+				resumeSearchingISR(node);  // go back to searching, or straight on with the spare capture
+#else
 				state = STATE_SEARCHING;  // go back to searching
+#endif
 			}
 		}
+#endif
 
 	//Run all interrupt routines for the slave node here
-	#elif (NODE_TYPE==SLAVE_NODE)
+	#elif (SLAVE_ROLE)
 
 		//Control code for states and receiving stuff
+#if (USE_CFAR_THRESHOLD)
+		if(capture_rejected && state==STATE_CALCULATION)
+			dropRejectedCaptureISR(node);	// back to listening for the reply
+#endif
+#if (STREAM_RECEIVER)
+		// every sample goes to the main loop, which finds the reply in the stream. Labelled like a capture's samples.
+		streamPush(&receive_stream, frameIn[RECEIVE_SINC], vclock_counter-1, sinc_launch);  // right channel
 		if(state==STATE_SEARCHING) {
-			runSearchingStateCodeISR();
+			// listening is all the main loop's
 		}
+#else
+		if(state==STATE_SEARCHING) {
+			runSearchingStateCodeISR(node);
+		}
+#endif
 		else if(state==STATE_RECORDING){
-			runRecordingStateCodeISR();
+			runRecordingStateCodeISR(node);
 		}
 		else if(state==STATE_CALCULATION){
 			runCalculationStateCodeISR();
@@ -757,7 +1364,7 @@ interrupt void serialPortRcvISR()
 
 			vir_clock_start = VCLK_MAX-N-(VCLK_MAX>>1);	// subject to change
 
-			runResponseStateCodeISR();//this function will change state when it's done
+			runResponseStateCodeISR(node);//this function will change state when it's done
 
 		}
 		else {
@@ -766,43 +1373,75 @@ interrupt void serialPortRcvISR()
 
 	#endif
 
-	local_carrier_phase = ((char) vclock_counter) & 3;
+	PROFILE_STOP(profile_state, profile_part_start);
 
-	//if(clk_flag)
-	//	runResponseClkSinc();
+	// the scheduled pulses go out on top of whatever the states send
+	PROFILE_START(profile_part_start);
+	pulseSchedulerMix(&pulse_scheduler, frameOut);
+	PROFILE_STOP(PROFILE_PULSE_MIX, profile_part_start);
 
-	//Write the output sample to the audio codec
-	MCBSP_write(DSK6713_AIC23_DATAHANDLE, tempOutput.combo);
+#if (NODE_TYPE==RELAY_NODE)
+	{
+		// the downlink reply goes out on top of whatever the slave states send to the parent
+		int sent = frameOut[TRANSMIT_SINC] + relayDownlinkSample(&relay_downlink, frameIn[RECEIVE_SINC], relay_tick);
+		if (sent>32767)
+			sent = 32767;
+		else if (sent<-32768)
+			sent = -32768;
+		frameOut[TRANSMIT_SINC] = (short) sent;
+	}
+#endif
 
-}
+	local_carrier_phase = ((char) vclock_counter) & 3;
 
-/**
-	Sets up the transmit buffer for the sinc pulse modulated at quarter sampling frequency
-*/
-void SetupTransmitModulatedSincPulseBuffer(){
+#if (SLAVE_ROLE)
+	if(vclock_correction_pending && vclock_counter == vclock_offset){
+#if (USE_PIPELINED_CAPTURE)
+		if(node->spareIndex>0)
+			node->spareStartClock += VCLK_MAX - vclock_offset;	// keep the spare capture on the corrected clock
+#endif
+		vclock_counter = VCLK_MAX; //correct the vclock, the next frame wraps it to the master zero
+		vclock_correction_pending = 0;
+#if (!USE_CLOCK_TRACKER)
+		clock_tick_error = vclock_offset_error;		// of the tick that starts on the next frame
+#endif
+	}
+#endif
+
+	PROFILE_STOP(PROFILE_FRAME, profile_frame_start);
+}
+
+/**
+	Sets up the transmit buffer for the sinc pulse modulated at the carrier (carrier_freq)
+*/
+void SetupTransmitModulatedSincPulseBuffer(){
+	short i;
+	double x, y, t;
 
 	for (i=-N;i<=N;i++){
 		x = i*BW;//(i+0.5)*BW
-		t = i*0.25;//(i+0.5)*0.25
+		t = i*carrier_freq;//(i+0.5)*carrier_freq
 		if (i!=0)
-			y = cos(2*PI*t)*(sin(PI*x)/(PI*x)); // modulated sinc pulse at carrier freq = fs/4
+			y = cos(2*PI*t)*(sin(PI*x)/(PI*x)); // modulated sinc pulse at carrier freq = carrier_freq
 		else
 			y = 1;								//x = 0 case.
-		tModulatedSincPulse[i+N] = y*32767;
+		tModulatedSincPulse[i+N] = y*MODULATED_SINC_PEAK;
 	}
 }
 
 /**
-	Sets up the transmit buffer for the sinc pulse modulated at quarter sampling frequency
+	Sets up the transmit buffer for the sinc pulse modulated at the carrier (carrier_freq)
 	Delayed by half a sample.
 */
 void SetupTransmitModulatedSincPulseBufferDelayed(){
+	short i;
+	double x, y, t;
 
 	for (i=-N;i<=N;i++){
 		x = ((double)i-0.5)*BW;
-		t = ((double)i-0.5)*0.25;
+		t = ((double)i-0.5)*carrier_freq;
 		//if (i!=0)
-			y = cos(2*PI*t)*(sin(PI*x)/(PI*x)); // modulated sinc pulse at carrier freq = fs/4
+			y = cos(2*PI*t)*(sin(PI*x)/(PI*x)); // modulated sinc pulse at carrier freq = carrier_freq
 		//else
 		//	y = 1;								//x = 0 case.
 		tModulatedSincPulse_delayed[i+N] = y*32767;
@@ -842,118 +1481,130 @@ void setupTransmitBuffer(short tBuffer[], short halfBufLen, double sincBandwidth
 	}
 }
 
+#if (SLAVE_ROLE)
 /**
-	Sets up the transmit buffer for the sinc pulse modulated at quarter sampling frequency
-	Delayed by half a sample.
+	Schedules the slave's clock sinc for the tick that starts on this frame, CLOCK_SINC_DELAY + clock_tick_error
+	samples late so it peaks where the master's tick is to a fraction of a sample, which the whole sample clock can not.
+	The whole samples of the delay start it later, the fraction is in the pulse: read from the waveform bank row it
+	rounds to, or synthesized while it plays if there is no bank or the bank is not exact for this carrier.
 */
-void SetupTransmitModulatedSincPulseBufferDelayedFine(float fineDelay){
-
-//	if(fineDelay == 0.0){
-//		for (i=-N;i<=N;i++){
-//			xf = ((float)i-fineDelay)*BW;
-//			tf = ((float)i-fineDelay)*0.25;
-//			if (i!=0)
-//				yf = cos(2*PI*tf)*(sin(PI*xf)/(PI*xf)); // modulated sinc pulse at carrier freq = fs/4
-//			else
-//				yf = 1;								//x = 0 case.
-//				ML[INDEX_WRAP(calc_head + i + N)] = yf*32767;
-//		}
-//	}else{
-//		for (i=-N;i<=N;i++){
-//			xf = ((float)i-fineDelay)*BW;
-//			tf = ((float)i-fineDelay)*0.25;
-//			//if (i!=0)
-//				yf = cos(2*PI*tf)*(sin(PI*xf)/(PI*xf)); // modulated sinc pulse at carrier freq = fs/4
-//			//else
-//			//	y = 1;								//x = 0 case.
-//				ML[INDEX_WRAP(calc_head + i + N)] = yf*32767;
-//		}
-//	}
-
-#if (NODE_TYPE==MASTER_NODE)
-	//copy the hardcoded sinc from SDRAM into the ML buffer in IRAM
-	//figure out which of the hardcoded suncs is the best approximation to the fine_delay_estimate
-	// if MAXDELAY = 100, then max resolution is 0.01, and we need to round ...
-
-	float_history[0][age] = fineDelay;
-
-	if(fineDelay < 0)
-		fineDelay *= -1.0;//make positive
-
-	if(((int)(fineDelay*1000)%10) >= 5.0)	// there must be a smarter way to roud
-		fineDelay += 0.01;
-
-	int index = ((int)(fineDelay*100))%100;	// might need to add an offset to the fine delay ...
-
-	index_history[0][age] = index;
-
-	age++;
-	if(age==HISTORY)
-		age=0;
-
-	if(index > 99 || index < 0)
-		index = 0;//this shouldn't happen, just for debug
-
-	for (i=-N;i<=N;i++){
-		ML[INDEX_WRAP(calc_head + i + N)] =  allMyDelayedWaveforms[index][i + N];
-	}
-#elif (NODE_TYPE==SLAVE_NODE)
-	//copy the hardcoded sinc from SDRAM into the ML buffer in IRAM
-	//figure out which of the hardcoded suncs is the best approximation to the fine_delay_estimate
-	// if MAXDELAY = 100, then max resolution is 0.01, and we need to round ...
-
-	float_history[0][age] = fineDelay;
-
-	if(fineDelay < 0)//should never be negative
-		fineDelay *= -1.0;//make positive
-
-	if(((int)(fineDelay*1000)%10) >= 5.0)	// there must be a smarter way to roud
-		fineDelay += 0.01;
-
-	int index = ((int)(fineDelay*100))%100;	// might need to add an offset to the fine delay ...
-
-	index_history[0][age] = index;
-
-	age++;
-	if(age==HISTORY)
-		age=0;
-
-	if(index > 99 || index < 0)
-		index = 0;//this shouldn't happen, just for debug
-
-	for (i=-N;i<=N;i++){
-		SR[CLOCK_WRAP(i + N)] =  allMyDelayedWaveforms[index][i + N];
+void scheduleClockSincISR(){
+	float delay = CLOCK_SINC_DELAY + clock_tick_error;
+	short whole;
+
+	if(delay < 0)
+		delay = 0;			// a tick this far off is about to be corrected
+	else if(delay >= 2*CLOCK_SINC_DELAY)
+		delay = 2*CLOCK_SINC_DELAY - 1.0f/MAXDELAY;
+	whole = (short) delay;
+#if (!USE_PULSE_SYNTH)
+	if(waveform_bank_misfits == 0){
+		clockSincRow[clockSincNext] = (short)((delay - whole)*MAXDELAY + 0.5f);
+		if(clockSincRow[clockSincNext] == MAXDELAY){
+			clockSincRow[clockSincNext] = 0;
+			whole++;
+		}
+		pulseScheduleSource(&pulse_scheduler, pulse_scheduler.now + whole, clockSincBankSample,
+				&clockSincRow[clockSincNext], OUTPUT_BUF_SIZE, PULSE_UNITY_GAIN, TRANSMIT_CLOCK);
+		clockSincNext ^= 1;
+		return;
 	}
 #endif
+	startDelayedPulse(&clockSincSynth[clockSincNext], N, BW, carrier_freq, delay - whole);
+	pulseScheduleSource(&pulse_scheduler, pulse_scheduler.now + whole, clockSincSynthSample,
+			&clockSincSynth[clockSincNext], OUTPUT_BUF_SIZE, PULSE_UNITY_GAIN, TRANSMIT_CLOCK);
+	clockSincNext ^= 1;
+}
 
+/**
+	PulseSource of the slave's clock sinc from the synthesizer
+	@param synth	its PulseSynth
+*/
+short clockSincSynthSample(void* synth, short offset){
+	(void) offset;		// the synthesizer keeps its own place
+	return nextDelayedPulseSample((PulseSynth*) synth);
 }
 
+#if (!USE_PULSE_SYNTH)
+/**
+	PulseSource of the slave's clock sinc from the waveform bank
+	@param row		its waveform bank row
+*/
+short clockSincBankSample(void* row, short offset){
+	return delayedWaveformSample(*(short*) row, offset - N);
+}
+#endif
+#endif
+
 /**
 	Sets up the buffer used for matched filtering of the sinc pulse
 */
 void SetupReceiveBasebandSincPulseBuffer(){
+	short i;
+	double x, y;
+
 	for (i=-N;i<=N;i++){
 		x = i*BW;
 		if (i!=0)
 			y = sin(PI*x)/(PI*x); // double
 		else
 			y = 1.0;
-		basebandSincRef[i+N] = (float) y;
+		basebandSincRef[i+N] = COEF_FROM_FLOAT(y);
 	}
+	basebandSincEnergy = 0;
+	for (i=0;i<(2*N+1);i++)
+		basebandSincEnergy += COEF_TO_FLOAT(basebandSincRef[i])*COEF_TO_FLOAT(basebandSincRef[i]);
+#if (!USE_FIXED_POINT)
+	SetupFastCorrelatorReference(basebandSincRef, 2*N+1);	// cache the reference spectrum for the FFT matched filter
+#endif
 }
 
 /**
 	Sets up the matched filter buffers which are used for matching and filtering of the incoming sines and cosines
 */
 void SetupReceiveTrigonometricMatchedFilters(){
+	short i;
+	double t, y;
+
 	for (i=0;i<M;i++){
-		t = i*0.25;				// time
+		t = i*carrier_freq;		// time
 		y = cos(2*PI*t);		// cosine matched filter (double)
-		matchedFilterCosine[i] = (float) y;		// cast and store
+		matchedFilterCosine[i] = COEF_FROM_FLOAT(y);		// cast and store
 		y = sin(2*PI*t);		// sine matched filter (double)
-		matchedFilterSine[i] = (float) y;     // cast and store
-		buf[i] = 0;             // clear searching buffer
+		matchedFilterSine[i] = COEF_FROM_FLOAT(y);     // cast and store
+	}
+}
+
+/**
+ * Copies the tables host/TableGen.c generated into PulseTables.h, replaces setting them up from the formulas
+ * @return 1 if the tables are for this build, BW and carrier_freq (an FDM slave's carrier is its channel's), else 0
+ */
+short loadPulseTables(){
+#if (PULSE_TABLES_FIT)
+	short i;
+
+	if(PULSE_TABLES_BW != BW || PULSE_TABLES_CBW != carrier_freq)
+		return 0;
+
+	for (i=0;i<N2;i++){
+		standardWaveformBuffer[i] = pulseTableStandard[i];
+		delayedWaveformBuffer[i] = pulseTableStandard[i];		// also delay 0
+		tModulatedSincPulse[i] = pulseTableModulatedSinc[i];
+		tModulatedSincPulse_delayed[i] = pulseTableModulatedSincDelayed[i];
+		basebandSincRef[i] = pulseTableBasebandSinc[i];
+	}
+	basebandSincEnergy = pulseTableBasebandSincEnergy;
+	for (i=0;i<M;i++){
+		matchedFilterCosine[i] = pulseTableMatchedCosine[i];
+		matchedFilterSine[i] = pulseTableMatchedSine[i];
 	}
+#if (!USE_FIXED_POINT)
+	SetupFastCorrelatorReference(basebandSincRef, 2*N+1);
+#endif
+	return 1;
+#else
+	return 0;
+#endif
 }
 
 /**
@@ -1023,68 +1674,368 @@ void SetupReceiveTrigonometricMatchedFilters(){
 //}
 
 
-void runSearchingStateCodeISR(){
+void runSearchingStateCodeISR(NodeContext* node){
+	if (runSearchDetectorISR(node)) {
+		state = STATE_RECORDING; // enter "recording" state (takes effect in next interrupt), NO it takes effect in the same ISR (if instead of elseif)
+		indicatorLedOff(STATE_SEARCHING);
+		indicatorLedOn(STATE_RECORDING);
+		ToggleDebugGPIO(STATE_RECORDING);
+		node->recbuf_start_clock = vclock_counter - CAPTURE_LEAD; // virtual clock tick at at start of recording buffer
+												 // (might be negative but doesn't matter)
+		node->recbuf_start_launch = sinc_launch;
+		node->recbufindex = CAPTURE_LEAD;		// start recording new samples at position CAPTURE_LEAD
+		startRecordingISR(node, node->recbuf);
+	}
+}
+
+/**
+ * Runs the searching correlation on the current sample
+ * @return 1 if a pulse was detected (on carrier phase 0 with the fs/4 detector), the caller then starts a recording with
+ * startRecordingISR()
+ */
+short runSearchDetectorISR(NodeContext* node){
+#if (USE_FDM_BANK && SLAVE_ROLE)
+	// all channels are searched so the other slaves' pulses, which leak into the own channel, can be told apart
+	capture_t sample = (capture_t) frameIn[RECEIVE_SINC];  // right channel
+#if (USE_CFAR_THRESHOLD)
+	unsigned int hits = fdmSearchSample(&fdm_bank, sample, search_cfar.threshold);
+	cfarUpdate(&search_cfar, fdmNoiseMetric(&fdm_bank));
+#else
+	unsigned int hits = fdmSearchSample(&fdm_bank, sample, T1);
+#endif
+
+	node->buf[node->bufindex] = sample;
+	node->bufindex++;
+	if (node->bufindex>=CAPTURE_LEAD)
+		node->bufindex = 0;
+	node->corrSumIncoherent = fdm_bank.metric[fdm_channel];
+
+	return (hits>>fdm_channel)&1;
+#else
+	short onCarrier = runSearchCorrelator(node, (capture_t) frameIn[RECEIVE_SINC], local_carrier_phase);  // right channel
+
+#if (USE_CFAR_THRESHOLD)
+	// the floor takes every phase
+	return cfarTest(&search_cfar, (float) node->corrSumIncoherent)&&onCarrier;
+#else
+	return (node->corrSumIncoherent>T1)&&onCarrier;  // xxx should make sure this runs in real-time
+#endif
+#endif
+}
+
+#if (!(USE_FDM_BANK && SLAVE_ROLE))
+/**
+ * Slides the searching window over one received sample and updates corrSumIncoherent, the threshold is up to the
+ * caller (runSearchDetectorISR(), or host/CaptureAnalyzer.c without the node's globals)
+ * @param sample		received sample
+ * @param carrierPhase	fs/4 carrier phase of the sample (local_carrier_phase)
+ * @return 1 if a capture may start on this sample: on carrier phase 0 for the fs/4 detector, on a window that is
+ * coherent on the own carrier for the NCO one
+ */
+short runSearchCorrelator(NodeContext* node, capture_t sample, char carrierPhase){
+#if (USE_NCO_DOWNMIX)
+	// mixed down with the free running oscillator, the sums over the last M baseband samples are the correlation with
+	// an M sample carrier at whatever phase the pulse comes in with, and they need no whole number of carrier periods
+	float mixedCosine = sample*NCO_COS(node->searchNco.phase);
+	float mixedSine = sample*NCO_SIN(node->searchNco.phase);
+	node->searchNco.phase += node->searchNco.step;
+#if (USE_SLIDING_DETECTOR)
+	node->corrSumCosine += mixedCosine - node->searchMixedCosine[node->bufindex];
+	node->corrSumSine += mixedSine - node->searchMixedSine[node->bufindex];
+	node->corrSumEnergy += (float) sample*sample - (float) node->buf[node->bufindex]*node->buf[node->bufindex];
+	node->corrFreshCosine += mixedCosine;
+	node->corrFreshSine += mixedSine;
+	node->corrFreshEnergy += (float) sample*sample;
+#endif
+	node->buf[node->bufindex] = sample;
+	node->searchMixedCosine[node->bufindex] = mixedCosine;
+	node->searchMixedSine[node->bufindex] = mixedSine;
+
+	node->bufindex++;
+	if (node->bufindex>=M){
+		node->bufindex = 0;
+#if (USE_SLIDING_DETECTOR)
+		node->corrSumCosine = node->corrFreshCosine;
+		node->corrSumSine = node->corrFreshSine;
+		node->corrSumEnergy = node->corrFreshEnergy;
+		node->corrFreshCosine = 0;
+		node->corrFreshSine = 0;
+		node->corrFreshEnergy = 0;
+#endif
+	}
+#if (!USE_SLIDING_DETECTOR)
+	{
+		short tap;
+		node->corrSumCosine = 0;
+		node->corrSumSine = 0;
+		node->corrSumEnergy = 0;
+		for(tap=0;tap<M;tap++) {
+			node->corrSumCosine += node->searchMixedCosine[tap];
+			node->corrSumSine += node->searchMixedSine[tap];
+			node->corrSumEnergy += (float) node->buf[tap]*node->buf[tap];
+		}
+	}
+#endif
+	node->corrSumIncoherent = (metric_t)node->corrSumCosine*node->corrSumCosine
+			+ (metric_t)node->corrSumSine*node->corrSumSine;
+
+	// recbuf is downmixed from its own first sample, any carrier phase will do. But only on the own carrier: another
+	// node's pulse on a neighbouring one still crosses the threshold.
+	return node->corrSumIncoherent>=NCO_COHERENCE*M*node->corrSumEnergy;
+#elif (USE_SLIDING_DETECTOR)
+	// only buf[bufindex] changes, and M is a whole number of fs/4 carrier periods so the outgoing sample sat at the
+	// same carrier phase as the incoming one, so the sums just move by the difference rotated by that phase
+	corr_t delta = (corr_t) sample - node->buf[node->bufindex];
+	node->corrSumCosine += COEF_MUL(matchedFilterCosine[node->bufindex],delta);
+	node->corrSumSine += COEF_MUL(matchedFilterSine[node->bufindex],delta);
+	node->corrFreshCosine += COEF_MUL(matchedFilterCosine[node->bufindex],sample);
+	node->corrFreshSine += COEF_MUL(matchedFilterSine[node->bufindex],sample);
+	node->buf[node->bufindex] = sample;
+
+	// increment and wrap pointer
+	node->bufindex++;
+	if (node->bufindex>=M){
+		node->bufindex = 0;
+		// renormalize: the fresh sums now cover exactly the M samples in buf, so rounding never builds up
+		node->corrSumCosine = node->corrFreshCosine;
+		node->corrSumSine = node->corrFreshSine;
+		node->corrFreshCosine = 0;
+		node->corrFreshSine = 0;
+	}
+#else
+	short tap;
 
 		// put sample in searching buffer
-	buf[bufindex] = (float) tempInput.channel[RECEIVE_SINC];  // right channel
+	node->buf[node->bufindex] = sample;
 
 	// increment and wrap pointer
-	bufindex++;
-	if (bufindex>=M)
-		bufindex = 0;
+	node->bufindex++;
+	if (node->bufindex>=M)
+		node->bufindex = 0;
 
 	// compute incoherent correlation
-	corrSumCosine = 0;
-	corrSumSine = 0;
-	for(i=0;i<M;i++) {
-		corrSumCosine+= matchedFilterCosine[i]*buf[i];
-		corrSumSine+= matchedFilterSine[i]*buf[i];
+	node->corrSumCosine = 0;
+	node->corrSumSine = 0;
+	for(tap=0;tap<M;tap++) {
+		node->corrSumCosine+= COEF_MUL(matchedFilterCosine[tap],node->buf[tap]);
+		node->corrSumSine+= COEF_MUL(matchedFilterSine[tap],node->buf[tap]);
 	}
-	corrSumIncoherent = corrSumCosine*corrSumCosine+corrSumSine*corrSumSine;
+#endif
+	node->corrSumIncoherent = (metric_t)node->corrSumCosine*node->corrSumCosine
+			+ (metric_t)node->corrSumSine*node->corrSumSine;
 
-	if ((corrSumIncoherent>T1)&&(local_carrier_phase==0)) {  // xxx should make sure this runs in real-time
-		state = STATE_RECORDING; // enter "recording" state (takes effect in next interrupt), NO it takes effect in the same ISR (if instead of elseif)
-		DSK6713_LED_off(STATE_SEARCHING);
-		DSK6713_LED_on(STATE_RECORDING);
-		ToggleDebugGPIO(STATE_RECORDING);
-		recbuf_start_clock = vclock_counter - M; // virtual clock tick at at start of recording buffer
-												 // (might be negative but doesn't matter)
-		recbufindex = M;		// start recording new samples at position M
-		j = bufindex;			//
-		for (i=0;i<M;i++){  	// copy samples from buf to first M elements of recbuf
-			j++;   				// the first time through, this puts us at the oldest sample
-			if (j>=M)
-				j=0;
-			recbuf[i] = buf[j];
-			buf[j] = 0;  		// clear out searching buffer to avoid false trigger
+	return (carrierPhase==0);
+}
+#endif
+
+/**
+ * Moves the searching window into the first CAPTURE_LEAD samples of a capture slot and clears the detector
+ * @param slot	capture buffer, recording continues at position CAPTURE_LEAD
+ */
+void startRecordingISR(NodeContext* node, capture_t* slot){
+	takeSearchWindow(node, slot);
+#if (USE_FDM_BANK && SLAVE_ROLE)
+	fdmSearchClearChannel(&fdm_bank, fdm_channel);
+#endif
+#if (USE_CFAR_THRESHOLD)
+	search_cfar.triggers++;
+	cfarRestart(&search_cfar);
+#endif
+}
+
+/**
+ * The part of startRecordingISR() that only works on the context: the window goes into the slot and the sums start over
+ */
+void takeSearchWindow(NodeContext* node, capture_t* slot){
+	short dst, src;
+
+	src = node->bufindex;			//
+	for (dst=0;dst<CAPTURE_LEAD;dst++){  	// copy samples from buf to the start of recbuf
+		src++;   				// the first time through, this puts us at the oldest sample
+		if (src>=CAPTURE_LEAD)
+			src=0;
+		slot[dst] = node->buf[src];
+		node->buf[src] = 0;  		// clear out searching buffer to avoid false trigger
+#if (USE_NCO_DOWNMIX && !USE_FDM_BANK)
+		node->searchMixedCosine[src] = 0;
+		node->searchMixedSine[src] = 0;
+#endif
+	}
+	node->corrSumCosine = 0;		// buf is all zeros now, so restart the sliding sums too
+	node->corrSumSine = 0;
+	node->corrFreshCosine = 0;
+	node->corrFreshSine = 0;
+#if (USE_NCO_DOWNMIX)
+	node->corrSumEnergy = 0;
+	node->corrFreshEnergy = 0;
+#endif
+}
+
+/**
+ * recbuf is full, hand it to the calculation
+ */
+void finishRecordingISR(NodeContext* node){
+#if (USE_CFAR_THRESHOLD)
+	capture_rejected = 0;	// a flag for the previous capture does not hold for this one
+#endif
+#if (NODE_TYPE==MASTER_NODE)
+	state = STATE_CALCULATION;  // buffer is full (stop recording)
+#if (USE_TDMA)
+	eventQueuePost(&node_events, EVENT_CAPTURE_READY, vclock_counter, capture_tick);
+#else
+	eventQueuePost(&node_events, EVENT_CAPTURE_READY, vclock_counter, sinc_launch);
+#endif
+	indicatorLedOff(STATE_RECORDING);
+	indicatorLedOn(STATE_CALCULATION);
+	ToggleDebugGPIO(STATE_CALCULATION);
+	//recbufindex = 0; // shouldn't be necessary
+	if (node->max_recbuf<2048)
+		playback_scale = 0;  // don't send response (signal was too weak)
+	else if (node->max_recbuf<4096)
+		playback_scale = 8;  // reply and scale by 8
+	else if (node->max_recbuf<8192)
+		playback_scale = 4;  // reply and scale by 4
+	else if (node->max_recbuf<16384)
+		playback_scale = 2;  // reply and scale by 2
+	else
+		playback_scale = 1;  // no scaling
+#elif (SLAVE_ROLE)
+	CurTime = vclock_counter;
+	state = STATE_CALCULATION;  // buffer is full (stop recording)
+	// the fine estimate counts from the tick the recording started in, a wrap before completion must not add a tick
+	eventQueuePost(&node_events, EVENT_CAPTURE_READY, vclock_counter, node->recbuf_start_launch);
+	indicatorLedOff(STATE_RECORDING);
+	indicatorLedOn(STATE_CALCULATION);
+	ToggleDebugGPIO(STATE_CALCULATION);
+	node->recbufindex = 0; // shouldn't be necessary
+#endif
+}
+
+#if (USE_PIPELINED_CAPTURE)
+/**
+ * Searching and recording into the spare slot while the node works on recbuf. A full spare capture is held until
+ * the node goes back to searching, the master keeps counting its reply time the way STATE_CALCULATION and
+ * STATE_TRANSMIT would.
+ */
+void runBackgroundCaptureISR(NodeContext* node){
+	if (node->spareIndex==0) {
+		if (runSearchDetectorISR(node)) {
+			node->spareStartClock = vclock_counter - CAPTURE_LEAD;
+			node->spareStartLaunch = sinc_launch;
+			node->spareIndex = CAPTURE_LEAD;
+			node->spareWaitCount = 0;
+			node->spareWrapped = 0;
+			startRecordingISR(node, node->recbufSlots[node->spareSlot]);
+		}
+	}
+	else if (node->spareIndex<(2*N+2*M)) {
+		node->recbufSlots[node->spareSlot][node->spareIndex] = (capture_t) frameIn[RECEIVE_SINC];  // right channel
+		if (CAPTURE_ABS(node->recbufSlots[node->spareSlot][node->spareIndex])>node->max_recbuf)
+			node->max_recbuf = CAPTURE_ABS(node->recbufSlots[node->spareSlot][node->spareIndex]); // largest sample
+		node->spareIndex++;
+#if (USE_TDMA && NODE_TYPE==MASTER_NODE)
+		if (node->spareIndex==(2*N+2*M))
+			spareTick = tdmaCaptureTickISR();
+#endif
+	}
+	else {
+		if (vclock_counter==0)
+			node->spareWrapped = 1;
+		if (node->spareWrapped)
+			node->spareWaitCount--;
+		else
+			node->spareWaitCount++;
+	}
+}
+
+/**
+ * The node is done with recbuf. Swap in the spare slot if a capture was started there, and carry on recording or
+ * go straight to the calculation, otherwise search as before.
+ */
+void resumeSearchingISR(NodeContext* node){
+	if (node->spareIndex==0) {
+		state = STATE_SEARCHING;
+		return;
+	}
+
+	node->recbuf = node->recbufSlots[node->spareSlot];
+	node->spareSlot = (node->spareSlot+1) % CAPTURE_SLOTS;
+	node->recbuf_start_clock = node->spareStartClock;
+	node->recbuf_start_launch = node->spareStartLaunch;
+	node->recbufindex = node->spareIndex;
+	node->spareIndex = 0;
+
+	if (node->recbufindex>=(2*N+2*M)) {
+#if (USE_TDMA && NODE_TYPE==MASTER_NODE)
+		capture_tick = spareTick;
+#endif
+		finishRecordingISR(node);
+#if (NODE_TYPE==MASTER_NODE)
+		// the capture was completed a while ago, pick up its reply timing where it is now
+		wait_count = node->spareWaitCount;
+		if (node->spareWrapped) {
+			if (wait_count>0) {
+				state = STATE_TRANSMIT;
+			}
+			else if (wait_count==0) {
+				state = STATE_SENDSINC;
+				node->recbufindex = (2*N+2*M);
+			}
+			else {
+				state = STATE_SEARCHING;	// too late to reply
+				wait_count = 0;
+				late_captures++;
+			}
 		}
+#endif
+	}
+	else {
+		state = STATE_RECORDING;
+		indicatorLedOff(STATE_SEARCHING);
+		indicatorLedOn(STATE_RECORDING);
 	}
 }
+#endif
+
+#if (USE_CFAR_THRESHOLD)
+/**
+ * The main loop found no pulse in recbuf. The node drops it and goes back to searching (or on with the spare
+ * capture) instead of waiting for its reply time or for the timeout.
+ */
+void dropRejectedCaptureISR(NodeContext* node){
+	capture_rejected = 0;
+#if (NODE_TYPE==MASTER_NODE)
+	wait_count = 0;		// where the reply would have left it
+#endif
+	indicatorLedOff(STATE_CALCULATION);
+	indicatorLedOn(STATE_SEARCHING);
+#if (USE_PIPELINED_CAPTURE)
+	resumeSearchingISR(node);
+#else
+	state = STATE_SEARCHING;
+#endif
+}
+#endif
 
-void runRecordingStateCodeISR(){
+void runRecordingStateCodeISR(NodeContext* node){
 	// put sample in recording buffer
-	recbuf[recbufindex] = (float) tempInput.channel[RECEIVE_SINC];  // right channel
-	recbufindex++;
-	if (recbufindex>=(2*N+2*M)) {
-		CurTime = vclock_counter;
-		state = STATE_CALCULATION;  // buffer is full (stop recording)
-		DSK6713_LED_off(STATE_RECORDING);
-		DSK6713_LED_on(STATE_CALCULATION);
-		ToggleDebugGPIO(STATE_CALCULATION);
-		recbufindex = 0; // shouldn't be necessary
+	node->recbuf[node->recbufindex] = (capture_t) frameIn[RECEIVE_SINC];  // right channel
+	node->recbufindex++;
+	if (node->recbufindex>=(2*N+2*M)) {
+		finishRecordingISR(node);  // buffer is full (stop recording)
 	}
 }
 
-void playRecordingStateCodeISR(){
+void playRecordingStateCodeISR(NodeContext* node){
 	// put sample in recording buffer
-	tempOutput.channel[TRANSMIT_SINC] = ((short) recbuf[recbufindex])<<1; // right channel
-	recbufindex--;
+	frameOut[TRANSMIT_SINC] = ((short) node->recbuf[node->recbufindex])<<1; // right channel
+	node->recbufindex--;
 
-	if (recbufindex==0) {
+	if (node->recbufindex==0) {
 		//CurTime = vclock_counter;
 		state = STATE_SEARCHING;  // buffer is full (stop recording)
-		DSK6713_LED_off(STATE_TRANSMIT);
-		DSK6713_LED_on(STATE_SEARCHING);
+		indicatorLedOff(STATE_TRANSMIT);
+		indicatorLedOn(STATE_SEARCHING);
 		ToggleDebugGPIO(STATE_SEARCHING);
 		//recbufindex = 0; // shouldn't be necessary
 	}
@@ -1097,108 +2048,235 @@ void runCalculationStateCodeISR(){
 }
 
 
-void runResponseStateCodeISR(){
-	if(vclock_counter==vir_clock_start){ //Okay, we've reached the appropriate wrap around point where we should start sending the dataers
+void runResponseStateCodeISR(NodeContext* node){
+	//Okay, we've reached the appropriate wrap around point where we should start sending the dataers
+	if(vclock_counter==vir_clock_start && !amSending){
+		//the pulse plays from this frame on, processFrame() mixes it in after the states
+		pulseSchedule(&pulse_scheduler, pulse_scheduler.now, tModulatedSincPulse, response_buf_idx_max,
+				PULSE_UNITY_GAIN, TRANSMIT_SINC);
+		response_end = pulse_scheduler.now + response_buf_idx_max - 1;
 		amSending = -1;
 		//sinc_launch = -1;//center outgoing tick at virtual tick
 						 // start at -1 since we dont want to count the first overflow (happens right away) since it is zero-th point
 	}
-	if(amSending){ //write the buffered output waveform to the output file, adn increment the index counter
-		tempOutput.channel[TRANSMIT_SINC] = tModulatedSincPulse[response_buf_idx];
-		response_buf_idx++;
-	}
-	if(response_buf_idx==response_buf_idx_max){
-		amSending = 0;			//quits the sending part above
-		response_buf_idx = 0;
+	if(amSending && pulse_scheduler.now==response_end){	// its last sample goes out in this frame
+		amSending = 0;			//done, the next pulse starts on the next vir_clock_start
 		state=STATE_SEARCHING;
-		DSK6713_LED_off(STATE_TRANSMIT);
-		DSK6713_LED_on(STATE_SEARCHING);
+		eventQueuePost(&node_events, EVENT_TRANSMIT_DONE, vclock_counter, 0);
+#if (STREAM_RECEIVER)
+		streamListen(&receive_stream);
+#endif
+		indicatorLedOff(STATE_TRANSMIT);
+		indicatorLedOn(STATE_SEARCHING);
 		ToggleDebugGPIO(STATE_SEARCHING);
+#if (USE_PIPELINED_CAPTURE)
+		resumeSearchingISR(node);	// a capture started while busy picks up from here
+#endif
 	}
 }
 
-void runResponseClkSinc(){
-
-	//if(even)
-	//	tempOutput.channel[TRANSMIT_CLOCK] = tModulatedSincPulse[response_buf_idx_clk];
-	//else	//odd
-		tempOutput.channel[TRANSMIT_CLOCK] = tModulatedSincPulse[response_buf_idx_clk];
-
-	response_buf_idx_clk++;
-
-	if(response_buf_idx_clk==response_buf_idx_max){
-		clk_flag = 0;
-		response_buf_idx_clk = 0;
+#if (USE_CLOCK_TRACKER)
+/**
+ * Takes the tracked skew and the small tracker corrections out of the slave clock a whole sample at a time, by
+ * starting the new tick early or late. Held back while a capture is being recorded, all of its samples have to be on
+ * the clock of its start clock. A full spare capture is moved onto the new clock, like vclock_offset does.
+ */
+void runSkewCompensationISR(NodeContext* node){
+	short slip;
 
+	vclock_skew_phase += vclock_skew_per_tick;
+	if(vclock_step_pending){
+		vclock_skew_phase += vclock_step*65536;
+		vclock_step_pending = 0;
+	}
+	if(state==STATE_RECORDING)
+		return;
+#if (USE_PIPELINED_CAPTURE)
+	if(node->spareIndex>0 && node->spareIndex<(2*N+2*M))
+		return;
+#endif
+	slip = (short)((vclock_skew_phase + 0x8000)>>16);	// round to whole samples
+	if(slip != 0){
+		vclock_skew_phase -= slip*65536;
+		vclock_counter = -slip;		// a positive skew lengthens the tick, like a positive correction
+#if (USE_PIPELINED_CAPTURE)
+		if(node->spareIndex>0)
+			node->spareStartClock -= slip;
+#endif
 	}
 }
+#endif
+
+/**
+ * Runs the matched filter over the 2M lags of recbuf (or of its downmix) and fills corr_c, corr_s and s. With
+ * USE_HIERARCHICAL_LAG_SEARCH only the coarse lags and the ones around the best of them are filled, the others are 0.
+ */
+void runReceivedMatchedFilter(NodeContext* node){
+	short i;		// locals, so the lag loops stay in registers
+#if (!(USE_FFT_CORRELATOR && !USE_FIXED_POINT) && USE_HIERARCHICAL_LAG_SEARCH)
+	short k;		// best coarse lag
+#endif
 
-void runReceviedSincPulseTimingAnalysis(){
 	// this is where we apply the matched filter
 	// we only do this over a limited range
+#if (USE_FFT_CORRELATOR && !USE_FIXED_POINT)
+#if (USE_FUSED_DOWNMIX)
+	fastQuarterWaveCorrelation(node->recbuf, 2*N+2*M, node->corr_c, node->corr_s, 2*M);
+#else
+	fastQuadratureCorrelation(node->downMixedCosine, node->downMixedSine, 2*N+2*M, node->corr_c, node->corr_s, 2*M);
+#endif
+	for (i=0;i<=(2*M-1);i++)
+		node->s[i] = node->corr_c[i]*node->corr_c[i]+node->corr_s[i]*node->corr_s[i];  // noncoherent correlation metric
+#elif (USE_HIERARCHICAL_LAG_SEARCH)
+	// coarse pass over every LAG_SEARCH_STEP-th lag, lags that are never evaluated stay at zero for the peak search
 	for (i=0;i<=(2*M-1);i++) {
-		corr_c[i] = 0;
-		corr_s[i] = 0;
-		for (j=0;j<(2*N+1);j++) {
-			corr_c[i] += basebandSincRef[j]*downMixedCosine[j+i];
-			corr_s[i] += basebandSincRef[j]*downMixedSine[j+i];
-		}
-		s[i] = corr_c[i]*corr_c[i]+corr_s[i]*corr_s[i];  // noncoherent correlation metric
+		node->corr_c[i] = 0;
+		node->corr_s[i] = 0;
+		node->s[i] = 0;
 	}
+	k = 0;
+	for (i=0;i<=(2*M-1);i+=LAG_SEARCH_STEP) {
+		correlateReceivedLag(node, i);
+		if (node->s[i]>node->s[k])
+			k = i;
+	}
+	// the sinc main lobe is far wider than the step, so the peak is within one step of the best coarse lag.
+	// The refined window includes the coarse lags on either side, so the interpolation always has both neighbours.
+	for (i=k-LAG_SEARCH_STEP+1;i<k+LAG_SEARCH_STEP;i++) {
+		if ((i>=0)&&(i<=(2*M-1))&&(i!=k))
+			correlateReceivedLag(node, i);
+	}
+#else
+	for (i=0;i<=(2*M-1);i++)
+		correlateReceivedLag(node, i);
+#endif
+}
+
+/**
+ * Runs the matched filter at a single lag and fills corr_c, corr_s and s for that lag
+ * @param lag	lag into recbuf (0 to 2M-1)
+ */
+void correlateReceivedLag(NodeContext* node, short lag){
+#if (USE_FIXED_POINT)
+	fusedQuarterWaveCorrelationLagQ14(node->recbuf, basebandSincRef, 2*N+1, lag, &node->corr_c[lag], &node->corr_s[lag]);
+#elif (USE_FUSED_DOWNMIX)
+	fusedQuarterWaveCorrelationLag(node->recbuf, basebandSincRef, 2*N+1, lag, &node->corr_c[lag], &node->corr_s[lag]);
+#else
+	short tap;
+	node->corr_c[lag] = 0;
+	node->corr_s[lag] = 0;
+	for (tap=0;tap<(2*N+1);tap++) {
+		node->corr_c[lag] += basebandSincRef[tap]*node->downMixedCosine[tap+lag];
+		node->corr_s[lag] += basebandSincRef[tap]*node->downMixedSine[tap+lag];
+	}
+#endif
+	// noncoherent correlation metric
+	node->s[lag] = (metric_t)node->corr_c[lag]*node->corr_c[lag]+(metric_t)node->corr_s[lag]*node->corr_s[lag];
+}
+
+void runReceviedSincPulseTimingAnalysis(NodeContext* node){
+	short i;		// locals, so the lag loops stay in registers
+
+	runReceivedMatchedFilter(node);
 
 	// now find the peak
-	corr_max = 0;
-	corr_max_lag = 0;
+	node->corr_max = 0;
+	node->corr_max_lag = 0;
 	for (i=0;i<=(2*M-1);i++) {
-		if (s[i]>corr_max){
-			corr_max = s[i];
-			corr_max_lag = i;
+		if (node->s[i]>node->corr_max){
+			node->corr_max = node->s[i];
+			node->corr_max_lag = i;
 		}
 	}
-	corr_max_c = corr_c[corr_max_lag];
-	corr_max_s = corr_s[corr_max_lag];
+	node->corr_max_c = node->corr_c[node->corr_max_lag];
+	node->corr_max_s = node->corr_s[node->corr_max_lag];
+
+	// sub-lag position of the magnitude peak, from a parabola through the metric at the best lag and its neighbours
+	node->corr_peak_offset = 0;
+	if ((node->corr_max_lag>0)&&(node->corr_max_lag<(2*M-1))) {
+		float sPrev = (float) node->s[node->corr_max_lag-1];
+		float sPeak = (float) node->s[node->corr_max_lag];
+		float sNext = (float) node->s[node->corr_max_lag+1];
+		float curvature = sPrev - 2*sPeak + sNext;
+		if (curvature<0)
+			node->corr_peak_offset = 0.5f*(sPrev - sNext)/curvature;
+	}
 
 	//printf wrecks the real-time operation
 	//printf("Max lag: %d\n",corr_max_lag);
 	//printf("Coarse delay estimate: %d.\n",recbuf_start_clock+corr_max_lag);
 
-	// store coarse delay estimates
-	coarse_delay_estimate[cde_index] = CLOCK_WRAP(recbuf_start_clock+corr_max_lag);
+	// store coarse delay estimates, the rings keep the history for the debugger
+	node->cde_index++;
+	if(node->cde_index>=MAX_STORED_DELAYS_COARSE) node->cde_index = 0;
+	node->fde_index++;
+	if(node->fde_index>=MAX_STORED_DELAYS_FINE) node->fde_index = 0;
+	node->coarse_delay_estimate[node->cde_index] = CLOCK_WRAP(node->recbuf_start_clock+node->corr_max_lag);
 
 	// fine delay estimate
-	y = (double) corr_max_s;
-	x = (double) corr_max_c;
-	phase_correction_factor = atan2(y,x)*2*INVPI; // phase
-	if(phase_correction_factor != phase_correction_factor)// if NaN
-		phase_correction_factor=0;
-	if(phase_correction_factor == 0)
-		phase_correction_factor=0;
-	r = (recbuf_start_clock+corr_max_lag) & 3; // compute remainder
+#if (USE_FAST_ATAN2)
+	node->phase_correction_factor = carrierPhaseToSampleOffset((float) node->corr_max_s, (float) node->corr_max_c);
+#else
+	double y = (double) node->corr_max_s;
+	double x = (double) node->corr_max_c;
+	node->phase_correction_factor = atan2(y,x)*2*INVPI; // phase
+#endif
+	if(node->phase_correction_factor != node->phase_correction_factor)// if NaN
+		node->phase_correction_factor=0;
+	if(node->phase_correction_factor == 0)
+		node->phase_correction_factor=0;
 	float fine = 0;
+#if (USE_NCO_DOWNMIX)
+	// phase_correction_factor is the carrier phase in quarter cycles, so it places the pulse centre modulo a carrier
+	// period. The interpolated magnitude peak picks the period.
+	{
+		float period = ncoCarrierPeriod(&node->receiveNco);
+		float centre = ncoNearestCentre((float) node->phase_correction_factor*0.25f*period,
+				node->corr_max_lag + N + node->corr_peak_offset, period);
+		fine = centre - N - node->corr_max_lag;
+		node->fine_delay_estimate[node->fde_index] = node->recbuf_start_clock+node->corr_max_lag+fine;
+	}
+#else
+	char r = (node->recbuf_start_clock+node->corr_max_lag) & 3; // compute remainder
 	if (r==0){
-		fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor;
-		fine = phase_correction_factor;
+		node->fine_delay_estimate[node->fde_index] =
+				node->recbuf_start_clock+node->corr_max_lag+node->phase_correction_factor;
+		fine = node->phase_correction_factor;
 	}
 	else if (r==1){
-		fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor-1;
-		fine = phase_correction_factor-1;
+		node->fine_delay_estimate[node->fde_index] =
+				node->recbuf_start_clock+node->corr_max_lag+node->phase_correction_factor-1;
+		fine = node->phase_correction_factor-1;
 	}
 	else if (r==2) {
-		if (phase_correction_factor>0){
-			fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor-2;
-			fine = phase_correction_factor-2;
+		if (node->phase_correction_factor>0){
+			node->fine_delay_estimate[node->fde_index] =
+					node->recbuf_start_clock+node->corr_max_lag+node->phase_correction_factor-2;
+			fine = node->phase_correction_factor-2;
 		}
 		else{
-			fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor+2;
-			fine = phase_correction_factor+2;
+			node->fine_delay_estimate[node->fde_index] =
+					node->recbuf_start_clock+node->corr_max_lag+node->phase_correction_factor+2;
+			fine = node->phase_correction_factor+2;
 		}
 	}
 	else if (r==3){
-		fine_delay_estimate[fde_index] = recbuf_start_clock+corr_max_lag+phase_correction_factor+1;
-		fine = phase_correction_factor+1;
+		node->fine_delay_estimate[node->fde_index] =
+				node->recbuf_start_clock+node->corr_max_lag+node->phase_correction_factor+1;
+		fine = node->phase_correction_factor+1;
 	}
 	else
 		printf("ERROR");
+	// the table takes the carrier period from the integer lag, which the flat top of the metric can put a lag off and
+	// so a period off: like the NCO path, keep the period within half a period of the interpolated magnitude peak
+	if (fine - node->corr_peak_offset > 2 || fine - node->corr_peak_offset < -2) {
+		fine -= 4*(float)floor((fine - node->corr_peak_offset + 2)*0.25f);
+		node->fine_delay_estimate[node->fde_index] = node->recbuf_start_clock+node->corr_max_lag+fine;
+	}
+#endif
+
+	// cross check: the carrier phase refinement should land within a fraction of a sample of the magnitude peak
+	node->fine_peak_disagreement = fine - node->corr_peak_offset;
 
 	//fine_delay_estimate[fde_index] -= recbuf_start_clock+corr_max_lag;	// we just want the fractional part
 
@@ -1218,83 +2296,354 @@ void runReceviedSincPulseTimingAnalysis(){
 	// --- Calculations Finished ---
 }
 
-void runReceivedPulseBufferDownmixing(){
-	// downmix (had problems using sin/cos here so used a trick)
-	// The trick is based on the incoming frequency per sample being (n * pi/2), so every other sample goes to zero.
-	for (i=0;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = recbuf[i];
-		downMixedSine[i] = 0;
-	}
-	for (i=1;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = 0;
-		downMixedSine[i] = recbuf[i];
-	}
-	for (i=2;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = -recbuf[i];
-		downMixedSine[i] = 0;
+/**
+ * SNR of the capture in recbuf after runReceviedSincPulseTimingAnalysis(): the energy the pulse at the correlation
+ * peak explains over the noise energy per sample that is left. With the carrier well away from 0 and fs/2 the pulse
+ * explains 2|corr|^2/basebandSincEnergy.
+ */
+float estimateCaptureSnr(NodeContext* node){
+	float total = 0;
+	float pulse, noise;
+	short tap;
+
+	for (tap=0;tap<(2*N+2*M);tap++)
+		total += (float) node->recbuf[tap]*node->recbuf[tap];
+	pulse = 2.0f*((float) node->corr_max_c*node->corr_max_c + (float) node->corr_max_s*node->corr_max_s)
+			/basebandSincEnergy;
+	noise = (total - pulse)/(2*N+2*M-2);	// the fitted amplitude and phase take two degrees of freedom
+	if(noise <= 0)
+		return 1e6f;
+	return pulse/noise;
+}
+
+#if (USE_CLOCK_TRACKER)
+/**
+ * Feeds the newest fine delay estimate to the clock tracker, then hands the whole samples of the filtered offset and
+ * the filtered skew to the frame code
+ * @param launch	sinc_launch when the capture started, the fine estimate counts from that tick
+ * @param clock		vclock_counter when the capture completed
+ * @param ticks		clock wraps since the previous capture
+ */
+void runSlaveClockTracking(NodeContext* node, short launch, short clock, unsigned short ticks){
+	float fine = node->fine_delay_estimate[node->fde_index];
+	float measured;
+	short correction;
+#if (!USE_TDMA)
+	float horizon;
+#endif
+
+	// half the round trip, like sinc_roundtrip_time>>1 but with the fraction, as the error of the next tick
+	measured = 0.5f*(launch*VCLK_MAX + fine - (VCLK_MAX>>1));
+	while(measured >= (VCLK_MAX>>1))
+		measured -= VCLK_MAX;
+	while(measured < -(VCLK_MAX>>1))
+		measured += VCLK_MAX;
+
+	clockTrackerUpdate(&slave_clock, measured, ticks + (float)(clock - last_capture_clock)/VCLK_MAX,
+			node->fine_delay_snr[node->fde_index]);
+	last_capture_clock = clock;
+
+	// whole samples are stepped out, the fraction stays with the tracker until it adds up. A small step goes in at
+	// the start of the next tick, only a large one (acquisition) cuts the current tick short at vclock_offset.
+	correction = (short) floor(slave_clock.offset + 0.5f);
+	if(correction != 0 && !vclock_step_pending && !vclock_correction_pending){
+		if(correction >= -CLOCK_STEP_MAX && correction <= CLOCK_STEP_MAX){
+			vclock_step = correction;
+			vclock_step_pending = 1;
+		}
+		else {
+			vclock_offset = CLOCK_WRAP(correction-1);
+			vclock_correction_pending = 1;
+		}
+		clockTrackerCorrect(&slave_clock, correction);
 	}
-	for (i=3;i<(2*N+2*M);i+=4){
-		downMixedCosine[i] = 0;
-		downMixedSine[i] = -recbuf[i];
+	vclock_skew_per_tick = (int)(slave_clock.skew*65536.0f);
+	clockTrackerApplySkew(&slave_clock, slave_clock.skew);
+
+#if (SLAVE_ROLE)
+	// this hop's share of the error against the root: what the tracker does not know about the offset, and the
+	// whole sample steps the clock is held with (1/12 sample^2)
+	hop_error_budget = (float) sqrt(slave_clock.p00 + 1.0f/12);
+	sync_error_budget = (float) sqrt(upstream_error_budget*upstream_error_budget + hop_error_budget*hop_error_budget);
+#endif
+
+#if (!USE_TDMA)	// the slot fixes the spacing
+	horizon = clockTrackerHorizon(&slave_clock);
+	if(horizon < SYNC_ACQUIRE_TICKS)
+		sync_exchange_ticks = SYNC_ACQUIRE_TICKS;
+	else if(horizon > SYNC_EXCHANGE_TICKS)
+		sync_exchange_ticks = SYNC_EXCHANGE_TICKS;
+	else
+		sync_exchange_ticks = (short) horizon;
+#endif
+}
+#endif
+
+#if (USE_TDMA && NODE_TYPE == MASTER_NODE)
+/**
+ * Superframe tick the pulse that just finished recording is centred on. The recording ends about N+M samples after
+ * the pulse centre, so the pulse is on the current tick or, from the second half of the tick on, the next one.
+ */
+short tdmaCaptureTickISR(){
+	short tick = tdma_tick;
+
+	if (vclock_counter - (N+M) >= (VCLK_MAX>>1)) {
+		tick++;
+		if (tick >= TDMA_SUPERFRAME_TICKS)
+			tick = 0;
 	}
+	return tick;
 }
 
-void gpioInit()
-{
-	//--------------NOTE------------------
-	//	FOR GPIOs TO WORK ON C6713 DSK SPECTRUM DIGITAL BOARD
-	//	SWITCH 4 OF THE DIPSWITCH SW3 (NOT SW1!!!) HAS TO BE ON-CLOSED
-	//--------------NOTE------------------
+/**
+ * Estimates where the pulse in recbuf arrived against its slot tick and adds it to the slot history. The arrival is
+ * the slave's offset plus the path delay, so its spread is how steadily the slave holds its slot.
+ * @param tick	superframe tick the frame code put the pulse on
+ */
+void runMasterSlotAnalysis(NodeContext* node, short tick){
+	short ticksFromSlot;
+	short slot = tdmaSlotOfTick(tick, &ticksFromSlot);
+	float centre, snr;
 
-	GPIO_Config MyConfig = {
+#if (USE_CYCLE_PROFILER)
+	profile_tick_t analysisStart = profilerTimerRead();
+#endif
+#if (!USE_FUSED_DOWNMIX)
+	runReceivedPulseBufferDownmixing(node);
+#endif
+	runReceviedSincPulseTimingAnalysis(node);
+	PROFILE_STOP(PROFILE_TIMING_ANALYSIS, analysisStart);
+
+	snr = estimateCaptureSnr(node);
+#if (USE_CFAR_THRESHOLD)
+	if(!cfarValidate(&search_cfar, snr)){
+		capture_rejected = 1;	// the frame code drops the reply, and the arrival would be noise
+		return;
+	}
+#endif
 
-	0x00000000, /* gpgc */
+	// the fine estimate is the start of the pulse on the clock of the recording start, take it to the nearest tick
+	centre = node->fine_delay_estimate[node->fde_index] + N;
+	centre -= VCLK_MAX*(float) floor(centre/VCLK_MAX + 0.5f);
+	tdmaRecordArrival(&tdma_slots[slot], tdma_superframe, centre + ticksFromSlot*VCLK_MAX, snr);
+}
+#endif
 
-	0x0000FFFF, /* gpen --*/
+#if (USE_CFAR_THRESHOLD && NODE_TYPE == MASTER_NODE && !USE_TDMA && !USE_FDM_BANK)
+/**
+ * Runs the matched filter over the mirror master's capture, which it would not need otherwise, so a false trigger
+ * is dropped before its reply goes out
+ */
+void runMasterCaptureValidation(NodeContext* node){
+#if (USE_CYCLE_PROFILER)
+	profile_tick_t analysisStart = profilerTimerRead();
+#endif
+#if (!USE_FUSED_DOWNMIX)
+	runReceivedPulseBufferDownmixing(node);
+#endif
+	runReceviedSincPulseTimingAnalysis(node);
+	PROFILE_STOP(PROFILE_TIMING_ANALYSIS, analysisStart);
 
-	0x00000000, /* gdir -*/
+	if(!cfarValidate(&search_cfar, estimateCaptureSnr(node)))
+		capture_rejected = 1;
+}
+#endif
 
-	0x00000000, /* gpval */
+#if (USE_FDM_BANK && NODE_TYPE == MASTER_NODE)
+/**
+ * The frame code of the master with the correlator bank. All channels search the sample, then each channel runs the
+ * single channel master's states on its own capture: a hit starts its capture from the samples in buf, a full
+ * capture waits for the tick like STATE_CALCULATION, and the reply goes out mirrored about the tick like
+ * STATE_TRANSMIT and STATE_SENDSINC. The replies of the channels add up on TRANSMIT_SINC.
+ */
+void runFdmBankISR(NodeContext* node){
+	capture_t sample = (capture_t) frameIn[RECEIVE_SINC];  // right channel
+#if (USE_CFAR_THRESHOLD)
+	unsigned int hits = fdmSearchSample(&fdm_bank, sample, search_cfar.threshold);
+#else
+	unsigned int hits = fdmSearchSample(&fdm_bank, sample, T1);
+#endif
+	FdmChannel* channel;
+	int reply = 0;
+	short ch, dst, src;
 
-	0x00000000, /* gphm all interrupts disabled for io pins */
+#if (USE_CFAR_THRESHOLD)
+	cfarUpdate(&search_cfar, fdmNoiseMetric(&fdm_bank));
+#endif
 
-	0x00000000, /* gplm all interrupts to cpu or edma disabled  */
+	node->buf[node->bufindex] = sample;
+	node->bufindex++;
+	if (node->bufindex>=CAPTURE_LEAD)
+		node->bufindex = 0;		// now the oldest sample
+
+	for (ch=0;ch<FDM_CHANNELS;ch++) {
+		channel = &fdm_channels[ch];
+		if (vclock_counter==0 && channel->state==STATE_CALCULATION)
+			channel->state = STATE_TRANSMIT;	// the tick, like the wrap does for the single channel
+
+		if (channel->state==STATE_SEARCHING) {
+			if (hits & (1u<<ch)) {
+				src = node->bufindex;
+				for (dst=0;dst<CAPTURE_LEAD;dst++) {
+					fdm_capture[ch][dst] = node->buf[src];
+					src++;
+					if (src>=CAPTURE_LEAD)
+						src = 0;
+				}
+				clearFdmChannelISR(ch);
+#if (USE_CFAR_THRESHOLD)
+				search_cfar.triggers++;
+#endif
+				channel->startClock = vclock_counter - CAPTURE_LEAD;	// like recbuf_start_clock
+				channel->index = CAPTURE_LEAD;
+				channel->reply = FDM_REPLY_PENDING;
+				channel->state = STATE_RECORDING;
+			}
+		}
+		else if (channel->state==STATE_RECORDING) {
+			fdm_capture[ch][channel->index] = sample;
+			channel->index++;
+			if (channel->index==(2*N+2*M)) {
+				channel->waitCount = 0;
+				channel->state = STATE_CALCULATION;
+				eventQueuePost(&node_events, EVENT_CAPTURE_READY, vclock_counter, ch);
+			}
+		}
+		else if (channel->state==STATE_CALCULATION) {
+			channel->waitCount++;
+		}
+		else if (channel->state==STATE_TRANSMIT) {
+			channel->waitCount--;
+			if (channel->waitCount<=0) {
+				if (channel->reply==FDM_REPLY_READY) {
+					channel->index = (2*N+2*M);
+					channel->state = STATE_SENDSINC;
+				}
+				else {
+					if (channel->reply==FDM_REPLY_PENDING)
+						channel->late++;	// the main loop did not get to it in time
+					clearFdmChannelISR(ch);
+					channel->state = STATE_SEARCHING;
+				}
+			}
+		}
+		else if (channel->state==STATE_SENDSINC) {
+			channel->index--;
+			if (channel->index>=0) {
+				reply += fdm_reply[ch][channel->index];
+			}
+			else {
+				eventQueuePost(&node_events, EVENT_TRANSMIT_DONE, vclock_counter, ch);
+				clearFdmChannelISR(ch);	// it heard its own reply meanwhile
+				channel->state = STATE_SEARCHING;
+			}
+		}
+	}
+	frameOut[TRANSMIT_SINC] = (short) reply;	// at most FDM_CHANNELS*FDM_PULSE_PEAK
+}
 
-	0x00000000  /* gppol -- default state */
+/**
+ * Clears a channel's search window, the noise floor then waits until the window is full again
+ */
+void clearFdmChannelISR(short ch){
+	fdmSearchClearChannel(&fdm_bank, ch);
+#if (USE_CFAR_THRESHOLD)
+	cfarRestart(&search_cfar);
+#endif
+}
 
-	};
+/**
+ * Estimates the pulse in a channel's capture and puts its reply in place. The capture holds the pulses of all
+ * channels, so it cannot be played back like recbuf. The reply is the pulse the estimate says arrived, synthesised
+ * on the channel's carrier at FDM_PULSE_PEAK, so playing it backwards mirrors it the same way.
+ * @param ch	channel with a new capture
+ */
+void runMasterChannelAnalysis(NodeContext* node, short ch){
+	FdmChannel* channel = &fdm_channels[ch];
+	PulseSynth replySynth;
+	float centre, amplitude, snr;
+	short tap, start;
 
-	hGpio  = GPIO_open( GPIO_DEV0, GPIO_OPEN_RESET );
+	if (channel->state!=STATE_CALCULATION && channel->state!=STATE_TRANSMIT)
+		return;		// too late, the capture has been given up and may be recording again
 
-	GPIO_config(hGpio  , &MyConfig );
+#if (USE_CYCLE_PROFILER)
+	profile_tick_t analysisStart = profilerTimerRead();
+#endif
+	// the analysis works on recbuf and receiveNco
+	for (tap=0;tap<(2*N+2*M);tap++)
+		node->recbuf[tap] = fdm_capture[ch][tap];
+	node->recbuf_start_clock = channel->startClock;
+	ncoInit(&node->receiveNco, fdmChannelCarrier(CBW, ch));
+	runReceivedPulseBufferDownmixing(node);
+	runReceviedSincPulseTimingAnalysis(node);
+	PROFILE_STOP(PROFILE_TIMING_ANALYSIS, analysisStart);
+
+	snr = estimateCaptureSnr(node);
+#if (USE_CFAR_THRESHOLD)
+	if (!cfarValidate(&search_cfar, snr)) {
+		channel->silent++;
+		channel->reply = FDM_REPLY_SILENT;	// a false trigger, neither an arrival nor a reply
+		return;
+	}
+#endif
 
-	/* Enables pins */
-	GPIO_pinEnable (hGpio,GPIO_PIN0| GPIO_PIN1 | GPIO_PIN2 | GPIO_PIN3 | GPIO_PIN4 | GPIO_PIN5);//enable here or in MyConfig
+	// the fine estimate is the start of the pulse on the clock of the capture start, take it to the nearest tick
+	centre = node->fine_delay_estimate[node->fde_index] + N;
+	fdmRecordArrival(channel, centre - VCLK_MAX*(float) floor(centre/VCLK_MAX + 0.5f), snr);
 
-	/* Sets Pin0, Pin1, and Pin2 as an output pins. */
-	int Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN0, GPIO_OUTPUT);
-	Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN1, GPIO_OUTPUT);
-	Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN2, GPIO_OUTPUT);
-	Current_dir = GPIO_pinDirection(hGpio,GPIO_PIN3, GPIO_OUTPUT);
+	// the pulse explains 2|corr|/basebandSincEnergy of amplitude, the floor is max_recbuf's 2048 scaled to the pulse
+	amplitude = 2.0f*(float) sqrt((float) node->corr_max)/basebandSincEnergy;
+	if (amplitude<(FDM_PULSE_PEAK>>4)) {
+		channel->silent++;
+		channel->reply = FDM_REPLY_SILENT;
+		return;
+	}
 
+	centre -= node->recbuf_start_clock;		// in the capture
+	start = (short) floor(centre) - N;
+	startDelayedPulse(&replySynth, N, BW, fdmChannelCarrier(CBW, ch), centre - (float) floor(centre));
+	for (tap=0;tap<(2*N+2*M);tap++)
+		fdm_reply[ch][tap] = 0;
+	for (tap=start;tap<=start+2*N;tap++) {
+		if (tap>=0 && tap<(2*N+2*M))
+			fdm_reply[ch][tap] = nextDelayedPulseSample(&replySynth)/(32767/FDM_PULSE_PEAK);
+		else
+			nextDelayedPulseSample(&replySynth);
+	}
+	channel->reply = FDM_REPLY_READY;	// after the samples, the frame code may be waiting for it
 }
+#endif
 
-void gpioToggle()
-{
-	while(1)
-	{
-		GPIO_pinWrite( hGpio, GPIO_PIN0, 0 );
-		GPIO_pinWrite( hGpio, GPIO_PIN1, 0 );
-		*((int*)GPIO_VALUE_ADDRESS) = 255;
-		DSK6713_waitusec(500000);
-		GPIO_pinWrite( hGpio, GPIO_PIN0, 1 );
-		GPIO_pinWrite( hGpio, GPIO_PIN1, 1 );
-		*((int*)GPIO_VALUE_ADDRESS) = 0;
-		DSK6713_waitusec(500000);
-
+#if (!USE_FUSED_DOWNMIX)
+void runReceivedPulseBufferDownmixing(NodeContext* node){
+#if (USE_NCO_DOWNMIX)
+	// recbuf[0] is carrier phase 0, runReceviedSincPulseTimingAnalysis() counts the pulse centre from there
+	ncoDownmix(&node->receiveNco, node->recbuf, node->downMixedCosine, node->downMixedSine, 2*N+2*M);
+#else
+	short i;
 
+	// downmix (had problems using sin/cos here so used a trick)
+	// The trick is based on the incoming frequency per sample being (n * pi/2), so every other sample goes to zero.
+	for (i=0;i<(2*N+2*M);i+=4){
+		node->downMixedCosine[i] = node->recbuf[i];
+		node->downMixedSine[i] = 0;
+	}
+	for (i=1;i<(2*N+2*M);i+=4){
+		node->downMixedCosine[i] = 0;
+		node->downMixedSine[i] = node->recbuf[i];
+	}
+	for (i=2;i<(2*N+2*M);i+=4){
+		node->downMixedCosine[i] = -node->recbuf[i];
+		node->downMixedSine[i] = 0;
+	}
+	for (i=3;i<(2*N+2*M);i+=4){
+		node->downMixedCosine[i] = 0;
+		node->downMixedSine[i] = -node->recbuf[i];
 	}
+#endif
 }
+#endif
 
 /*
 float sumFloatArray(float* array, short numElmts){
@@ -1325,26 +2674,3 @@ void runSlaveSincPulseTimingUpdateCalcs(){
 short isSincInSameWindowHuh(short curClock, short delayEstimate){
 	return curClock > delayEstimate; //If its not greater, then it has already wrapped around the 0 tick, and we are currently in the next window.
 }
-
-
-void ToggleDebugGPIO(short IONum){
-	if (IONum == 0){
-		GPIO_pinWrite(hGpio,GPIO_PIN0,1);
-		GPIO_pinWrite(hGpio,GPIO_PIN0,0);
-	}
-	else if(IONum == 1){
-		GPIO_pinWrite(hGpio,GPIO_PIN1, 1);
-		GPIO_pinWrite(hGpio,GPIO_PIN1, 0);
-	}
-	else if(IONum == 2){
-		GPIO_pinWrite(hGpio,GPIO_PIN2, 1);
-		GPIO_pinWrite(hGpio,GPIO_PIN2, 0);
-	}
-	else if(IONum == 3){
-		GPIO_pinWrite(hGpio,GPIO_PIN3, 1);
-		GPIO_pinWrite(hGpio,GPIO_PIN3, 0);
-	}
-	else{
-		//error
-	}
-}
\ No newline at end of file
@@ -5,6 +5,7 @@
 
     .ref    _c_int00
     .ref    _serialPortRcvISR ; refer the address of ISR defined in C program
+    .ref    _edmaBlockISR ; EDMA ping-pong block ISR (SampleIODsk.c)
 
     .sect   "vectors"
 
@@ -84,9 +85,10 @@ INT7:   NOP
 	NOP
 	NOP
 
-INT8:   NOP
-	NOP
-	NOP
+INT8:
+	MVKL .S2 _edmaBlockISR, B0
+    MVKH .S2 _edmaBlockISR, B0
+    B    .S2 B0
 	NOP
 	NOP
 	NOP